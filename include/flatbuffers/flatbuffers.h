@@ -29,6 +29,7 @@
 #include <vector>
 #include <set>
 #include <algorithm>
+#include <limits>
 #include <memory>
 
 #ifdef _STLPORT_VERSION
@@ -38,6 +39,21 @@
   #include <functional>
 #endif
 
+// Whether <atomic>, <mutex> and <thread> are available (they aren't on
+// STLport, or before Visual Studio 2012). Define as 0 to build without them:
+// the Verifier then ignores SetParallelFor() and verifies serially.
+#ifndef FLATBUFFERS_HAS_THREADS
+  #if !defined(FLATBUFFERS_CPP98_STL) && \
+      (!defined(_MSC_VER) || _MSC_VER >= 1700)
+    #define FLATBUFFERS_HAS_THREADS 1
+  #else
+    #define FLATBUFFERS_HAS_THREADS 0
+  #endif
+#endif
+#if FLATBUFFERS_HAS_THREADS
+  #include <atomic>
+#endif
+
 /// @cond FLATBUFFERS_INTERNAL
 #if __cplusplus <= 199711L && \
     (!defined(_MSC_VER) || _MSC_VER < 1600) && \
@@ -107,6 +123,31 @@
   #define FLATBUFFERS_CONSTEXPR
 #endif
 
+#if defined(__clang__)
+  #if defined(__has_feature)
+    #if __has_feature(cxx_thread_local)
+      #define FLATBUFFERS_THREAD_LOCAL thread_local
+    #endif
+  #endif
+#elif (!defined(_MSC_VER) || _MSC_VER >= 1900) && \
+      (!defined(__GNUC__) || (__GNUC__ * 100 + __GNUC_MINOR__ >= 408))
+  #define FLATBUFFERS_THREAD_LOCAL thread_local
+#endif
+
+// SIMD is used to speed up some verifier and parser loops where available,
+// define FLATBUFFERS_NO_SIMD to turn this off.
+#if !defined(FLATBUFFERS_NO_SIMD) && FLATBUFFERS_LITTLEENDIAN
+  #if defined(__AVX2__)
+    #include <immintrin.h>
+    #define FLATBUFFERS_AVX2
+  #endif
+  #if defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define FLATBUFFERS_SSE2
+  #endif
+#endif
+
 /// @endcond
 
 /// @file
@@ -338,6 +379,42 @@ private:
   const uint8_t *data_;
 };
 
+// Hash of the key of a table, as stored in the index built by
+// FlatBufferBuilder::CreateKeyHashIndex(). Since it is stored in buffers, it
+// must be the same on all platforms: this is 32 bit FNV-1a over the bytes of
+// a string key, or the little endian bytes of a scalar key.
+inline uint32_t HashKeyBytes(const uint8_t *bytes, size_t len) {
+  uint32_t hash = 0x811C9DC5;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= bytes[i];
+    hash *= 0x01000193;
+  }
+  return hash;
+}
+
+inline uint32_t HashKey(const char *key) {
+  return HashKeyBytes(reinterpret_cast<const uint8_t *>(key), strlen(key));
+}
+
+template<typename T> typename std::enable_if<std::is_scalar<T>::value &&
+                                             !std::is_pointer<T>::value &&
+                                             !std::is_floating_point<T>::value,
+                                             uint32_t>::type HashKey(T key) {
+  T le = EndianScalar(key);
+  return HashKeyBytes(reinterpret_cast<const uint8_t *>(&le), sizeof(T));
+}
+
+// Keys that compare equal must hash the same: -0.0 and 0.0 are one key, and
+// so are all NaNs (which compare equal to any key in KeyCompareWithValue(),
+// so only a NaN key is found by a NaN lookup through the index).
+template<typename T> typename std::enable_if<std::is_floating_point<T>::value,
+                                             uint32_t>::type HashKey(T key) {
+  if (key == 0) key = 0;
+  if (key != key) key = std::numeric_limits<T>::quiet_NaN();
+  T le = EndianScalar(key);
+  return HashKeyBytes(reinterpret_cast<const uint8_t *>(&le), sizeof(T));
+}
+
 // This is used as a helper type for accessing vectors.
 // Vector::data() assumes the vector elements start after the length field.
 template<typename T> class Vector {
@@ -415,17 +492,111 @@ public:
   const T *data() const { return reinterpret_cast<const T *>(Data()); }
   T *data() { return reinterpret_cast<T *>(Data()); }
 
+  // Binary search in a vector of tables sorted by their key field (see
+  // CreateVectorOfSortedTables()). Unlike std::bsearch, which this used to
+  // call, the key comparison can be inlined.
+  // This deliberately branches on the comparison: a branch-free search would
+  // serialize the (typically cache missing) reads of the tables and their
+  // keys, whereas with a branch the CPU can speculatively start on the next
+  // one.
   template<typename K> return_type LookupByKey(K key) const {
-    void *search_result = std::bsearch(&key, Data(), size(),
-        IndirectHelper<T>::element_stride, KeyCompare<K>);
-
-    if (!search_result) {
-      return nullptr;  // Key not found.
+    uoffset_t lo = 0, hi = size();
+    while (lo < hi) {
+      auto mid = lo + (hi - lo) / 2;
+      auto table = IndirectHelper<T>::Read(Data(), mid);
+      auto cmp = table->KeyCompareWithValue(key);
+      if (cmp < 0) {
+        lo = mid + 1;
+      } else if (cmp > 0) {
+        hi = mid;
+      } else {
+        return table;
+      }
     }
+    return nullptr;  // Key not found.
+  }
+
+  // Same as LookupByKey(), using an index created with
+  // FlatBufferBuilder::CreateKeyHashIndex() for this vector, which typically
+  // finds the table with a single probe. Without an index (null or empty),
+  // falls back to LookupByKey().
+  template<typename K> return_type LookupByKeyHashed(
+                                     K key,
+                                     const Vector<uint32_t> *index) const {
+    if (!index || !index->size()) return LookupByKey(key);
+    // The index holds (hash, element + 1) pairs, 0 marking an empty slot.
+    typedef typename std::remove_const<
+      typename std::remove_pointer<return_type>::type>::type table_type;
+    auto mask = index->size() / 2 - 1;
+    auto hash = table_type::KeyHash(key);
+    auto slot = hash & mask;
+    for (uoffset_t probes = 0; probes <= mask; probes++) {
+      auto element = index->Get(slot * 2 + 1);
+      if (!element || element > size()) break;
+      if (index->Get(slot * 2) == hash) {
+        auto table = IndirectHelper<T>::Read(Data(), element - 1);
+        if (!table->KeyCompareWithValue(key)) return table;
+      }
+      slot = (slot + 1) & mask;
+    }
+    return nullptr;  // Key not found.
+  }
+
+  // Range queries on a vector of tables sorted by their key field, as
+  // std::lower_bound() etc.: the first element whose key is not less than /
+  // greater than key, or end().
+  template<typename K> const_iterator LowerBound(K key) const {
+    return const_iterator(Data(), KeyBound(key, 0, size(), false));
+  }
+
+  template<typename K> const_iterator UpperBound(K key) const {
+    return const_iterator(Data(), KeyBound(key, 0, size(), true));
+  }
+
+  // The range of all elements with this key.
+  template<typename K> std::pair<const_iterator, const_iterator> EqualRange(
+                                                                 K key) const {
+    auto lower = KeyBound(key, 0, size(), false);
+    auto upper = KeyBound(key, lower, size(), true);
+    return std::make_pair(const_iterator(Data(), lower),
+                          const_iterator(Data(), upper));
+  }
+
+  // Look up many keys at once, which must be sorted in the same order as
+  // the vector. Sets results[i] to the table with keys[i], or nullptr.
+  // Rather than searching the whole vector for each key, this moves forward
+  // through the vector in a single pass, galloping (doubling the step) to
+  // bracket the next key and then binary searching only that part. This is
+  // much more cache friendly than separate lookups for large batches.
+  template<typename K> void LookupByKeys(const K *keys, size_t count,
+                                         return_type *results) const {
+    auto n = size();
+    uoffset_t lo = 0;
+    for (size_t i = 0; i < count; i++) {
+      // All elements before lo have a key less than keys[i].
+      auto hi = lo;
+      uoffset_t step = 1;
+      while (hi < n &&
+             IndirectHelper<T>::Read(Data(), hi)->KeyCompareWithValue(
+                                                                keys[i]) < 0) {
+        lo = hi + 1;
+        hi = lo + step;
+        step *= 2;
+      }
+      lo = KeyBound(keys[i], lo, std::min(hi, n), false);
+      results[i] = nullptr;
+      if (lo < n) {
+        auto table = IndirectHelper<T>::Read(Data(), lo);
+        if (!table->KeyCompareWithValue(keys[i])) results[i] = table;
+      }
+    }
+  }
 
-    const uint8_t *element = reinterpret_cast<const uint8_t *>(search_result);
-
-    return IndirectHelper<T>::Read(element, 0);
+  template<typename K> std::vector<return_type> LookupByKeys(
+                                         const std::vector<K> &keys) const {
+    std::vector<return_type> results(keys.size());
+    if (!keys.empty()) LookupByKeys(&keys[0], keys.size(), &results[0]);
+    return results;
   }
 
 protected:
@@ -436,14 +607,20 @@ protected:
   uoffset_t length_;
 
 private:
-  template<typename K> static int KeyCompare(const void *ap, const void *bp) {
-    const K *key = reinterpret_cast<const K *>(ap);
-    const uint8_t *data = reinterpret_cast<const uint8_t *>(bp);
-    auto table = IndirectHelper<T>::Read(data, 0);
-
-    // std::bsearch compares with the operands transposed, so we negate the
-    // result here.
-    return -table->KeyCompareWithValue(*key);
+  // The first element in [lo, hi) whose key is not less than (or, if upper,
+  // greater than) key, or hi.
+  template<typename K> uoffset_t KeyBound(K key, uoffset_t lo, uoffset_t hi,
+                                          bool upper) const {
+    while (lo < hi) {
+      auto mid = lo + (hi - lo) / 2;
+      auto cmp = IndirectHelper<T>::Read(Data(), mid)->KeyCompareWithValue(key);
+      if (cmp < 0 || (upper && !cmp)) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
   }
 };
 
@@ -487,40 +664,175 @@ class simple_allocator {
   virtual ~simple_allocator() {}
   virtual uint8_t *allocate(size_t size) const { return new uint8_t[size]; }
   virtual void deallocate(uint8_t *p) const { delete[] p; }
+
+  // Grow a block of `old_size` bytes, of which the last `in_use_back` bytes
+  // are in use (buffers are filled from the end, see vector_downward), to
+  // at least `new_size` bytes, keeping those bytes at the end of the block.
+  // Override this if your allocator can do better than a new allocation and
+  // a copy, e.g. by reusing memory it already owns.
+  virtual uint8_t *reallocate_downward(uint8_t *old_p, size_t old_size,
+                                       size_t new_size,
+                                       size_t in_use_back) const {
+    assert(new_size > old_size && in_use_back <= old_size);
+    auto new_p = allocate(new_size);
+    memcpy(new_p + new_size - in_use_back, old_p + old_size - in_use_back,
+           in_use_back);
+    deallocate(old_p);
+    return new_p;
+  }
+
+  // The allocator used by builders that weren't given one. It is stateless,
+  // so it can be shared by all threads, and since it is never destroyed,
+  // buffers released from a builder may outlive it.
+  static const simple_allocator &default_instance() {
+    static simple_allocator instance;
+    return instance;
+  }
+};
+
+// An allocator that recycles the memory it hands out: deallocated blocks are
+// kept on a free list (up to `max_pooled_bytes` in total), and handed out
+// again by allocate() and reallocate_downward(). This means a builder that is
+// reused with Clear(), or builders whose buffers are released with
+// ReleaseBufferPointer() and then freed, stop calling malloc altogether once
+// they've reached their steady state size.
+// This class is not thread-safe, use a separate instance per thread, e.g.
+// thread_local_instance(). Buffers released from a builder using it must be
+// freed while that instance is still alive.
+class pooled_allocator : public simple_allocator {
+ public:
+  explicit pooled_allocator(size_t max_pooled_bytes = 16 * 1024 * 1024)
+    : max_pooled_bytes_(max_pooled_bytes), pooled_bytes_(0) {}
+
+  ~pooled_allocator() {
+    for (auto it = free_.begin(); it != free_.end(); ++it) delete[] *it;
+  }
+
+  uint8_t *allocate(size_t size) const {
+    // Find the smallest free block that fits.
+    auto best = free_.end();
+    for (auto it = free_.begin(); it != free_.end(); ++it) {
+      if (capacity(*it) >= size &&
+          (best == free_.end() || capacity(*it) < capacity(*best))) best = it;
+    }
+    uint8_t *block;
+    if (best != free_.end()) {
+      block = *best;
+      pooled_bytes_ -= capacity(block);
+      *best = free_.back();
+      free_.pop_back();
+    } else {
+      block = new uint8_t[kHeaderSize + size];
+      *reinterpret_cast<size_t *>(block) = size;
+    }
+    return block + kHeaderSize;
+  }
+
+  void deallocate(uint8_t *p) const {
+    auto block = p - kHeaderSize;
+    if (pooled_bytes_ + capacity(block) > max_pooled_bytes_) {
+      delete[] block;
+      return;
+    }
+    pooled_bytes_ += capacity(block);
+    free_.push_back(block);
+  }
+
+  uint8_t *reallocate_downward(uint8_t *old_p, size_t old_size,
+                               size_t new_size, size_t in_use_back) const {
+    // We may have handed out a larger block than was asked for.
+    if (capacity(old_p - kHeaderSize) >= new_size) {
+      memmove(old_p + new_size - in_use_back, old_p + old_size - in_use_back,
+              in_use_back);
+      return old_p;
+    }
+    return simple_allocator::reallocate_downward(old_p, old_size, new_size,
+                                                 in_use_back);
+  }
+
+  // Number of blocks / bytes currently on the free list.
+  size_t pooled_blocks() const { return free_.size(); }
+  size_t pooled_bytes() const { return pooled_bytes_; }
+
+  #ifdef FLATBUFFERS_THREAD_LOCAL
+  // A pool private to the calling thread, for use by any builder on it.
+  static pooled_allocator &thread_local_instance() {
+    static FLATBUFFERS_THREAD_LOCAL pooled_allocator instance;
+    return instance;
+  }
+  #endif
+
+ private:
+  // Each block starts with its capacity, padded such that the memory we hand
+  // out stays aligned as much as the block returned by new[].
+  static const size_t kHeaderSize = FLATBUFFERS_MAX_ALIGNMENT;
+
+  static size_t capacity(const uint8_t *block) {
+    return *reinterpret_cast<const size_t *>(block);
+  }
+
+  // Allocation doesn't change the logical state of an allocator.
+  mutable std::vector<uint8_t *> free_;
+  size_t max_pooled_bytes_;
+  mutable size_t pooled_bytes_;
+};
+
+// A contiguous range of memory making up (part of) a serialized buffer, see
+// FlatBufferBuilder::GetBufferSegments().
+struct BufferSegment {
+  const uint8_t *data;
+  size_t size;
 };
 
 // This is a minimal replication of std::vector<uint8_t> functionality,
 // except growing from higher to lower addresses. i.e push_back() inserts data
 // in the lowest address in the vector.
+// In segmented mode, the data isn't kept in a single contiguous block: when
+// out of space, a new block (segment) is started instead of copying all data
+// so far into a bigger block. All offsets are relative to the end of the
+// (virtual) buffer, so they stay valid, but objects must not straddle two
+// segments, so callers mark() where each object starts, and any bytes from
+// there on are moved along to the new segment.
 class vector_downward {
  public:
   explicit vector_downward(size_t initial_size,
                            const simple_allocator &allocator)
-    : reserved_(initial_size),
+    // Like growing (see reallocate()), keep the end of the buffer aligned to
+    // the largest alignment any object can have.
+    : reserved_((initial_size + (FLATBUFFERS_MAX_ALIGNMENT - 1)) &
+                ~static_cast<size_t>(FLATBUFFERS_MAX_ALIGNMENT - 1)),
       buf_(allocator.allocate(reserved_)),
       cur_(buf_ + reserved_),
-      allocator_(allocator) {
-    assert((initial_size & (sizeof(largest_scalar_t) - 1)) == 0);
-  }
+      end_(cur_),
+      base_(0),
+      mark_(0),
+      segmented_(false),
+      allocator_(allocator) {}
 
   ~vector_downward() {
+    clear_segments();
     if (buf_)
       allocator_.deallocate(buf_);
   }
 
   void clear() {
+    clear_segments();
     if (buf_ == nullptr)
       buf_ = allocator_.allocate(reserved_);
 
-    cur_ = buf_ + reserved_;
+    cur_ = end_ = buf_ + reserved_;
+    base_ = mark_ = 0;
   }
 
   #ifndef FLATBUFFERS_CPP98_STL
   // Relinquish the pointer to the caller.
   unique_ptr_t release() {
+    // Only a single segment can be handed out this way.
+    assert(contiguous());
+
     // Actually deallocate from the start of the allocated memory.
     std::function<void(uint8_t *)> deleter(
-      std::bind(&simple_allocator::deallocate, allocator_, buf_));
+      std::bind(&simple_allocator::deallocate, &allocator_, buf_));
 
     // Point to the desired offset.
     unique_ptr_t retval(data(), deleter);
@@ -538,9 +850,7 @@ class vector_downward {
   }
 
   uint8_t *make_space(size_t len) {
-    if (len > static_cast<size_t>(cur_ - buf_)) {
-      reallocate(len);
-    }
+    ensure_space(len);
     cur_ -= len;
     // Beyond this, signed offsets may not have enough range:
     // (FlatBuffers > 2GB not supported).
@@ -548,9 +858,18 @@ class vector_downward {
     return cur_;
   }
 
+  // Make sure the next `len` bytes can be written without growing (or, in
+  // segmented mode, without starting a new segment).
+  void ensure_space(size_t len) {
+    if (len > static_cast<size_t>(cur_ - buf_)) {
+      if (segmented_) add_segment(len);
+      else reallocate(len);
+    }
+  }
+
   uoffset_t size() const {
     assert(cur_ != nullptr && buf_ != nullptr);
-    return static_cast<uoffset_t>(reserved_ - (cur_ - buf_));
+    return static_cast<uoffset_t>(base_ + (end_ - cur_));
   }
 
   uint8_t *data() const {
@@ -558,7 +877,17 @@ class vector_downward {
     return cur_;
   }
 
-  uint8_t *data_at(size_t offset) const { return buf_ + reserved_ - offset; }
+  uint8_t *data_at(size_t offset) const {
+    if (offset > base_ || segments_.empty()) return end_ - (offset - base_);
+    // Find the last segment starting below offset.
+    size_t lo = 0, hi = segments_.size();
+    while (hi - lo > 1) {
+      auto mid = (lo + hi) / 2;
+      if (segments_[mid].base < offset) lo = mid; else hi = mid;
+    }
+    auto &seg = segments_[lo];
+    return seg.end - (offset - seg.base);
+  }
 
   void push(const uint8_t *bytes, size_t num) {
     auto dest = make_space(num);
@@ -584,30 +913,109 @@ class vector_downward {
     memset(dest, 0, zero_pad_bytes);
   }
 
-  void pop(size_t bytes_to_remove) { cur_ += bytes_to_remove; }
+  void pop(size_t bytes_to_remove) {
+    cur_ += bytes_to_remove;
+    // Can only remove data from the current segment.
+    assert(cur_ <= end_);
+  }
+
+  // Switch segmented mode on or off, only while empty.
+  void set_segmented(bool segmented) {
+    assert(size() == 0);
+    segmented_ = segmented;
+  }
+
+  // Called at the start of each object: bytes from here on will not be split
+  // over two segments.
+  void mark() { mark_ = size(); }
+
+  bool segmented() const { return segmented_; }
+
+  // Offsets above this are in the current segment.
+  size_t segment_base() const { return base_; }
+
+  bool contiguous() const { return segments_.empty(); }
+
+  // All data, from the lowest address / highest offset to the end.
+  std::vector<BufferSegment> segments() const {
+    std::vector<BufferSegment> result;
+    BufferSegment current = { data(), static_cast<size_t>(end_ - cur_) };
+    result.push_back(current);
+    for (auto it = segments_.rbegin(); it != segments_.rend(); ++it) {
+      BufferSegment seg = { it->end - it->size, it->size };
+      result.push_back(seg);
+    }
+    return result;
+  }
 
  private:
   // You shouldn't really be copying instances of this class.
   vector_downward(const vector_downward &);
   vector_downward &operator=(const vector_downward &);
 
+  // A previous, now read-only, segment holding offsets (base, base + size].
+  struct segment {
+    uint8_t *block;
+    uint8_t *end;
+    size_t base;
+    size_t size;
+  };
+
   size_t reserved_;
   uint8_t *buf_;
   uint8_t *cur_;  // Points at location between empty (below) and used (above).
+  uint8_t *end_;  // End of the data in the current segment.
+  size_t base_;   // Offset corresponding to end_.
+  size_t mark_;   // Offset at which the object currently being built starts.
+  bool segmented_;
+  std::vector<segment> segments_;
   const simple_allocator &allocator_;
 
   void reallocate(size_t len) {
     auto old_size = size();
-    auto largest_align = AlignOf<largest_scalar_t>();
-    reserved_ += (std::max)(len, growth_policy(reserved_));
-    // Round up to avoid undefined behavior from unaligned loads and stores.
-    reserved_ = (reserved_ + (largest_align - 1)) & ~(largest_align - 1);
-    auto new_buf = allocator_.allocate(reserved_);
-    auto new_cur = new_buf + reserved_ - old_size;
-    memcpy(new_cur, cur_, old_size);
-    cur_ = new_cur;
-    allocator_.deallocate(buf_);
+    auto old_reserved = reserved_;
+    // Grow by a multiple of the largest alignment any object can have, so the
+    // end of the buffer (and thus everything in it) stays aligned. Anything
+    // else causes undefined behavior from unaligned loads and stores.
+    size_t max_align = FLATBUFFERS_MAX_ALIGNMENT;
+    reserved_ += ((std::max)(len, growth_policy(reserved_)) + (max_align - 1)) &
+                 ~(max_align - 1);
+    buf_ = allocator_.reallocate_downward(buf_, old_reserved, reserved_,
+                                          old_size);
+    cur_ = buf_ + reserved_ - old_size;
+    end_ = buf_ + reserved_;
+  }
+
+  void add_segment(size_t len) {
+    // The part of the current object already written moves along.
+    auto moving = size() - mark_;
+    size_t max_align = FLATBUFFERS_MAX_ALIGNMENT;
+    auto new_reserved = (std::max)(len + moving + max_align,
+                                   reserved_ + growth_policy(reserved_));
+    new_reserved = (new_reserved + (max_align - 1)) & ~(max_align - 1);
+    auto new_buf = allocator_.allocate(new_reserved);
+    // Place the data such that every address has the same alignment it would
+    // have in a contiguous buffer (where end_ is aligned and base_ is 0).
+    auto new_end = new_buf + new_reserved - (mark_ & (max_align - 1));
+    memcpy(new_end - moving, cur_, moving);
+    auto remaining = static_cast<size_t>(end_ - cur_) - moving;
+    if (remaining) {
+      segment seg = { buf_, end_, base_, remaining };
+      segments_.push_back(seg);
+    } else {
+      allocator_.deallocate(buf_);
+    }
+    reserved_ = new_reserved;
     buf_ = new_buf;
+    end_ = new_end;
+    cur_ = new_end - moving;
+    base_ = mark_;
+  }
+
+  void clear_segments() {
+    for (auto it = segments_.begin(); it != segments_.end(); ++it)
+      allocator_.deallocate(it->block);
+    segments_.clear();
   }
 };
 
@@ -632,6 +1040,157 @@ template <typename T> T* data(std::vector<T> &v) {
   return v.empty() ? nullptr : &v.front();
 }
 
+// Fast non-cryptographic hash (MurmurHash3, 32bit) of a range of bytes.
+// Only used to index data the builder has already written, the result is
+// never stored in a buffer, so it doesn't need to be endian-independent.
+inline uint32_t HashBytes(const uint8_t *bytes, size_t len) {
+  const uint32_t c1 = 0xcc9e2d51, c2 = 0x1b873593;
+  uint32_t h = static_cast<uint32_t>(len);
+  for (; len >= sizeof(uint32_t); len -= sizeof(uint32_t)) {
+    uint32_t k;
+    memcpy(&k, bytes, sizeof(uint32_t));
+    bytes += sizeof(uint32_t);
+    k *= c1; k = (k << 15) | (k >> 17); k *= c2;
+    h ^= k; h = (h << 13) | (h >> 19); h = h * 5 + 0xe6546b64;
+  }
+  uint32_t k = 0;
+  switch (len) {
+    case 3: k ^= static_cast<uint32_t>(bytes[2]) << 16;  // fall thru
+    case 2: k ^= static_cast<uint32_t>(bytes[1]) << 8;   // fall thru
+    case 1: k ^= bytes[0];
+            k *= c1; k = (k << 15) | (k >> 17); k *= c2; h ^= k;
+  }
+  h ^= h >> 16; h *= 0x85ebca6b;
+  h ^= h >> 13; h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h;
+}
+
+// A minimal open addressing hash set of offsets into a vector_downward, used
+// to find previously serialized data (e.g. vtables) in constant time.
+// Only the offsets themselves are stored: the data they refer to in the buffer
+// is the key, and the hash of an entry can always be recomputed from it, which
+// is what the caller supplied `rehash` functor does when growing.
+// A std::vector of the same offsets holds 4 to 8 bytes per entry, since its
+// capacity doubles. To stay below that, each slot is only as wide as the
+// largest offset needs (2 bytes up to 64KB, 3 up to 16MB), and slots are kept
+// up to 9/10 full, growing to a prime size 5/4 the number of entries. That is
+// 2.2 to 3.8 bytes per entry for buffers up to 16MB (and 4.4 to 5 beyond).
+// Double hashing keeps probe sequences short at that load.
+class offset_hash_set {
+ public:
+  offset_hash_set() : num_slots_(0), width_(2), count_(0) {}
+
+  void clear() {
+    if (count_) std::fill(slots_.begin(), slots_.end(), 0);
+    count_ = 0;
+  }
+
+  size_t size() const { return count_; }
+
+  // Returns the first entry with this hash for which `eq(entry)` is true, or
+  // 0 if there is none (an offset of 0 never refers to an object).
+  template<typename Eq> uoffset_t find(uint32_t hash, const Eq &eq) const {
+    if (!count_) return 0;
+    auto step = Step(hash);
+    for (auto i = Home(hash); ; i = Next(i, step)) {
+      auto off = Get(i);
+      if (!off) return 0;
+      if (eq(off)) return off;
+    }
+  }
+
+  template<typename H> void insert(uint32_t hash, uoffset_t off,
+                                   const H &rehash) {
+    assert(off);
+    auto width = (std::max)(width_, WidthOf(off));
+    if ((count_ + 1) * 10 > num_slots_ * 9 || width != width_) {
+      grow(width, rehash);
+    }
+    place(hash, off);
+    count_++;
+  }
+
+ private:
+  static size_t WidthOf(uoffset_t off) {
+    return off >> 24 ? 4 : (off >> 16 ? 3 : 2);
+  }
+
+  uoffset_t Get(size_t i) const {
+    auto p = &slots_[i * width_];
+    uoffset_t off = p[0] | (static_cast<uoffset_t>(p[1]) << 8);
+    if (width_ > 2) off |= static_cast<uoffset_t>(p[2]) << 16;
+    if (width_ > 3) off |= static_cast<uoffset_t>(p[3]) << 24;
+    return off;
+  }
+
+  void Set(size_t i, uoffset_t off) {
+    auto p = &slots_[i * width_];
+    for (size_t b = 0; b < width_; b++) {
+      p[b] = static_cast<uint8_t>(off >> (b * 8));
+    }
+  }
+
+  // Maps a hash onto [0, size) without a division.
+  static size_t Range(uint32_t hash, size_t size) {
+    return static_cast<size_t>((static_cast<uint64_t>(hash) * size) >> 32);
+  }
+
+  size_t Home(uint32_t hash) const { return Range(hash, num_slots_); }
+
+  // Any step in [1, size) visits every slot, since the size is prime. It is
+  // taken from the other half of the hash bits than Home() mostly uses.
+  size_t Step(uint32_t hash) const {
+    return 1 + Range((hash << 16) | (hash >> 16), num_slots_ - 1);
+  }
+
+  size_t Next(size_t i, size_t step) const {
+    i += step;
+    return i >= num_slots_ ? i - num_slots_ : i;
+  }
+
+  static size_t NextPrime(size_t n) {
+    for (n |= 1; ; n += 2) {
+      size_t d = 3;
+      while (d * d <= n && n % d) d += 2;
+      if (d * d > n) return n;
+    }
+  }
+
+  void place(uint32_t hash, uoffset_t off) {
+    auto step = Step(hash);
+    auto i = Home(hash);
+    while (Get(i)) i = Next(i, step);
+    Set(i, off);
+  }
+
+  template<typename H> void grow(size_t width, const H &rehash) {
+    auto old_num_slots = num_slots_;
+    auto old_width = width_;
+    std::vector<uint8_t> old_slots;
+    old_slots.swap(slots_);
+    if ((count_ + 1) * 10 > num_slots_ * 9) {
+      num_slots_ = NextPrime((std::max)((count_ + 1) * 5 / 4,
+                                        static_cast<size_t>(13)));
+    }
+    width_ = width;
+    slots_.resize(num_slots_ * width_, 0);
+    for (size_t i = 0; i < old_num_slots; i++) {
+      auto p = &old_slots[i * old_width];
+      uoffset_t off = 0;
+      for (size_t b = 0; b < old_width; b++) {
+        off |= static_cast<uoffset_t>(p[b]) << (b * 8);
+      }
+      if (off) place(rehash(off), off);
+    }
+  }
+
+  std::vector<uint8_t> slots_;  // Little endian offsets, 0 marks empty.
+  size_t num_slots_;
+  size_t width_;  // Bytes per slot.
+  size_t count_;
+};
+
 /// @endcond
 
 /// @addtogroup flatbuffers_cpp_api
@@ -651,24 +1210,23 @@ FLATBUFFERS_FINAL_CLASS
  public:
   /// @brief Default constructor for FlatBufferBuilder.
   /// @param[in] initial_size The initial size of the buffer, in bytes. Defaults
-  /// to`1024`.
+  /// to`1024`. Rounded up to a multiple of `FLATBUFFERS_MAX_ALIGNMENT`.
   /// @param[in] allocator A pointer to the `simple_allocator` that should be
-  /// used. Defaults to `nullptr`, which means the `default_allocator` will be
-  /// be used.
+  /// used. Defaults to `nullptr`, which means
+  /// `simple_allocator::default_instance()` will be used. Use a
+  /// `pooled_allocator` (e.g. `pooled_allocator::thread_local_instance()`) to
+  /// recycle buffer memory.
   explicit FlatBufferBuilder(uoffset_t initial_size = 1024,
                              const simple_allocator *allocator = nullptr)
-      : buf_(initial_size, allocator ? *allocator : default_allocator),
+      : buf_(initial_size,
+             allocator ? *allocator : simple_allocator::default_instance()),
         nested(false), finished(false), minalign_(1), force_defaults_(false),
-        dedup_vtables_(true), string_pool(nullptr) {
+        dedup_vtables_(true), batch_alignment_(sizeof(soffset_t)),
+        batch_vtable_(0), batch_table_size_(0), max_shared_strings_(0) {
     offsetbuf_.reserve(16);  // Avoid first few reallocs.
-    vtables_.reserve(16);
     EndianCheck();
   }
 
-  ~FlatBufferBuilder() {
-    if (string_pool) delete string_pool;
-  }
-
   /// @brief Reset all the state in this FlatBufferBuilder so it can be reused
   /// to construct another buffer.
   void Clear() {
@@ -677,22 +1235,47 @@ FLATBUFFERS_FINAL_CLASS
     nested = false;
     finished = false;
     vtables_.clear();
+    batch_vtable_ = 0;
     minalign_ = 1;
-    if (string_pool) string_pool->clear();
+    string_pool_.clear();
   }
 
   /// @brief The current size of the serialized buffer, counting from the end.
   /// @return Returns an `uoffset_t` with the current size of the buffer.
   uoffset_t GetSize() const { return buf_.size(); }
 
+  /// @brief Make sure that at least `size` more bytes, plus what `Finish()`
+  /// needs, can be serialized without the buffer growing again. Use this when
+  /// an upper bound of the data size is known up front, e.g. from the
+  /// `SizeHint()` generated for object API types.
+  /// @param[in] size The number of bytes to make room for.
+  void Reserve(size_t size) {
+    // Root offset, file identifier, size prefix and alignment padding.
+    buf_.ensure_space(size + 3 * sizeof(uoffset_t) + FLATBUFFERS_MAX_ALIGNMENT);
+  }
+
   /// @brief Get the serialized buffer (after you call `Finish()`).
   /// @return Returns an `uint8_t` pointer to the FlatBuffer data inside the
   /// buffer.
   uint8_t *GetBufferPointer() const {
     Finished();
+    // If you hit this, the buffer consists of multiple segments (see
+    // SegmentedBuffer()), use GetBufferSegments() instead.
+    assert(buf_.contiguous());
     return buf_.data();
   }
 
+  /// @brief Get the serialized buffer (after you call `Finish()`) as a list
+  /// of memory ranges, which concatenated form the buffer. These can be
+  /// written out directly with e.g. `writev`.
+  /// @return Returns the segments in the order they appear in the buffer.
+  /// Unless `SegmentedBuffer(true)` was used, this is always a single segment
+  /// equal to `GetBufferPointer()`/`GetSize()`.
+  std::vector<BufferSegment> GetBufferSegments() const {
+    Finished();
+    return buf_.segments();
+  }
+
   /// @brief Get a pointer to an unfinished buffer.
   /// @return Returns a `uint8_t` pointer to the unfinished buffer.
   uint8_t *GetCurrentBufferPointer() const { return buf_.data(); }
@@ -740,6 +1323,19 @@ FLATBUFFERS_FINAL_CLASS
   /// @param[in] bool dedup When set to `true`, dedup vtables.
   void DedupVtables(bool dedup) { dedup_vtables_ = dedup; }
 
+  /// @brief By default the buffer is kept in a single block of memory, which
+  /// is copied to a larger block whenever it runs out of space. In segmented
+  /// mode, a new block is chained instead, such that data never needs to be
+  /// copied (other than the object being written at the time), which is
+  /// useful for large buffers of unknown size. The result must be accessed
+  /// with `GetBufferSegments()` rather than `GetBufferPointer()`.
+  /// Objects that refer to each other may end up in different segments, so
+  /// functions that follow such references before `Finish()` can't be used:
+  /// `CreateVectorOfSortedTables` and `CreateKeyHashIndex` assert.
+  /// May only be called on an empty builder (e.g. right after `Clear()`).
+  /// @param[in] bool segmented When set to `true`, use segmented mode.
+  void SegmentedBuffer(bool segmented) { buf_.set_segmented(segmented); }
+
   /// @cond FLATBUFFERS_INTERNAL
   void Pad(size_t num_bytes) { buf_.fill(num_bytes); }
 
@@ -842,6 +1438,7 @@ FLATBUFFERS_FINAL_CLASS
   uoffset_t StartTable() {
     NotNested();
     nested = true;
+    buf_.mark();
     return GetSize();
   }
 
@@ -872,25 +1469,24 @@ FLATBUFFERS_FINAL_CLASS
       WriteScalar<voffset_t>(buf_.data() + field_location->id, pos);
     }
     offsetbuf_.clear();
-    auto vt1 = reinterpret_cast<voffset_t *>(buf_.data());
+    auto vt1 = buf_.data();
     auto vt1_size = ReadScalar<voffset_t>(vt1);
     auto vt_use = GetSize();
     // See if we already have generated a vtable with this exact same
     // layout before. If so, make it point to the old one, remove this one.
     if (dedup_vtables_) {
-      for (auto it = vtables_.begin(); it != vtables_.end(); ++it) {
-        auto vt2 = reinterpret_cast<voffset_t *>(buf_.data_at(*it));
-        auto vt2_size = *vt2;
-        if (vt1_size != vt2_size || memcmp(vt2, vt1, vt1_size)) continue;
-        vt_use = *it;
+      auto vt1_hash = HashBytes(vt1, vt1_size);
+      auto existing = vtables_.find(vt1_hash,
+                                    VTableEquals(buf_, vt1, vt1_size,
+                                                 buf_.segment_base()));
+      if (existing) {
+        vt_use = existing;
         buf_.pop(GetSize() - vtableoffsetloc);
-        break;
+      } else {
+        // This is a new vtable, remember it.
+        vtables_.insert(vt1_hash, vt_use, VTableHash(buf_));
       }
     }
-    // If this is a new vtable, remember it.
-    if (vt_use == GetSize()) {
-      vtables_.push_back(vt_use);
-    }
     // Fill the vtable offset we created above.
     // The offset points from the beginning of the object to where the
     // vtable is stored.
@@ -908,13 +1504,73 @@ FLATBUFFERS_FINAL_CLASS
   // just been constructed.
   template<typename T> void Required(Offset<T> table, voffset_t field) {
     auto table_ptr = buf_.data_at(table.o);
-    auto vtable_ptr = table_ptr - ReadScalar<soffset_t>(table_ptr);
+    auto vtable_ptr = buf_.data_at(table.o + ReadScalar<soffset_t>(table_ptr));
     bool ok = ReadScalar<voffset_t>(vtable_ptr + field) != 0;
     // If this fails, the caller will show what field needs to be set.
     assert(ok);
     (void)ok;
   }
 
+  // Tables that all have the same layout can be built much faster as a batch,
+  // e.g. a vector of rows: only the first table of a batch tracks its fields
+  // and gets a vtable, all others share that vtable. This requires every
+  // table to write the same fields (defaults included) in the same order.
+  // Call StartTableBatch() with the largest alignment of any field, then for
+  // each table StartBatchedTable(), AddBatched*() per field and
+  // EndBatchedTable().
+  void StartTableBatch(size_t alignment) {
+    batch_alignment_ = (std::max)(alignment, sizeof(soffset_t));
+    batch_vtable_ = 0;
+  }
+
+  uoffset_t StartBatchedTable() {
+    // Starting every table at the same alignment makes all padding between
+    // fields, and thus the layout, the same.
+    PreAlign(0, batch_alignment_);
+    return StartTable();
+  }
+
+  template<typename T> void AddBatchedElement(voffset_t field, T e) {
+    auto off = PushElement(e);
+    if (!batch_vtable_) TrackField(field, off);
+  }
+
+  template<typename T> void AddBatchedOffset(voffset_t field, Offset<T> off) {
+    AddBatchedElement(field, ReferTo(off.o));
+  }
+
+  template<typename T> void AddBatchedStruct(voffset_t field,
+                                             const T &structobj) {
+    Align(AlignOf<T>());
+    buf_.push_small(structobj);
+    if (!batch_vtable_) TrackField(field, GetSize());
+  }
+
+  uoffset_t EndBatchedTable(uoffset_t start, voffset_t numfields) {
+    if (!batch_vtable_) {
+      auto table = EndTable(start, numfields);
+      batch_vtable_ = table + ReadScalar<soffset_t>(buf_.data_at(table));
+      batch_table_size_ = table - start;
+      return table;
+    }
+    assert(nested);
+    auto table = PushElement<soffset_t>(0);
+    // If this asserts, this table wasn't written the same way as the first
+    // one in the batch.
+    assert(table - start == batch_table_size_);
+    if (batch_vtable_ <= buf_.segment_base()) {
+      // Tables may only refer to a vtable in their own segment, so this
+      // segment gets its own copy, shared by the rest of the batch.
+      auto vt = buf_.data_at(batch_vtable_);
+      buf_.push(vt, ReadScalar<voffset_t>(vt));
+      batch_vtable_ = GetSize();
+    }
+    WriteScalar(buf_.data_at(table), static_cast<soffset_t>(batch_vtable_) -
+                                       static_cast<soffset_t>(table));
+    nested = false;
+    return table;
+  }
+
   uoffset_t StartStruct(size_t alignment) {
     Align(alignment);
     return GetSize();
@@ -941,6 +1597,8 @@ FLATBUFFERS_FINAL_CLASS
   /// @return Returns the offset in the buffer where the string starts.
   Offset<String> CreateString(const char *str, size_t len) {
     NotNested();
+    buf_.mark();
+    buf_.ensure_space(len + 1 + 2 * sizeof(uoffset_t));
     PreAlign<uoffset_t>(len + 1);  // Always 0-terminated.
     buf_.fill(1);
     PushBytes(reinterpret_cast<const uint8_t *>(str), len);
@@ -976,21 +1634,17 @@ FLATBUFFERS_FINAL_CLASS
   /// @param[in] len The number of bytes that should be stored from `str`.
   /// @return Returns the offset in the buffer where the string starts.
   Offset<String> CreateSharedString(const char *str, size_t len) {
-    if (!string_pool)
-      string_pool = new StringOffsetMap(StringOffsetCompare(buf_));
-    auto size_before_string = buf_.size();
-    // Must first serialize the string, since the set is all offsets into
-    // buffer.
-    auto off = CreateString(str, len);
-    auto it = string_pool->find(off);
+    auto hash = HashBytes(reinterpret_cast<const uint8_t *>(str), len);
+    auto existing = string_pool_.find(hash, StringEquals(buf_, str, len));
     // If it exists we reuse existing serialized data!
-    if (it != string_pool->end()) {
-      // We can remove the string we serialized.
-      buf_.pop(buf_.size() - size_before_string);
-      return *it;
+    if (existing) return existing;
+    auto off = CreateString(str, len);
+    // Record this string for future use, unless that would make the pool
+    // bigger than allowed, in which case we start over with an empty pool.
+    if (max_shared_strings_ && string_pool_.size() >= max_shared_strings_) {
+      string_pool_.clear();
     }
-    // Record this string for future use.
-    string_pool->insert(off);
+    string_pool_.insert(hash, off.o, StringHash(buf_));
     return off;
   }
 
@@ -1021,6 +1675,17 @@ FLATBUFFERS_FINAL_CLASS
     return CreateSharedString(str->c_str(), str->Length());
   }
 
+  /// @brief Limit the number of distinct strings `CreateSharedString()`
+  /// remembers (by default there is no limit). When the limit is reached,
+  /// all strings are forgotten and sharing starts over, which keeps the
+  /// memory use of long-lived builders bounded at the cost of some strings
+  /// being serialized more than once.
+  /// @param[in] max_strings The maximum number of strings to remember, or
+  /// 0 for no limit.
+  void SetMaxSharedStrings(size_t max_strings) {
+    max_shared_strings_ = max_strings;
+  }
+
   /// @cond FLATBUFFERS_INTERNAL
   uoffset_t EndVector(size_t len) {
     assert(nested);  // Hit if no corresponding StartVector.
@@ -1031,6 +1696,10 @@ FLATBUFFERS_FINAL_CLASS
   void StartVector(size_t len, size_t elemsize) {
     NotNested();
     nested = true;
+    buf_.mark();
+    // Make space for the elements, length field and alignment all at once.
+    buf_.ensure_space(len * elemsize + sizeof(uoffset_t) +
+                      (std::max)(elemsize, sizeof(largest_scalar_t)));
     PreAlign<uoffset_t>(len * elemsize);
     PreAlign(len * elemsize, elemsize);  // Just in case elemsize > uoffset_t.
   }
@@ -1047,6 +1716,11 @@ FLATBUFFERS_FINAL_CLASS
   uint8_t *ReserveElements(size_t len, size_t elemsize) {
     return buf_.make_space(len * elemsize);
   }
+
+  // Location of an object already written, by its offset.
+  uint8_t *GetBufferAt(uoffset_t offset) const {
+    return buf_.data_at(offset);
+  }
   /// @endcond
 
   /// @brief Serialize an array into a FlatBuffer `vector`.
@@ -1186,6 +1860,8 @@ FLATBUFFERS_FINAL_CLASS
   /// where the vector is stored.
   template<typename T> Offset<Vector<Offset<T>>> CreateVectorOfSortedTables(
       Offset<T> *v, size_t len) {
+    // Keys may be in a different segment than their table.
+    assert(!buf_.segmented());
     std::sort(v, v + len, TableKeyComparator<T>(buf_));
     return CreateVector(v, len);
   }
@@ -1202,6 +1878,51 @@ FLATBUFFERS_FINAL_CLASS
     return CreateVectorOfSortedTables(data(*v), v->size());
   }
 
+  /// @brief Serialize a hash index of the keys of a vector of tables, for
+  /// use with `Vector::LookupByKeyHashed()`, typically stored in the field
+  /// named by the `hash_index` attribute of the vector field.
+  /// As with `CreateVectorOfSortedTables()`, the tables and their keys must
+  /// already be in the (non-segmented) buffer.
+  /// @tparam T The data type that the offset refers to.
+  /// @param[in] v An array of type `Offset<T>`, in the same order as the
+  /// vector being indexed (so after sorting it, if it is sorted).
+  /// @param[in] len The number of elements in `v`.
+  /// @return Returns a typed `Offset` into the serialized data indicating
+  /// where the index is stored.
+  template<typename T> Offset<Vector<uint32_t>> CreateKeyHashIndex(
+      const Offset<T> *v, size_t len) {
+    // Keys may be in a different segment than their table.
+    assert(!buf_.segmented());
+    // Open addressing with linear probing, at a load factor of at most 1/2.
+    // Each slot stores the hash next to the element, so a probe only reads
+    // a table when its hash matches.
+    size_t num_slots = 2;
+    while (num_slots < len * 2) num_slots *= 2;
+    auto mask = num_slots - 1;
+    std::vector<uint32_t> slots(num_slots * 2, 0);
+    for (size_t i = 0; i < len; i++) {
+      auto table = reinterpret_cast<const T *>(buf_.data_at(v[i].o));
+      auto hash = table->KeyHash();
+      auto slot = hash & mask;
+      while (slots[slot * 2 + 1]) slot = (slot + 1) & mask;
+      slots[slot * 2] = hash;
+      slots[slot * 2 + 1] = static_cast<uint32_t>(i + 1);
+    }
+    return CreateVector(slots);
+  }
+
+  /// @brief Serialize a hash index of the keys of a vector of tables, for
+  /// use with `Vector::LookupByKeyHashed()`.
+  /// @tparam T The data type that the offset refers to.
+  /// @param[in] v A vector of type `Offset<T>`, in the same order as the
+  /// vector being indexed.
+  /// @return Returns a typed `Offset` into the serialized data indicating
+  /// where the index is stored.
+  template<typename T> Offset<Vector<uint32_t>> CreateKeyHashIndex(
+      const std::vector<Offset<T>> &v) {
+    return CreateKeyHashIndex(data(v), v.size());
+  }
+
   /// @brief Specialized version of `CreateVector` for non-copying use cases.
   /// Write the data any time later to the returned buffer pointer `buf`.
   /// @param[in] len The number of elements to store in the `vector`.
@@ -1265,6 +1986,7 @@ FLATBUFFERS_FINAL_CLASS
 
   void Finish(uoffset_t root, const char *file_identifier, bool size_prefix) {
     NotNested();
+    buf_.mark();
     // This will cause the whole buffer to be aligned.
     PreAlign((size_prefix ? sizeof(uoffset_t) : 0) +
              sizeof(uoffset_t) +
@@ -1287,8 +2009,6 @@ FLATBUFFERS_FINAL_CLASS
     voffset_t id;
   };
 
-  simple_allocator default_allocator;
-
   vector_downward buf_;
 
   // Accumulating offsets of table members while it is being built.
@@ -1300,7 +2020,37 @@ FLATBUFFERS_FINAL_CLASS
   // Ensure the buffer is finished before it is being accessed.
   bool finished;
 
-  std::vector<uoffset_t> vtables_;  // todo: Could make this into a map?
+  // Hashing / comparison of vtables already in the buffer, for vtables_.
+  // The first voffset_t of any vtable is its size in bytes.
+  struct VTableHash {
+    VTableHash(const vector_downward &buf) : buf_(&buf) {}
+    uint32_t operator()(uoffset_t off) const {
+      auto vt = buf_->data_at(off);
+      return HashBytes(vt, ReadScalar<voffset_t>(vt));
+    }
+    const vector_downward *buf_;
+  };
+
+  // Tables may only refer to a vtable in their own segment (see
+  // SegmentedBuffer()), such that they can be accessed while building.
+  struct VTableEquals {
+    VTableEquals(const vector_downward &buf, const uint8_t *vt,
+                 voffset_t vt_size, size_t min_offset)
+      : buf_(&buf), vt_(vt), vt_size_(vt_size), min_offset_(min_offset) {}
+    bool operator()(uoffset_t off) const {
+      if (off <= min_offset_) return false;
+      auto vt2 = buf_->data_at(off);
+      return ReadScalar<voffset_t>(vt2) == vt_size_ &&
+             !memcmp(vt2, vt_, vt_size_);
+    }
+    const vector_downward *buf_;
+    const uint8_t *vt_;
+    voffset_t vt_size_;
+    size_t min_offset_;
+  };
+
+  // Offsets of all vtables written so far, indexed by their contents.
+  offset_hash_set vtables_;
 
   size_t minalign_;
 
@@ -1308,20 +2058,37 @@ FLATBUFFERS_FINAL_CLASS
 
   bool dedup_vtables_;
 
-  struct StringOffsetCompare {
-    StringOffsetCompare(const vector_downward &buf) : buf_(&buf) {}
-    bool operator() (const Offset<String> &a, const Offset<String> &b) const {
-      auto stra = reinterpret_cast<const String *>(buf_->data_at(a.o));
-      auto strb = reinterpret_cast<const String *>(buf_->data_at(b.o));
-      return strncmp(stra->c_str(), strb->c_str(),
-                     std::min(stra->size(), strb->size()) + 1) < 0;
+  // State of the current table batch, see StartTableBatch().
+  size_t batch_alignment_;
+  uoffset_t batch_vtable_;  // 0 until the first table in the batch is done.
+  uoffset_t batch_table_size_;
+
+  // Hashing / comparison of strings already in the buffer, for string_pool_.
+  struct StringHash {
+    StringHash(const vector_downward &buf) : buf_(&buf) {}
+    uint32_t operator()(uoffset_t off) const {
+      auto str = reinterpret_cast<const String *>(buf_->data_at(off));
+      return HashBytes(str->Data(), str->size());
     }
     const vector_downward *buf_;
   };
 
-  // For use with CreateSharedString. Instantiated on first use only.
-  typedef std::set<Offset<String>, StringOffsetCompare> StringOffsetMap;
-  StringOffsetMap *string_pool;
+  struct StringEquals {
+    StringEquals(const vector_downward &buf, const char *str, size_t len)
+      : buf_(&buf), str_(str), len_(len) {}
+    bool operator()(uoffset_t off) const {
+      auto str = reinterpret_cast<const String *>(buf_->data_at(off));
+      return str->size() == len_ && !memcmp(str->Data(), str_, len_);
+    }
+    const vector_downward *buf_;
+    const char *str_;
+    size_t len_;
+  };
+
+  // Offsets of all strings created by CreateSharedString, indexed by their
+  // contents.
+  offset_hash_set string_pool_;
+  size_t max_shared_strings_;  // 0 means no limit.
 };
 /// @}
 
@@ -1346,8 +2113,7 @@ template<typename T> const T *GetSizePrefixedRoot(const void *buf) {
 /// the pointer!
 template<typename T> T *GetMutableTemporaryPointer(FlatBufferBuilder &fbb,
                                                    Offset<T> offset) {
-  return reinterpret_cast<T *>(fbb.GetCurrentBufferPointer() +
-    fbb.GetSize() - offset.o);
+  return reinterpret_cast<T *>(fbb.GetBufferAt(offset.o));
 }
 
 template<typename T> const T *GetTemporaryPointer(FlatBufferBuilder &fbb,
@@ -1361,6 +2127,80 @@ inline bool BufferHasIdentifier(const void *buf, const char *identifier) {
                  identifier, FlatBufferBuilder::kFileIdentifierLength) == 0;
 }
 
+// Checks that each of the `count` offsets stored at `offsets` (as in a vector
+// of offsets) points to a location that has at least a uoffset_t before
+// `end`. The offsets themselves must be before `end`.
+// Does multiple offsets at once using SIMD where available.
+inline bool VerifyOffsetsInRange(const uint8_t *offsets, size_t count,
+                                 const uint8_t *end) {
+  // The largest offset allowed for the first element, every next element has
+  // a limit sizeof(uoffset_t) lower.
+  auto limit = static_cast<size_t>(end - offsets) - sizeof(uoffset_t);
+  size_t i = 0;
+  if (limit <= 0xFFFFFFFFu) {
+    #if defined(FLATBUFFERS_AVX2) || defined(FLATBUFFERS_SSE2)
+      // There are no unsigned compares, so flip the sign bits and do signed
+      // ones instead.
+      const int bias = -0x7FFFFFFF - 1;
+      auto lim = static_cast<uint32_t>(limit) ^ static_cast<uint32_t>(bias);
+    #endif
+    #ifdef FLATBUFFERS_AVX2
+      if (count >= 8) {
+        auto bias8 = _mm256_set1_epi32(bias);
+        auto step8 = _mm256_set1_epi32(8 * sizeof(uoffset_t));
+        auto lims8 = _mm256_setr_epi32(
+            static_cast<int>(lim), static_cast<int>(lim - 4),
+            static_cast<int>(lim - 8), static_cast<int>(lim - 12),
+            static_cast<int>(lim - 16), static_cast<int>(lim - 20),
+            static_cast<int>(lim - 24), static_cast<int>(lim - 28));
+        auto bad8 = _mm256_setzero_si256();
+        for (; i + 8 <= count; i += 8) {
+          auto offs = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+                                           offsets + i * sizeof(uoffset_t)));
+          offs = _mm256_xor_si256(offs, bias8);
+          bad8 = _mm256_or_si256(bad8, _mm256_cmpgt_epi32(offs, lims8));
+          lims8 = _mm256_sub_epi32(lims8, step8);
+        }
+        if (!_mm256_testz_si256(bad8, bad8)) return false;
+        lim -= static_cast<uint32_t>(i * sizeof(uoffset_t));
+      }
+    #endif
+    #ifdef FLATBUFFERS_SSE2
+      if (count - i >= 4) {
+        auto bias4 = _mm_set1_epi32(bias);
+        auto step4 = _mm_set1_epi32(4 * sizeof(uoffset_t));
+        auto lims4 = _mm_setr_epi32(
+            static_cast<int>(lim), static_cast<int>(lim - 4),
+            static_cast<int>(lim - 8), static_cast<int>(lim - 12));
+        auto bad4 = _mm_setzero_si128();
+        for (; i + 4 <= count; i += 4) {
+          auto offs = _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                                        offsets + i * sizeof(uoffset_t)));
+          offs = _mm_xor_si128(offs, bias4);
+          bad4 = _mm_or_si128(bad4, _mm_cmpgt_epi32(offs, lims4));
+          lims4 = _mm_sub_epi32(lims4, step4);
+        }
+        if (_mm_movemask_epi8(bad4)) return false;
+      }
+    #endif
+  }
+  for (; i < count; i++) {
+    auto off = ReadScalar<uoffset_t>(offsets + i * sizeof(uoffset_t));
+    if (off > limit - i * sizeof(uoffset_t)) return false;
+  }
+  return true;
+}
+
+#ifndef FLATBUFFERS_CPP98_STL
+/// @brief Function type that runs `task(i)` for every `i` in `[0, count)`,
+/// possibly in parallel, and returns once all of them have finished. Usually
+/// implemented on top of a thread pool. This lets the Verifier check large
+/// vectors of tables using multiple threads.
+typedef std::function<void (size_t count,
+                            const std::function<void (size_t i)> &task)>
+        parallel_for_function_t;
+#endif
+
 // Helper class to verify the integrity of a FlatBuffer
 class Verifier FLATBUFFERS_FINAL_CLASS {
  public:
@@ -1368,11 +2208,32 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
            size_t _max_tables = 1000000)
     : buf_(buf), end_(buf + buf_len), depth_(0), max_depth_(_max_depth),
       num_tables_(0), max_tables_(_max_tables)
+    #ifndef FLATBUFFERS_CPP98_STL
+        , parallel_for_(nullptr), parallel_chunk_size_(0)
+    #endif
+    #if FLATBUFFERS_HAS_THREADS
+        , shared_num_tables_(nullptr)
+    #endif
     #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
         , upper_bound_(buf)
     #endif
     {}
 
+  #ifndef FLATBUFFERS_CPP98_STL
+  // Verify vectors of more than `chunk_size` tables in chunks of that many
+  // tables, divided over `parallel_for` (which must outlive this verifier,
+  // pass nullptr to turn this off again). Each chunk is checked by a copy of
+  // this verifier, and all copies count tables in a single shared counter, so
+  // the max_tables limit holds for the buffer as a whole and all of them stop
+  // as soon as it is exceeded. Chunks don't parallelize any further.
+  // Ignored when built without FLATBUFFERS_HAS_THREADS.
+  void SetParallelFor(const parallel_for_function_t *parallel_for,
+                      size_t chunk_size = 4096) {
+    parallel_for_ = parallel_for;
+    parallel_chunk_size_ = (std::max)(chunk_size, static_cast<size_t>(1));
+  }
+  #endif
+
   // Central location where any verification failures register.
   bool Check(bool ok) const {
     #ifdef FLATBUFFERS_DEBUG_VERIFICATION_FAILURE
@@ -1446,18 +2307,38 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   }
 
   // Special case for string contents, after the above has been called.
+  // Equivalent to calling Verify() on each string, but first bounds-checks
+  // all offsets in one go, after which each string only needs its length
+  // and terminator checked.
   bool VerifyVectorOfStrings(const Vector<Offset<String>> *vec) const {
-      if (vec) {
-        for (uoffset_t i = 0; i < vec->size(); i++) {
-          if (!Verify(vec->Get(i))) return false;
-        }
-      }
-      return true;
+    if (!vec) return true;
+    auto offsets = vec->Data();
+    if (!Check(VerifyOffsetsInRange(offsets, vec->size(), end_)))
+      return false;
+    for (uoffset_t i = 0; i < vec->size(); i++) {
+      auto elem = offsets + i * sizeof(uoffset_t);
+      auto str = elem + ReadScalar<uoffset_t>(elem);
+      auto size = ReadScalar<uoffset_t>(str);
+      // The contents and the terminator must fit before end_.
+      auto max_size = static_cast<size_t>(end_ - str) - sizeof(uoffset_t);
+      if (!Check(size < max_size && str[sizeof(uoffset_t) + size] == '\0'))
+        return false;
+      #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
+        auto upper_bound = str + sizeof(uoffset_t) + size + 1;
+        if (upper_bound_ < upper_bound)
+          upper_bound_ = upper_bound;
+      #endif
+    }
+    return true;
   }
 
   // Special case for table contents, after the above has been called.
   template<typename T> bool VerifyVectorOfTables(const Vector<Offset<T>> *vec) {
     if (vec) {
+      #if FLATBUFFERS_HAS_THREADS
+        if (parallel_for_ && vec->size() > parallel_chunk_size_)
+          return VerifyVectorOfTablesInParallel(vec);
+      #endif
       for (uoffset_t i = 0; i < vec->size(); i++) {
         if (!vec->Get(i)->Verify(*this)) return false;
       }
@@ -1465,6 +2346,58 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
     return true;
   }
 
+  // Check an index created by FlatBufferBuilder::CreateKeyHashIndex() for
+  // vec, after both have been verified as vectors: only its layout and the
+  // elements it refers to, since a wrong hash can at worst make
+  // LookupByKeyHashed() not find a key.
+  template<typename T> bool VerifyKeyHashIndex(const Vector<T> *vec,
+                                               const Vector<uint32_t> *index) {
+    if (!index || !index->size()) return true;
+    auto num_slots = index->size() / 2;
+    if (!Check(vec && (index->size() & 1) == 0 &&
+               (num_slots & (num_slots - 1)) == 0))
+      return false;
+    for (uoffset_t i = 0; i < num_slots; i++) {
+      if (!Check(index->Get(i * 2 + 1) <= vec->size())) return false;
+    }
+    return true;
+  }
+
+  #if FLATBUFFERS_HAS_THREADS
+  template<typename T> bool VerifyVectorOfTablesInParallel(
+                              const Vector<Offset<T>> *vec) {
+    auto chunk_size = parallel_chunk_size_;
+    auto num_chunks = (vec->size() + chunk_size - 1) / chunk_size;
+    std::atomic<size_t> num_tables(num_tables_);
+    Verifier prototype(*this);
+    prototype.parallel_for_ = nullptr;
+    prototype.shared_num_tables_ = &num_tables;
+    std::vector<Verifier> chunks(num_chunks, prototype);
+    std::vector<uint8_t> chunk_ok(num_chunks, 0);
+    (*parallel_for_)(num_chunks, [&](size_t c) {
+      // Don't bother once another chunk ran out of tables.
+      if (num_tables > max_tables_) return;
+      auto &verifier = chunks[c];
+      auto end = (std::min)(static_cast<size_t>(vec->size()),
+                            (c + 1) * chunk_size);
+      for (auto i = c * chunk_size; i < end; i++) {
+        if (!vec->Get(static_cast<uoffset_t>(i))->Verify(verifier)) return;
+      }
+      chunk_ok[c] = 1;
+    });
+    bool ok = true;
+    for (size_t c = 0; c < num_chunks; c++) {
+      ok = ok && chunk_ok[c];
+      #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
+        if (upper_bound_ < chunks[c].upper_bound_)
+          upper_bound_ = chunks[c].upper_bound_;
+      #endif
+    }
+    num_tables_ = num_tables;
+    return ok && Check(num_tables_ <= max_tables_);
+  }
+  #endif
+
   template<typename T> bool VerifyBufferFromStart(const char *identifier,
                                                   const uint8_t *start) {
     if (identifier &&
@@ -1488,6 +2421,20 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
     return VerifyBufferFromStart<T>(identifier, buf_);
   }
 
+  #ifndef FLATBUFFERS_CPP98_STL
+  // Verify this whole buffer, starting with root type T, with large vectors
+  // of tables verified in parallel, see SetParallelFor().
+  template<typename T> bool VerifyBuffer(
+                              const char *identifier,
+                              const parallel_for_function_t &parallel_for,
+                              size_t chunk_size = 4096) {
+    SetParallelFor(&parallel_for, chunk_size);
+    auto ok = VerifyBuffer<T>(identifier);
+    SetParallelFor(nullptr);
+    return ok;
+  }
+  #endif
+
   template<typename T> bool VerifySizePrefixedBuffer(const char *identifier) {
     return Verify<uoffset_t>(buf_) &&
            ReadScalar<uoffset_t>(buf_) == end_ - buf_ - sizeof(uoffset_t) &&
@@ -1500,6 +2447,12 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   // with EndTable().
   bool VerifyComplexity() {
     depth_++;
+    #if FLATBUFFERS_HAS_THREADS
+      if (shared_num_tables_) {
+        return Check(depth_ <= max_depth_ &&
+                     ++*shared_num_tables_ <= max_tables_);
+      }
+    #endif
     num_tables_++;
     return Check(depth_ <= max_depth_ && num_tables_ <= max_tables_);
   }
@@ -1527,11 +2480,117 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   size_t max_depth_;
   size_t num_tables_;
   size_t max_tables_;
+#ifndef FLATBUFFERS_CPP98_STL
+  const parallel_for_function_t *parallel_for_;
+  size_t parallel_chunk_size_;
+#endif
+#if FLATBUFFERS_HAS_THREADS
+  // Shared by the copies verifying chunks in parallel, used instead of
+  // num_tables_ when set.
+  std::atomic<size_t> *shared_num_tables_;
+#endif
 #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
   mutable const uint8_t *upper_bound_;
 #endif
 };
 
+// Alternative to the Verifier for buffers of which only a small part is read:
+// rather than checking the whole buffer up front, accessors generated with
+// --gen-checked-accessors take an AccessChecker and check only what they
+// actually read. As long as only such accessors are used, starting from
+// AccessChecker::GetRoot(), this is as safe as verifying the buffer first.
+// Elements of vectors of strings or tables must be passed through Checked()
+// before use.
+// Failures are sticky: once a check fails, ok() returns false and all checked
+// accessors return their default value or nullptr.
+class AccessChecker FLATBUFFERS_FINAL_CLASS {
+ public:
+  AccessChecker(const uint8_t *buf, size_t buf_len)
+    : buf_(buf), end_(buf + buf_len), ok_(true) {}
+
+  bool ok() const { return ok_; }
+
+  bool Check(bool ok) {
+    ok_ = ok_ && ok;
+    return ok_;
+  }
+
+  // Verify any range within the buffer.
+  bool Verify(const void *elem, size_t elem_len) {
+    return Check(elem_len <= static_cast<size_t>(end_ - buf_) &&
+                 elem >= buf_ &&
+                 elem <= end_ - elem_len);
+  }
+
+  // Check the root offset (and identifier, if given), and the root table.
+  template<typename T> const T *GetRoot(const char *identifier = nullptr) {
+    if (identifier &&
+        !Check(static_cast<size_t>(end_ - buf_) >= 2 * sizeof(uoffset_t) &&
+               BufferHasIdentifier(buf_, identifier))) {
+      return nullptr;
+    }
+    if (!Verify(buf_, sizeof(uoffset_t))) return nullptr;
+    return Checked(reinterpret_cast<const T *>(buf_ +
+                                               ReadScalar<uoffset_t>(buf_)));
+  }
+
+  // Check the vtable of a table, which is all that is needed to be able to
+  // call its checked accessors.
+  bool VerifyTableStart(const uint8_t *table) {
+    if (!Verify(table, sizeof(soffset_t))) return false;
+    auto vtable = table - ReadScalar<soffset_t>(table);
+    return Verify(vtable, sizeof(voffset_t)) &&
+           Check((ReadScalar<voffset_t>(vtable) & (sizeof(voffset_t) - 1)) ==
+                 0) &&
+           Verify(vtable, ReadScalar<voffset_t>(vtable));
+  }
+
+  // The Checked() functions return their argument (which may be null) if it
+  // passes verification, and nullptr otherwise.
+  template<typename T> const T *Checked(const T *table) {
+    return !table || VerifyTableStart(reinterpret_cast<const uint8_t *>(table))
+           ? table : nullptr;
+  }
+
+  const String *Checked(const String *str) {
+    const uint8_t *end;
+    return !str ||
+           (VerifyVector(reinterpret_cast<const uint8_t *>(str), 1, &end) &&
+            Verify(end, 1) && Check(*end == '\0'))
+           ? str : nullptr;
+  }
+
+  template<typename T> const Vector<T> *Checked(const Vector<T> *vec) {
+    const uint8_t *end;
+    return !vec || VerifyVector(reinterpret_cast<const uint8_t *>(vec),
+                                sizeof(T), &end)
+           ? vec : nullptr;
+  }
+
+  template<typename T> const Vector<const T *> *Checked(
+                                                  const Vector<const T *> *vec) {
+    const uint8_t *end;
+    return !vec || VerifyVector(reinterpret_cast<const uint8_t *>(vec),
+                                sizeof(T), &end)
+           ? vec : nullptr;
+  }
+
+ private:
+  bool VerifyVector(const uint8_t *vec, size_t elem_size,
+                    const uint8_t **end) {
+    if (!Verify(vec, sizeof(uoffset_t))) return false;
+    auto size = ReadScalar<uoffset_t>(vec);
+    if (!Check(size < FLATBUFFERS_MAX_BUFFER_SIZE / elem_size)) return false;
+    auto byte_size = sizeof(size) + elem_size * size;
+    *end = vec + byte_size;
+    return Verify(vec, byte_size);
+  }
+
+  const uint8_t *buf_;
+  const uint8_t *end_;
+  bool ok_;
+};
+
 // Convenient way to bundle a buffer and its length, to pass it around
 // typed by its root.
 // A BufferRef does not own its buffer.
@@ -1676,6 +2735,15 @@ class Table {
            verifier.Verify<T>(data_ + field_offset);
   }
 
+  // Check the vtable and a particular field before it is read by a checked
+  // accessor, see AccessChecker.
+  template<typename T> bool CheckedField(AccessChecker &checker,
+                                         voffset_t field) const {
+    if (!checker.VerifyTableStart(data_)) return false;
+    auto field_offset = GetOptionalFieldOffset(field);
+    return !field_offset || checker.Verify(data_ + field_offset, sizeof(T));
+  }
+
  private:
   // private constructor & copy constructor: you obtain instances of this
   // class by pointing to existing data only
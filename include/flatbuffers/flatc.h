@@ -19,6 +19,7 @@
 #include "flatbuffers/util.h"
 #include <functional>
 #include <limits>
+#include <map>
 #include <string>
 
 #ifndef FLATC_H_
@@ -77,11 +78,43 @@ class FlatCompiler {
   std::string GetUsageString(const char* program_name) const;
 
  private:
-  void ParseFile(flatbuffers::Parser &parser,
+  // What --cache remembers about a schema: enough to tell if compiling it
+  // again would produce the same files, and that those files still exist.
+  struct CacheEntry {
+    uint64_t key;  // Hash of the options and the schema itself.
+    std::vector<std::pair<std::string, uint64_t>> deps;  // Included files.
+    std::vector<std::string> outputs;
+  };
+  typedef std::map<std::string, CacheEntry> Cache;
+
+  // What compiling a run of input files printed or failed with. Runs that
+  // are compiled in parallel are reported in the order of their inputs.
+  struct RunResult {
+    RunResult()
+        : failed(false), usage(false), show_exe_name(true),
+          cacheable(false) {}
+
+    std::vector<std::string> warnings;
+    std::string make_rules;
+    bool failed;
+    std::string error;
+    bool usage;
+    bool show_exe_name;
+    bool cacheable;  // If set, cache_entry should replace the cached one.
+    CacheEntry cache_entry;
+  };
+
+  static bool LoadCache(const std::string &filename, Cache *cache);
+  static bool SaveCache(const std::string &filename, const Cache &cache);
+  static bool IsUpToDate(const CacheEntry &entry, uint64_t key);
+
+  bool ParseFile(flatbuffers::Parser &parser,
                  const std::string &filename,
                  const std::string &contents,
                  std::vector<const char *> &include_directories) const;
 
+  void Report(const RunResult &result) const;
+
   void Warn(const std::string &warn, bool show_exe_name = true) const;
 
   void Error(const std::string &err, bool usage = true,
@@ -62,6 +62,42 @@ T HashFnv1a(const char *input) {
   return hash;
 }
 
+// Same as above, for strings that aren't 0-terminated.
+template <typename T>
+T HashFnv1a(const char *input, size_t len) {
+  T hash = FnvTraits<T>::kOffsetBasis;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= static_cast<unsigned char>(input[i]);
+    hash *= FnvTraits<T>::kFnvPrime;
+  }
+  return hash;
+}
+
+// Hash of a block of memory, meant for (large) binary buffers: FNV-1a over
+// 64-bit words rather than bytes, followed by a final mix so all input bits
+// affect all output bits. Much faster than HashFnv1a, but not stable across
+// platforms of different endianness.
+inline uint64_t HashBuffer64(const void *buf, size_t len) {
+  auto p = reinterpret_cast<const uint8_t *>(buf);
+  uint64_t hash = FnvTraits<uint64_t>::kOffsetBasis ^ len;
+  for (; len >= sizeof(uint64_t); len -= sizeof(uint64_t),
+                                  p += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    hash = (hash ^ word) * FnvTraits<uint64_t>::kFnvPrime;
+    hash ^= hash >> 32;
+  }
+  for (; len; len--, p++) {
+    hash = (hash ^ *p) * FnvTraits<uint64_t>::kFnvPrime;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
 template <typename T>
 struct NamedHashFunction {
   const char *name;
@@ -21,10 +21,12 @@
 #include <stack>
 #include <memory>
 #include <functional>
+#include <cstdio>
 
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/hash.h"
 #include "flatbuffers/reflection.h"
+#include "flatbuffers/util.h"
 
 // This file defines the data types representing a parsed IDL (Interface
 // Definition Language) / schema file.
@@ -146,14 +148,22 @@ struct Type {
 // Represents a parsed scalar value, it's type, and field offset.
 struct Value {
   Value() : constant("0"), offset(static_cast<voffset_t>(
-                                ~(static_cast<voffset_t>(0U)))) {}
+                                ~(static_cast<voffset_t>(0U)))),
+            typed(false), bits(0) {}
   Type type;
   std::string constant;
   voffset_t offset;
+  // When parsing JSON, scalars and offsets are stored in binary form in bits
+  // (see Parser::ParseScalar()) rather than as text in constant, to avoid
+  // converting them to text and back.
+  bool typed;
+  uint64_t bits;
 };
 
 // Helper class that retains the original order of a set of identifiers and
 // also provides quick lookup.
+// Symbols are found through an open addressing hash table over the names,
+// which can be looked up without copying them into a std::string first.
 template<typename T> class SymbolTable {
  public:
   ~SymbolTable() {
@@ -164,31 +174,89 @@ template<typename T> class SymbolTable {
 
   bool Add(const std::string &name, T *e) {
     vec.emplace_back(e);
-    auto it = dict.find(name);
-    if (it != dict.end()) return true;
-    dict[name] = e;
+    auto hash = HashFnv1a<uint32_t>(name.c_str(), name.size());
+    if (FindSlot(name.c_str(), name.size(), hash)->index) return true;
+    // Keep the table at most half full.
+    if ((dict_.size() + 1) * 2 > slots_.size()) Rehash(slots_.size() * 2);
+    dict_.emplace_back(name, e);
+    auto slot = FindSlot(name.c_str(), name.size(), hash);
+    slot->hash = hash;
+    slot->index = static_cast<uint32_t>(dict_.size());
     return false;
   }
 
   void Move(const std::string &oldname, const std::string &newname) {
-    auto it = dict.find(oldname);
-    if (it != dict.end()) {
-      auto obj = it->second;
-      dict.erase(it);
-      dict[newname] = obj;
+    auto slot = FindSlot(oldname.c_str(), oldname.size(),
+                         HashFnv1a<uint32_t>(oldname.c_str(), oldname.size()));
+    if (slot->index) {
+      dict_[slot->index - 1].first = newname;
+      Rehash(slots_.size());
     } else {
       assert(false);
     }
   }
 
+  T *Lookup(const char *name, size_t len) const {
+    auto slot = FindSlot(name, len, HashFnv1a<uint32_t>(name, len));
+    return slot->index ? dict_[slot->index - 1].second : nullptr;
+  }
+
+  T *Lookup(const char *name) const { return Lookup(name, strlen(name)); }
+
   T *Lookup(const std::string &name) const {
-    auto it = dict.find(name);
-    return it == dict.end() ? nullptr : it->second;
+    return Lookup(name.c_str(), name.size());
+  }
+
+  // Names and their symbols in order of insertion, without duplicates.
+  // This replaces the public std::map named dict this class used to have,
+  // which iterated in name order: use Lookup() to find a name.
+  const std::vector<std::pair<std::string, T *>> &symbols() const {
+    return dict_;
   }
 
  public:
-  std::map<std::string, T *> dict;      // quick lookup
   std::vector<T *> vec;  // Used to iterate in order of insertion
+
+ private:
+  struct Slot {
+    uint32_t hash;
+    uint32_t index;  // Into dict_, plus one. 0 if the slot is empty.
+  };
+
+  // Returns the slot holding name, or the empty slot where it would go.
+  const Slot *FindSlot(const char *name, size_t len, uint32_t hash) const {
+    static const Slot kEmpty = { 0, 0 };
+    if (slots_.empty()) return &kEmpty;
+    auto mask = slots_.size() - 1;
+    for (auto i = hash & mask; ; i = (i + 1) & mask) {
+      auto &slot = slots_[i];
+      if (!slot.index) return &slot;
+      auto &entry = dict_[slot.index - 1].first;
+      if (slot.hash == hash && entry.size() == len &&
+          !memcmp(entry.c_str(), name, len)) {
+        return &slot;
+      }
+    }
+  }
+
+  Slot *FindSlot(const char *name, size_t len, uint32_t hash) {
+    return const_cast<Slot *>(
+      static_cast<const SymbolTable *>(this)->FindSlot(name, len, hash));
+  }
+
+  void Rehash(size_t size) {
+    slots_.assign(size ? size : 8, Slot());
+    for (size_t i = 0; i < dict_.size(); i++) {
+      auto &name = dict_[i].first;
+      auto hash = HashFnv1a<uint32_t>(name.c_str(), name.size());
+      auto slot = FindSlot(name.c_str(), name.size(), hash);
+      slot->hash = hash;
+      slot->index = static_cast<uint32_t>(i + 1);
+    }
+  }
+
+  std::vector<std::pair<std::string, T *>> dict_;
+  std::vector<Slot> slots_;  // Size is a power of 2.
 };
 
 // A name space, as set in the schema.
@@ -352,6 +420,8 @@ struct IDLOptions {
   bool generate_name_strings;
   bool escape_proto_identifiers;
   bool generate_object_based_api;
+  bool generate_checked_accessors;
+  bool generate_json_parser;
   std::string cpp_object_api_pointer_type;
   bool union_value_namespacing;
   bool allow_non_utf8;
@@ -393,6 +463,8 @@ struct IDLOptions {
       generate_name_strings(false),
       escape_proto_identifiers(false),
       generate_object_based_api(false),
+      generate_checked_accessors(false),
+      generate_json_parser(false),
       cpp_object_api_pointer_type("std::unique_ptr"),
       union_value_namespacing(true),
       allow_non_utf8(false),
@@ -454,13 +526,20 @@ class CheckedError {
 #define FLATBUFFERS_CHECKED_ERROR CheckedError
 #endif
 
+class ParsedSchemaCache;
+
 class Parser : public ParserState {
  public:
-  explicit Parser(const IDLOptions &options = IDLOptions())
+  // If schema_cache is set, included files are looked up in it rather than
+  // parsed again by every Parser that includes them (see schema_cache.h).
+  explicit Parser(const IDLOptions &options = IDLOptions(),
+                  ParsedSchemaCache *schema_cache = nullptr)
     : root_struct_def_(nullptr),
       opts(options),
       source_(nullptr),
-      anonymous_counter(0) {
+      source_end_(nullptr),
+      anonymous_counter(0),
+      schema_cache_(schema_cache) {
     // Just in case none are declared:
     namespaces_.push_back(new Namespace());
     known_attributes_["deprecated"] = true;
@@ -472,6 +551,7 @@ class Parser : public ParserState {
     known_attributes_["bit_flags"] = true;
     known_attributes_["original_order"] = true;
     known_attributes_["nested_flatbuffer"] = true;
+    known_attributes_["hash_index"] = true;
     known_attributes_["csharp_partial"] = true;
     known_attributes_["streaming"] = true;
     known_attributes_["idempotent"] = true;
@@ -500,6 +580,15 @@ class Parser : public ParserState {
   bool Parse(const char *_source, const char **include_paths = nullptr,
              const char *source_filename = nullptr);
 
+  // Parses newline delimited JSON (NDJSON) from stream: a table of the root
+  // type on every line, skipping blank lines. Each is built in builder_
+  // (reused for all of them) as a size prefixed FlatBuffer, and passed to
+  // sink before the next line is read, so only the longest line needs to
+  // fit in memory. Returns false if a line fails to parse, with its line
+  // number (and source_filename, if given) in error_, or if sink did.
+  bool ParseJsonStream(FILE *stream, const BufferSink &sink,
+                       const char *source_filename = nullptr);
+
   // Set the root type. May override the one set in the schema.
   bool SetRootType(const char *name);
 
@@ -519,6 +608,14 @@ class Parser : public ParserState {
   // of the schema provided. Returns non-empty error on any problems.
   std::string ConformTo(const Parser &base);
 
+  // Copies the definitions of the files src parsed that haven't been parsed
+  // here yet, as if this parser had parsed them, which is much cheaper than
+  // parsing them again: e.g. to give every thread a Parser of its own for
+  // the same schema. Both parsers should have the same IDLOptions, and src
+  // should have been given the source_filename of its schema. Returns false,
+  // without changing anything, if any of them clash with definitions here.
+  bool ImportDefinitions(const Parser &src);
+
   FLATBUFFERS_CHECKED_ERROR CheckBitsFit(int64_t val, size_t bits);
 
 private:
@@ -551,6 +648,7 @@ private:
                                           BaseType req, bool *destmatch);
   FLATBUFFERS_CHECKED_ERROR ParseHash(Value &e, FieldDef* field);
   FLATBUFFERS_CHECKED_ERROR ParseSingleValue(Value &e);
+  FLATBUFFERS_CHECKED_ERROR ParseScalar(Value &e);
   FLATBUFFERS_CHECKED_ERROR ParseEnumFromString(Type &type, int64_t *result);
   StructDef *LookupCreateStruct(const std::string &name,
                                 bool create_if_new = true,
@@ -572,9 +670,16 @@ private:
   FLATBUFFERS_CHECKED_ERROR SkipJsonObject();
   FLATBUFFERS_CHECKED_ERROR SkipJsonArray();
   FLATBUFFERS_CHECKED_ERROR SkipJsonString();
+  FLATBUFFERS_CHECKED_ERROR ParseJsonRecord(const char *source, int line);
   FLATBUFFERS_CHECKED_ERROR DoParse(const char *_source,
                                     const char **include_paths,
                                     const char *source_filename);
+  // Copies the definitions of the included file filepath from
+  // schema_cache_, returns false if it has to be parsed here instead.
+  // Defined in schema_cache.cpp, next to ParsedSchemaCache.
+  bool ImportFromSchemaCache(const std::string &filepath,
+                             const std::string &contents,
+                             const char **include_paths);
   FLATBUFFERS_CHECKED_ERROR CheckClash(std::vector<FieldDef*> &fields,
                                        StructDef *struct_def,
                                        const char *suffix,
@@ -603,12 +708,15 @@ private:
 
  private:
   const char *source_;
+  const char *source_end_;  // The terminating '\0' of source_.
 
   std::string file_being_parsed_;
 
   std::vector<std::pair<Value, FieldDef *>> field_stack_;
 
   int anonymous_counter;
+
+  ParsedSchemaCache *schema_cache_;
 };
 
 // Utility functions for multiple generators:
@@ -626,9 +734,110 @@ extern std::string MakeCamel(const std::string &in, bool first = true);
 extern bool GenerateText(const Parser &parser,
                          const void *flatbuffer,
                          std::string *text);
+
+// Receives the text produced by the overloads below, one piece at a time.
+// Returns false to stop generating (e.g. because a write failed).
+typedef std::function<bool (const char *text, size_t len)> TextSink;
+
+// Same as GenerateText() above, but instead of building up the whole
+// document in memory, passes it to sink in pieces of roughly
+// kTextSinkChunkSize bytes as they are generated, so memory use stays bounded
+// however large the buffer is. Returns false if the text can't be generated
+// or the sink returned false; output up to that point has been passed on.
+extern bool GenerateText(const Parser &parser,
+                         const void *flatbuffer,
+                         const TextSink &sink);
+// Writes the text to a stdio stream (which may wrap a file descriptor, see
+// fdopen()) as it is generated.
+extern bool GenerateText(const Parser &parser,
+                         const void *flatbuffer,
+                         FILE *file);
 extern bool GenerateTextFile(const Parser &parser,
                              const std::string &path,
                              const std::string &file_name);
+// Same, for a FlatBuffer of size bytes other than the one in parser.builder_
+// (e.g. one mapped into memory with MappedFile). Writes nothing if size is
+// 0, and fails if it is too small to hold a root offset. The buffer is not
+// verified: it must be valid (e.g. checked with a Verifier) or trusted.
+extern bool GenerateTextFile(const Parser &parser,
+                             const std::string &path,
+                             const std::string &file_name,
+                             const void *flatbuffer,
+                             size_t size);
+// Converts a stream of size prefixed FlatBuffers read from stream (see
+// ReadSizePrefixedStream()) to newline delimited JSON (NDJSON): the text of
+// every buffer on a line of its own, passed to sink a line at a time. If
+// check_identifier is set, every buffer must have the schema's
+// file_identifier. Returns false with *error set if the stream is malformed
+// or the text can't be generated, or with *error unchanged if sink returned
+// false.
+extern bool GenerateTextStream(const Parser &parser,
+                               FILE *stream,
+                               bool check_identifier,
+                               const TextSink &sink,
+                               std::string *error);
+// The name of the file GenerateTextFile() writes.
+extern std::string TextFileName(const std::string &path,
+                                const std::string &file_name);
+
+const size_t kTextSinkChunkSize = 64 * 1024;
+
+// Generates text (JSON) like GenerateText(), but meant to be reused for many
+// FlatBuffers: the text of field names is only formatted once per table type,
+// and appending to the same (cleared) string for every buffer avoids
+// reallocating it. Uses the schema and options (opts) of the parser, which
+// must outlive it.
+// See idl_gen_text.cpp.
+class TextGenerator {
+ public:
+  explicit TextGenerator(const Parser &parser)
+    : parser_(parser), opts_(parser.opts), text_(nullptr), sink_(nullptr),
+      names_strict_json_(parser.opts.strict_json) {}
+  // Uses opts rather than those of the parser, e.g. to generate the text
+  // of every FlatBuffer on one line (indent_step < 0). opts must outlive it.
+  TextGenerator(const Parser &parser, const IDLOptions &opts)
+    : parser_(parser), opts_(opts), text_(nullptr), sink_(nullptr),
+      names_strict_json_(opts.strict_json) {}
+
+  // Appends the text for flatbuffer (which must have the root type of the
+  // parser) to *text. Returns false under the same conditions as
+  // GenerateText(), in which case *text contains partial output.
+  bool Generate(const void *flatbuffer, std::string *text);
+  // Passes the text to sink as it is generated, see the GenerateText()
+  // overload taking a TextSink.
+  bool Generate(const void *flatbuffer, const TextSink &sink);
+
+ private:
+  TextGenerator(const TextGenerator &);
+  TextGenerator &operator=(const TextGenerator &);
+
+  bool Flush();
+  void NewLine();
+  int Indent() const;
+  void OutputIdentifier(const std::string &name);
+  template<typename T> bool Print(T val, Type type, int indent,
+                                  StructDef *union_sd);
+  template<typename T> bool PrintVector(const Vector<T> &v, Type type,
+                                        int indent);
+  bool EscapeString(const String &s);
+  template<typename T> bool GenField(const FieldDef &fd, const Table *table,
+                                     bool fixed, int indent);
+  bool GenFieldOffset(const FieldDef &fd, const Table *table, bool fixed,
+                      int indent, StructDef *union_sd);
+  bool GenStruct(const StructDef &struct_def, const Table *table,
+                 int indent);
+  const std::vector<std::string> &FieldNames(const StructDef &struct_def);
+
+  const Parser &parser_;
+  const IDLOptions &opts_;
+  std::string *text_;  // Output of the current Generate() call.
+  const TextSink *sink_;  // Where text_ is flushed to, if not null.
+  std::string chunk_;  // Holds text waiting to be passed to sink_.
+  // For each table type, the text preceding the value of each of its fields:
+  // the (quoted, if strict_json) field name followed by ": ".
+  std::map<const StructDef *, std::vector<std::string>> field_names_;
+  bool names_strict_json_;  // The value of opts.strict_json they used.
+};
 
 // Generate binary files from a given FlatBuffer, and a given Parser
 // object that has been populated with the corresponding schema.
@@ -636,6 +845,10 @@ extern bool GenerateTextFile(const Parser &parser,
 extern bool GenerateBinary(const Parser &parser,
                            const std::string &path,
                            const std::string &file_name);
+// The name of the file GenerateBinary() writes.
+extern std::string BinaryFileName(const Parser &parser,
+                                  const std::string &path,
+                                  const std::string &file_name);
 
 // Generate a C++ header from the definitions in the Parser object.
 // See idl_gen_cpp.
@@ -0,0 +1,485 @@
+/*
+ * Copyright 2017 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_JSON_READER_H_
+#define FLATBUFFERS_JSON_READER_H_
+
+#include <cctype>
+#include <new>
+#include <string>
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/hash.h"
+#include "flatbuffers/util.h"
+
+namespace flatbuffers {
+
+// Reads JSON for the parse functions generated by flatc --cpp
+// --gen-json-parser. Those know the schema at compile time and call this
+// field by field, so no Parser or schema is needed at runtime.
+// The JSON dialect is the one Parser accepts: field names may be unquoted,
+// trailing commas and comments are allowed, enum values may be given by name
+// (several names separated by spaces are or-ed together), and integers may be
+// hexadecimal. The generated code enforces the rest of Parser's rules: a
+// field may be set only once, structs must have all their fields, and a union
+// value may come right before its type field instead of after it.
+class JsonReader {
+ public:
+  // The names of the values of an enum, see ParseEnum().
+  struct EnumValue {
+    const char *name;
+    int64_t value;
+  };
+
+  // json doesn't need to be 0-terminated. If skip_unknown_fields is false,
+  // fields not in the schema are an error, otherwise they are ignored.
+  // Unless allow_non_utf8 is set, strings must be valid UTF-8 (after
+  // unescaping), like with Parser.
+  JsonReader(const char *json, size_t len, bool skip_unknown_fields = false,
+             bool allow_non_utf8 = false)
+    : start_(json), cur_(json), end_(json + len),
+      skip_unknown_fields_(skip_unknown_fields),
+      allow_non_utf8_(allow_non_utf8), depth_(0) {}
+
+  // The hash generated code dispatches field names on. flatc picks a seed
+  // for every table such that the names of its fields have distinct hashes,
+  // so a single comparison confirms a match.
+  static uint32_t HashName(const char *name, size_t len, uint32_t seed) {
+    auto hash = FnvTraits<uint32_t>::kOffsetBasis ^ seed;
+    for (size_t i = 0; i < len; i++) {
+      hash ^= static_cast<unsigned char>(name[i]);
+      hash *= FnvTraits<uint32_t>::kFnvPrime;
+    }
+    return hash;
+  }
+
+  // Reads an object, calling field(name, len) for every field with the reader
+  // positioned at its value, which field must consume. Fields whose value is
+  // null are skipped, as if they weren't there.
+  template<typename F> bool ParseObject(F field) {
+    if (!Enter('{')) return false;
+    for (bool first = true; ; first = false) {
+      if (!NextItem('}', first)) return false;
+      if (Peek() == '}') break;
+      const char *name;
+      size_t len;
+      if (!ParseName(&name, &len) || !Expect(':')) return false;
+      SkipWhitespace();
+      if (!Keyword("null") && !field(name, len)) return false;
+    }
+    return Leave();
+  }
+
+  // Reads an array, calling element() for each element, which must consume
+  // it.
+  template<typename F> bool ParseArray(F element) {
+    if (!Enter('[')) return false;
+    for (bool first = true; ; first = false) {
+      if (!NextItem(']', first)) return false;
+      if (Peek() == ']') break;
+      if (!element()) return false;
+    }
+    return Leave();
+  }
+
+  bool Parse(std::string *s) {
+    SkipWhitespace();
+    if (cur_ == end_ || (*cur_ != '\"' && *cur_ != '\'')) {
+      return Error("string expected");
+    }
+    auto quote = *cur_++;
+    s->clear();
+    for (;;) {
+      auto run = cur_;
+      while (cur_ != end_ && *cur_ != quote && *cur_ != '\\') cur_++;
+      s->append(run, cur_);
+      if (cur_ == end_) return Error("unterminated string");
+      if (*cur_++ == quote) {
+        return allow_non_utf8_ || ValidateUTF8(*s) ||
+               Error("illegal UTF-8 sequence");
+      }
+      if (cur_ == end_) return Error("unterminated string");
+      switch (*cur_++) {
+        case 'n': *s += '\n'; break;
+        case 't': *s += '\t'; break;
+        case 'r': *s += '\r'; break;
+        case 'b': *s += '\b'; break;
+        case 'f': *s += '\f'; break;
+        case '\"': *s += '\"'; break;
+        case '\'': *s += '\''; break;
+        case '\\': *s += '\\'; break;
+        case '/': *s += '/'; break;
+        case 'x': {
+          uint32_t c;
+          if (!ParseHex(2, &c)) return false;
+          *s += static_cast<char>(c);
+          break;
+        }
+        case 'u': {
+          uint32_t ucc;
+          if (!ParseHex(4, &ucc)) return false;
+          if (ucc >= 0xD800 && ucc <= 0xDBFF) {
+            uint32_t low;
+            if (end_ - cur_ < 2 || cur_[0] != '\\' || cur_[1] != 'u') {
+              return Error("unpaired high surrogate");
+            }
+            cur_ += 2;
+            if (!ParseHex(4, &low)) return false;
+            if (low < 0xDC00 || low > 0xDFFF) {
+              return Error("invalid low surrogate");
+            }
+            ucc = (((ucc & 0x3FF) << 10) | (low & 0x3FF)) + 0x10000;
+          } else if (ucc >= 0xDC00 && ucc <= 0xDFFF) {
+            return Error("unpaired low surrogate");
+          }
+          ToUTF8(ucc, s);
+          break;
+        }
+        default: return Error("unknown escape code in string constant");
+      }
+    }
+  }
+
+  bool Parse(bool *v) {
+    SkipWhitespace();
+    if (Keyword("true")) {
+      *v = true;
+    } else if (Keyword("false")) {
+      *v = false;
+    } else {
+      uint8_t i;
+      if (!Parse(&i)) return false;
+      *v = i != 0;
+    }
+    return true;
+  }
+
+  // Integers and floating point numbers, which may be quoted.
+  template<typename T> bool Parse(T *v) {
+    SkipWhitespace();
+    if (cur_ == end_ || (*cur_ != '\"' && *cur_ != '\'')) {
+      return ParseNumber(v, std::is_floating_point<T>());
+    }
+    auto quote = *cur_++;
+    if (!ParseNumber(v, std::is_floating_point<T>())) return false;
+    if (cur_ == end_ || *cur_ != quote) return Error("number expected");
+    cur_++;
+    return true;
+  }
+
+  // Reads an integer field with the "hash" attribute: a string is stored as
+  // its hash, a number as is.
+  template<typename T, typename H> bool ParseHashed(T *v,
+                                                    H (*hash)(const char *)) {
+    SkipWhitespace();
+    if (cur_ == end_ || (*cur_ != '\"' && *cur_ != '\'')) return Parse(v);
+    std::string s;
+    if (!Parse(&s)) return false;
+    *v = static_cast<T>(hash(s.c_str()));
+    return true;
+  }
+
+  // Reads an enum value: a number, a name, or a string holding one or more
+  // names separated by spaces, which are or-ed together.
+  bool ParseEnum(const EnumValue *values, size_t count, int64_t *v) {
+    SkipWhitespace();
+    if (cur_ == end_) return Error("enum value expected");
+    const char *names, *names_end;
+    if (*cur_ == '\"' || *cur_ == '\'') {
+      auto quote = *cur_++;
+      names = cur_;
+      while (cur_ != end_ && *cur_ != quote) cur_++;
+      if (cur_ == end_) return Error("unterminated string");
+      names_end = cur_++;
+    } else if (IsIdentifierStart(*cur_)) {
+      names = cur_;
+      while (cur_ != end_ && IsIdentifierChar(*cur_)) cur_++;
+      names_end = cur_;
+    } else {
+      return Parse(v);
+    }
+    *v = 0;
+    while (names != names_end) {
+      auto name_end = names;
+      while (name_end != names_end && *name_end != ' ') name_end++;
+      auto len = static_cast<size_t>(name_end - names);
+      if (len) {
+        size_t i = 0;
+        while (i < count && (strncmp(values[i].name, names, len) ||
+                             values[i].name[len])) {
+          i++;
+        }
+        if (i == count) {
+          return Error("unknown enum value: " + std::string(names, len));
+        }
+        *v |= values[i].value;
+      }
+      names = name_end != names_end ? name_end + 1 : name_end;
+    }
+    return true;
+  }
+
+  // For a union value that comes before its type field: skips the value,
+  // calls parse() to read the type from the field right after it, then
+  // returns to the value. Like Parser, the type field must come right after.
+  template<typename F> bool PeekNextField(const char *name, F parse) {
+    auto value = cur_;
+    auto depth = depth_;
+    const char *next;
+    size_t len;
+    if (!SkipValue()) return false;
+    auto found = Peek() == ',';
+    if (found) {
+      cur_++;
+      if (!ParseName(&next, &len)) return false;
+      found = len == strlen(name) && !memcmp(next, name, len);
+    }
+    if (!found) {
+      return Error("missing type field after this union value: " +
+                   std::string(name));
+    }
+    if (!Expect(':') || !parse()) return false;
+    cur_ = value;
+    depth_ = depth;
+    return true;
+  }
+
+  // Consumes any value.
+  bool SkipValue() {
+    SkipWhitespace();
+    if (cur_ == end_) return Error("value expected");
+    switch (*cur_) {
+      case '{':
+        return ParseObject([&](const char *, size_t) { return SkipValue(); });
+      case '[':
+        return ParseArray([&]() { return SkipValue(); });
+      case '\"':
+      case '\'': {
+        std::string s;
+        return Parse(&s);
+      }
+      default: {
+        auto start = cur_;
+        while (cur_ != end_ && (IsIdentifierChar(*cur_) || *cur_ == '-' ||
+                                *cur_ == '+' || *cur_ == '.')) {
+          cur_++;
+        }
+        return cur_ != start || Error("value expected");
+      }
+    }
+  }
+
+  // Called by generated code for field names not in the schema, with the
+  // reader positioned at the field's value.
+  bool UnknownField(const char *name, size_t len) {
+    if (!skip_unknown_fields_) {
+      return Error("unknown field: " + std::string(name, len));
+    }
+    return SkipValue();
+  }
+
+  // Records an error at the current position, always returns false.
+  bool Error(const std::string &msg) {
+    int line = 1;
+    for (auto p = start_; p < cur_; p++) line += *p == '\n';
+    error_ = NumToString(line) + ": error: " + msg;
+    return false;
+  }
+
+  // Whether all of the JSON has been read, sets an error if not.
+  bool AtEnd() {
+    SkipWhitespace();
+    return cur_ == end_ || Error("unexpected text after the root object");
+  }
+
+  const std::string &error() const { return error_; }
+
+ private:
+  static bool IsIdentifierStart(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+  }
+
+  static bool IsIdentifierChar(char c) {
+    return IsIdentifierStart(c) || (c >= '0' && c <= '9');
+  }
+
+  void SkipWhitespace() {
+    while (cur_ != end_) {
+      auto c = *cur_;
+      if (c == ' ' || c == '\n' || c == '\t' || c == '\r') {
+        cur_++;
+      } else if (c == '/' && end_ - cur_ > 1 && cur_[1] == '/') {
+        while (cur_ != end_ && *cur_ != '\n') cur_++;
+      } else if (c == '/' && end_ - cur_ > 1 && cur_[1] == '*') {
+        cur_ += 2;
+        while (end_ - cur_ > 1 && !(cur_[0] == '*' && cur_[1] == '/')) cur_++;
+        cur_ = end_ - cur_ > 1 ? cur_ + 2 : end_;
+      } else {
+        break;
+      }
+    }
+  }
+
+  char Peek() {
+    SkipWhitespace();
+    return cur_ != end_ ? *cur_ : '\0';
+  }
+
+  bool Expect(char c) {
+    if (Peek() != c) return Error(std::string("expecting: ") + c);
+    cur_++;
+    return true;
+  }
+
+  bool Keyword(const char *word) {
+    auto len = strlen(word);
+    if (static_cast<size_t>(end_ - cur_) < len ||
+        memcmp(cur_, word, len) != 0 ||
+        (static_cast<size_t>(end_ - cur_) > len &&
+         IsIdentifierChar(cur_[len]))) {
+      return false;
+    }
+    cur_ += len;
+    return true;
+  }
+
+  bool Enter(char open) {
+    if (!Expect(open)) return false;
+    // Same as a FlatBuffer's maximum nesting depth, to bound recursion.
+    if (++depth_ > 64) return Error("JSON nested too deep");
+    return true;
+  }
+
+  bool Leave() {
+    depth_--;
+    cur_++;  // The closing bracket.
+    return true;
+  }
+
+  // Consumes the comma before an item if needed, leaving the reader at the
+  // item or the closing bracket (a trailing comma is fine).
+  bool NextItem(char close, bool first) {
+    auto c = Peek();
+    if (c == close) return true;
+    if (!first) {
+      if (c != ',') return Error(std::string("expecting: , or ") + close);
+      cur_++;
+    }
+    return true;
+  }
+
+  bool ParseName(const char **name, size_t *len) {
+    auto c = Peek();
+    if (c == '\"' || c == '\'') {
+      auto start = ++cur_;
+      while (cur_ != end_ && *cur_ != c) cur_++;
+      if (cur_ == end_) return Error("unterminated string");
+      *name = start;
+      *len = static_cast<size_t>(cur_++ - start);
+      return true;
+    }
+    if (!IsIdentifierStart(c)) return Error("field name expected");
+    *name = cur_;
+    while (cur_ != end_ && IsIdentifierChar(*cur_)) cur_++;
+    *len = static_cast<size_t>(cur_ - *name);
+    return true;
+  }
+
+  bool ParseHex(int digits, uint32_t *v) {
+    *v = 0;
+    for (int i = 0; i < digits; i++, cur_++) {
+      if (cur_ == end_ || !isxdigit(static_cast<unsigned char>(*cur_))) {
+        return Error("escape code must be followed by " +
+                     NumToString(digits) + " hex digits");
+      }
+      auto c = *cur_;
+      *v = *v * 16 + static_cast<uint32_t>(
+             c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+    }
+    return true;
+  }
+
+  template<typename T> bool ParseNumber(T *v, std::false_type) {
+    SkipWhitespace();
+    auto negative = cur_ != end_ && *cur_ == '-';
+    if (cur_ != end_ && (*cur_ == '-' || *cur_ == '+')) cur_++;
+    uint64_t base = 10;
+    if (end_ - cur_ > 2 && cur_[0] == '0' && (cur_[1] | 0x20) == 'x') {
+      base = 16;
+      cur_ += 2;
+    }
+    uint64_t m = 0;
+    auto start = cur_;
+    for (; cur_ != end_; cur_++) {
+      auto c = *cur_;
+      uint64_t digit;
+      if (c >= '0' && c <= '9') digit = static_cast<uint64_t>(c - '0');
+      else if (base == 16 && isxdigit(static_cast<unsigned char>(c)))
+        digit = static_cast<uint64_t>((c | 0x20) - 'a' + 10);
+      else break;
+      if (m > (~0ULL - digit) / base) return Error("integer out of range");
+      m = m * base + digit;
+    }
+    if (cur_ == start) return Error("integer expected");
+    if (cur_ != end_ && (*cur_ == '.' || (base == 10 && (*cur_ | 0x20) == 'e'))) {
+      return Error("integer expected, not a floating point number");
+    }
+    uint64_t max = static_cast<uint64_t>((std::numeric_limits<T>::max)());
+    // For signed types, the most negative value is one more than max.
+    if (m > max + (negative && std::is_signed<T>::value) ||
+        (negative && !std::is_signed<T>::value && m)) {
+      return Error("integer out of range for its type");
+    }
+    *v = static_cast<T>(negative ? 0 - m : m);
+    return true;
+  }
+
+  template<typename T> bool ParseNumber(T *v, std::true_type) {
+    SkipWhitespace();
+    auto start = cur_;
+    while (cur_ != end_ && (IsIdentifierChar(*cur_) || *cur_ == '-' ||
+                            *cur_ == '+' || *cur_ == '.')) {
+      cur_++;
+    }
+    // Copy it, as the conversion functions need it 0-terminated.
+    char buf[64];
+    auto len = static_cast<size_t>(cur_ - start);
+    if (len >= sizeof(buf)) len = 0;  // Not a number we can parse anyway.
+    memcpy(buf, start, len);
+    buf[len] = '\0';
+    char *end;
+    *v = sizeof(T) == sizeof(float)
+           ? static_cast<T>(StringToFloat(buf, &end))
+           : static_cast<T>(StringToDouble(buf, &end));
+    if (!len || *end) {
+      cur_ = start;
+      return Error("number expected");
+    }
+    return true;
+  }
+
+  const char *start_;
+  const char *cur_;
+  const char *end_;
+  bool skip_unknown_fields_;
+  bool allow_non_utf8_;
+  int depth_;
+  std::string error_;
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_JSON_READER_H_
@@ -145,6 +145,12 @@ struct KeyValue FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   int KeyCompareWithValue(const char *val) const {
     return strcmp(key()->c_str(), val);
   }
+  uint32_t KeyHash() const {
+    return KeyHash(key()->c_str());
+  }
+  static uint32_t KeyHash(const char *val) {
+    return flatbuffers::HashKey(val);
+  }
   const flatbuffers::String *value() const {
     return GetPointer<const flatbuffers::String *>(VT_VALUE);
   }
@@ -217,13 +223,13 @@ struct EnumVal FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   }
   int KeyCompareWithValue(int64_t val) const {
     const auto key = value();
-    if (key < val) {
-      return -1;
-    } else if (key > val) {
-      return 1;
-    } else {
-      return 0;
-    }
+    return static_cast<int>(key > val) - static_cast<int>(key < val);
+  }
+  uint32_t KeyHash() const {
+    return KeyHash(value());
+  }
+  static uint32_t KeyHash(int64_t val) {
+    return flatbuffers::HashKey(val);
   }
   const Object *object() const {
     return GetPointer<const Object *>(VT_OBJECT);
@@ -305,6 +311,12 @@ struct Enum FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   int KeyCompareWithValue(const char *val) const {
     return strcmp(name()->c_str(), val);
   }
+  uint32_t KeyHash() const {
+    return KeyHash(name()->c_str());
+  }
+  static uint32_t KeyHash(const char *val) {
+    return flatbuffers::HashKey(val);
+  }
   const flatbuffers::Vector<flatbuffers::Offset<EnumVal>> *values() const {
     return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<EnumVal>> *>(VT_VALUES);
   }
@@ -421,6 +433,12 @@ struct Field FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   int KeyCompareWithValue(const char *val) const {
     return strcmp(name()->c_str(), val);
   }
+  uint32_t KeyHash() const {
+    return KeyHash(name()->c_str());
+  }
+  static uint32_t KeyHash(const char *val) {
+    return flatbuffers::HashKey(val);
+  }
   const Type *type() const {
     return GetPointer<const Type *>(VT_TYPE);
   }
@@ -585,6 +603,12 @@ struct Object FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   int KeyCompareWithValue(const char *val) const {
     return strcmp(name()->c_str(), val);
   }
+  uint32_t KeyHash() const {
+    return KeyHash(name()->c_str());
+  }
+  static uint32_t KeyHash(const char *val) {
+    return flatbuffers::HashKey(val);
+  }
   const flatbuffers::Vector<flatbuffers::Offset<Field>> *fields() const {
     return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<Field>> *>(VT_FIELDS);
   }
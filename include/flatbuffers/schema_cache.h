@@ -0,0 +1,166 @@
+/*
+ * Copyright 2017 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_SCHEMA_CACHE_H_
+#define FLATBUFFERS_SCHEMA_CACHE_H_
+
+#include <map>
+#include <memory>
+#include <set>
+
+#include "flatbuffers/hash.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/util.h"
+
+#if FLATBUFFERS_HAS_THREADS
+  #include <mutex>
+#endif
+
+namespace flatbuffers {
+
+// Remembers the definitions parsed from included schema files, so Parsers
+// that share a cache parse every included file once, and copy its
+// definitions from here when another schema includes it again.
+// Each file is parsed on its own, by a Parser private to the cache. Entries
+// are keyed by the absolute path of the file and the include paths used to
+// find its own includes, and are parsed again when the contents of the file,
+// or of any file it includes (directly or not), no longer hash to the same
+// value (see HashBuffer64).
+// Files that can't be parsed on their own (e.g. because they use types from
+// a schema that included them earlier) are parsed by the including Parser as
+// usual. All Parsers sharing a cache should use the same IDLOptions, and may
+// do so from multiple threads (unless built without FLATBUFFERS_HAS_THREADS).
+class ParsedSchemaCache {
+ public:
+  ParsedSchemaCache() : hits_(0), misses_(0) {}
+
+  // Returns a Parser holding the definitions of the file filepath, whose
+  // contents were loaded into contents, parsing it first if needed. Returns
+  // nullptr if the file doesn't parse on its own.
+  std::shared_ptr<const Parser> Lookup(const std::string &filepath,
+                                       const std::string &contents,
+                                       const char **include_paths,
+                                       const IDLOptions &opts) {
+    auto key = AbsolutePath(filepath);
+    for (auto paths = include_paths; paths && *paths; paths++) {
+      key += '\n';
+      key += *paths;
+    }
+    auto hash = HashBuffer64(contents.c_str(), contents.size());
+    std::shared_ptr<const Entry> entry;
+    {
+      Lock lock(mutex_);
+      auto it = entries_.find(key);
+      if (it != entries_.end() && it->second->hash == hash) entry = it->second;
+    }
+    // Load its includes without holding the lock.
+    if (entry && IncludesUnchanged(*entry)) {
+      Lock lock(mutex_);
+      hits_++;
+      return entry->parser;
+    }
+    {
+      Lock lock(mutex_);
+      // Don't recurse into files that include each other, or wait for
+      // another thread parsing the same file: let the caller parse it.
+      if (!parsing_.insert(key).second) return nullptr;
+      misses_++;
+    }
+    // Parse without holding the lock, the file's own includes come from this
+    // cache too.
+    std::shared_ptr<Parser> parser(new Parser(opts, this));
+    std::shared_ptr<Entry> parsed(new Entry());
+    parsed->hash = hash;
+    if (parser->Parse(contents.c_str(), include_paths, filepath.c_str()) &&
+        !parser->builder_.GetSize()) {
+      auto includes = parser->GetIncludedFilesRecursive(filepath);
+      std::string included;
+      for (auto it = includes.begin(); it != includes.end(); ++it) {
+        if (*it == filepath) continue;
+        // If it can't be loaded, this entry is never reused.
+        auto loaded = LoadFile(it->c_str(), true, &included);
+        parsed->includes.push_back(std::make_pair(*it, loaded
+            ? HashBuffer64(included.c_str(), included.size()) : 0));
+      }
+      parsed->parser = parser;
+    }
+    Lock lock(mutex_);
+    parsing_.erase(key);
+    entries_[key] = parsed;
+    return parsed->parser;
+  }
+
+  // Forget all parsed files.
+  void Clear() {
+    Lock lock(mutex_);
+    entries_.clear();
+  }
+
+  size_t size() const {
+    Lock lock(mutex_);
+    return entries_.size();
+  }
+
+  // The number of Lookup() calls that were / were not found in the cache.
+  size_t hits() const {
+    Lock lock(mutex_);
+    return hits_;
+  }
+  size_t misses() const {
+    Lock lock(mutex_);
+    return misses_;
+  }
+
+ private:
+  ParsedSchemaCache(const ParsedSchemaCache &);
+  ParsedSchemaCache &operator=(const ParsedSchemaCache &);
+
+  #if FLATBUFFERS_HAS_THREADS
+    typedef std::mutex Mutex;
+    typedef std::lock_guard<std::mutex> Lock;
+  #else
+    // Without threads there is nothing to lock.
+    typedef int Mutex;
+    struct Lock { explicit Lock(Mutex &) {} };
+  #endif
+
+  struct Entry {
+    uint64_t hash;
+    std::shared_ptr<const Parser> parser;  // nullptr if it didn't parse.
+    // The files parser included, directly or not, and their hashes.
+    std::vector<std::pair<std::string, uint64_t>> includes;
+  };
+
+  static bool IncludesUnchanged(const Entry &entry) {
+    std::string contents;
+    for (auto it = entry.includes.begin(); it != entry.includes.end(); ++it) {
+      if (!LoadFile(it->first.c_str(), true, &contents) ||
+          HashBuffer64(contents.c_str(), contents.size()) != it->second)
+        return false;
+    }
+    return true;
+  }
+
+  mutable Mutex mutex_;
+  std::map<std::string, std::shared_ptr<const Entry>> entries_;
+  std::set<std::string> parsing_;  // Keys being parsed right now.
+  size_t hits_;
+  size_t misses_;
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_SCHEMA_CACHE_H_
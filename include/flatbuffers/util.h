@@ -17,13 +17,17 @@
 #ifndef FLATBUFFERS_UTIL_H_
 #define FLATBUFFERS_UTIL_H_
 
+#include <cstdio>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <string>
 #include <sstream>
 #include <stdint.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <locale.h>
+#include <limits>
 #ifdef _WIN32
 #ifndef WIN32_LEAN_AND_MEAN
   #define WIN32_LEAN_AND_MEAN
@@ -42,56 +46,459 @@
 
 #include "flatbuffers/flatbuffers.h"
 
+// strtod_l() and friends are used for the cases the parsing fast paths below
+// don't handle, define FLATBUFFERS_LOCALE_INDEPENDENT to 0 to use plain
+// strtod() instead on platforms that don't have them.
+#ifndef FLATBUFFERS_LOCALE_INDEPENDENT
+  #if (defined(_MSC_VER) && _MSC_VER >= 1700) || defined(__GLIBC__) || \
+      defined(__APPLE__) || defined(__FreeBSD__)
+    #define FLATBUFFERS_LOCALE_INDEPENDENT 1
+  #else
+    #define FLATBUFFERS_LOCALE_INDEPENDENT 0
+  #endif
+#endif
+#if FLATBUFFERS_LOCALE_INDEPENDENT && defined(__APPLE__)
+  #include <xlocale.h>
+#endif
+#if defined(FLATBUFFERS_SSE2) && defined(_MSC_VER)
+  #include <intrin.h>  // _BitScanForward
+#endif
+
 namespace flatbuffers {
 
-// Convert an integer or floating point value to a string.
-// In contrast to std::stringstream, "char" values are
-// converted to a string of digits, and we don't use scientific notation.
-template<typename T> std::string NumToString(T t) {
-  std::stringstream ss;
-  ss << t;
-  return ss.str();
+// The number conversion functions below don't allocate memory or depend on
+// the current locale (which also makes them safe to use from multiple threads
+// without contention), and always use '.' as decimal point.
+
+/// @cond FLATBUFFERS_INTERNAL
+#if FLATBUFFERS_LOCALE_INDEPENDENT
+  #ifdef _MSC_VER
+    typedef _locale_t ClassicLocaleType;
+    inline ClassicLocaleType ClassicLocale() {
+      static const ClassicLocaleType locale = _create_locale(LC_ALL, "C");
+      return locale;
+    }
+    #define FLATBUFFERS_STRTOD(s, end) _strtod_l(s, end, ClassicLocale())
+    #if _MSC_VER >= 1800
+      #define FLATBUFFERS_STRTOF(s, end) _strtof_l(s, end, ClassicLocale())
+    #else
+      #define FLATBUFFERS_STRTOF(s, end) \
+        static_cast<float>(FLATBUFFERS_STRTOD(s, end))
+    #endif
+  #else
+    typedef locale_t ClassicLocaleType;
+    inline ClassicLocaleType ClassicLocale() {
+      static const ClassicLocaleType locale = newlocale(LC_ALL_MASK, "C", 0);
+      return locale;
+    }
+    #define FLATBUFFERS_STRTOD(s, end) strtod_l(s, end, ClassicLocale())
+    #define FLATBUFFERS_STRTOF(s, end) strtof_l(s, end, ClassicLocale())
+  #endif
+#else
+  #define FLATBUFFERS_STRTOD(s, end) strtod(s, end)
+  #if defined(_MSC_VER) && _MSC_VER < 1800  // No strtof() before VS2013.
+    #define FLATBUFFERS_STRTOF(s, end) static_cast<float>(strtod(s, end))
+  #else
+    #define FLATBUFFERS_STRTOF(s, end) strtof(s, end)
+  #endif
+#endif
+
+#ifdef FLATBUFFERS_SSE2
+// Index of the lowest set bit in mask (e.g. from _mm_movemask_epi8), which
+// must not be 0.
+inline int LowestBitSet(uint32_t mask) {
+  #ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward(&i, mask);
+    return static_cast<int>(i);
+  #else
+    return __builtin_ctz(mask);
+  #endif
+}
+#endif
+
+// Writes the decimal digits of u at buf, returns the end of them.
+inline char *UIntToChars(uint64_t u, char *buf) {
+  char digits[20];
+  auto p = digits + sizeof(digits);
+  do {
+    *--p = static_cast<char>('0' + u % 10);
+    u /= 10;
+  } while (u);
+  auto len = digits + sizeof(digits) - p;
+  memcpy(buf, p, len);
+  return buf + len;
 }
-// Avoid char types used as character data.
-template<> inline std::string NumToString<signed char>(signed char t) {
-  return NumToString(static_cast<int>(t));
+
+inline char *IntToChars(int64_t i, char *buf) {
+  if (i < 0) {
+    *buf++ = '-';
+    return UIntToChars(0 - static_cast<uint64_t>(i), buf);
+  }
+  return UIntToChars(static_cast<uint64_t>(i), buf);
+}
+
+// Shortest decimal representation of floating point numbers, using the Grisu2
+// algorithm (Florian Loitsch, "Printing Floating-Point Numbers Quickly and
+// Accurately with Integers"). The digits produced always read back as the
+// same number, and are the shortest such digits in all but rare cases.
+namespace grisu {
+
+// A floating point number f * 2^e, with a 64-bit significand.
+struct DiyFp {
+  DiyFp(uint64_t _f, int _e) : f(_f), e(_e) {}
+  uint64_t f;
+  int e;
+};
+
+// x - y, for x.e == y.e and x.f >= y.f.
+inline DiyFp Sub(const DiyFp &x, const DiyFp &y) {
+  return DiyFp(x.f - y.f, x.e);
 }
-template<> inline std::string NumToString<unsigned char>(unsigned char t) {
-  return NumToString(static_cast<int>(t));
+
+// x * y, with the result rounded to 64 bits.
+inline DiyFp Mul(const DiyFp &x, const DiyFp &y) {
+  const uint64_t x_lo = x.f & 0xFFFFFFFFu, x_hi = x.f >> 32;
+  const uint64_t y_lo = y.f & 0xFFFFFFFFu, y_hi = y.f >> 32;
+  const uint64_t p0 = x_lo * y_lo, p1 = x_lo * y_hi;
+  const uint64_t p2 = x_hi * y_lo, p3 = x_hi * y_hi;
+  uint64_t mid = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+  mid += 1U << 31;  // Round.
+  return DiyFp(p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32), x.e + y.e + 64);
 }
 
-// Special versions for floats/doubles.
-template<> inline std::string NumToString<double>(double t) {
-  // to_string() prints different numbers of digits for floats depending on
-  // platform and isn't available on Android, so we use stringstream
-  std::stringstream ss;
-  // Use std::fixed to surpress scientific notation.
-  ss << std::fixed << t;
-  auto s = ss.str();
-  // Sadly, std::fixed turns "1" into "1.00000", so here we undo that.
-  auto p = s.find_last_not_of('0');
-  if (p != std::string::npos) {
-    s.resize(p + 1);  // Strip trailing zeroes.
-    if (s[s.size() - 1] == '.')
-      s.erase(s.size() - 1, 1);  // Strip '.' if a whole number.
+inline DiyFp Normalize(DiyFp x) {
+  while (!(x.f >> 63)) {
+    x.f <<= 1;
+    x.e--;
   }
-  return s;
+  return x;
+}
+
+// The value v and its boundaries: the points halfway to the neighbouring
+// floating point numbers, all normalized to the same exponent.
+struct Boundaries {
+  Boundaries(DiyFp _w, DiyFp _minus, DiyFp _plus)
+    : w(_w), minus(_minus), plus(_plus) {}
+  DiyFp w;
+  DiyFp minus;
+  DiyFp plus;
+};
+
+// T is float or double (with bits the same size as T), v must be > 0.
+template<typename T, typename Bits> Boundaries ComputeBoundaries(T v) {
+  static_assert(sizeof(T) == sizeof(Bits), "size mismatch");
+  const int kPrecision = std::numeric_limits<T>::digits;  // Incl. hidden bit.
+  const int kBias = std::numeric_limits<T>::max_exponent - 1 +
+                    (kPrecision - 1);
+  const int kMinExp = 1 - kBias;
+  const uint64_t kHiddenBit = uint64_t(1) << (kPrecision - 1);
+  Bits bits;
+  memcpy(&bits, &v, sizeof(T));
+  const uint64_t F = bits & (kHiddenBit - 1);
+  const int E = static_cast<int>(bits >> (kPrecision - 1));
+  const DiyFp x = E == 0 ? DiyFp(F, kMinExp)  // Denormal.
+                         : DiyFp(F + kHiddenBit, E - kBias);
+  // The distance to the next smaller number is half the usual one if v is a
+  // power of 2 (but not the smallest normal).
+  const bool lower_is_closer = F == 0 && E > 1;
+  const DiyFp plus = Normalize(DiyFp(2 * x.f + 1, x.e - 1));
+  DiyFp minus = lower_is_closer ? DiyFp(4 * x.f - 1, x.e - 2)
+                                : DiyFp(2 * x.f - 1, x.e - 1);
+  minus.f <<= minus.e - plus.e;
+  minus.e = plus.e;
+  return Boundaries(Normalize(x), minus, plus);
+}
+
+// Digit generation needs the exponent of the scaled numbers in this range.
+const int kAlpha = -60;
+const int kGamma = -32;
+
+struct CachedPower {  // c = f * 2^e ~= 10^k
+  uint64_t f;
+  int e;
+  int k;
+};
+
+// Returns a power of ten c such that kAlpha <= e + c.e + 64 <= kGamma.
+inline CachedPower GetCachedPower(int e) {
+  // 10^k for k = -300, -292, ..., 324, normalized and rounded to 64 bits.
+  static const CachedPower kCachedPowers[] = {
+      { 0xAB70FE17C79AC6CAULL, -1060, -300 },
+      { 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+      { 0xBE5691EF416BD60CULL, -1007, -284 },
+      { 0x8DD01FAD907FFC3CULL, -980, -276 },
+      { 0xD3515C2831559A83ULL, -954, -268 },
+      { 0x9D71AC8FADA6C9B5ULL, -927, -260 },
+      { 0xEA9C227723EE8BCBULL, -901, -252 },
+      { 0xAECC49914078536DULL, -874, -244 },
+      { 0x823C12795DB6CE57ULL, -847, -236 },
+      { 0xC21094364DFB5637ULL, -821, -228 },
+      { 0x9096EA6F3848984FULL, -794, -220 },
+      { 0xD77485CB25823AC7ULL, -768, -212 },
+      { 0xA086CFCD97BF97F4ULL, -741, -204 },
+      { 0xEF340A98172AACE5ULL, -715, -196 },
+      { 0xB23867FB2A35B28EULL, -688, -188 },
+      { 0x84C8D4DFD2C63F3BULL, -661, -180 },
+      { 0xC5DD44271AD3CDBAULL, -635, -172 },
+      { 0x936B9FCEBB25C996ULL, -608, -164 },
+      { 0xDBAC6C247D62A584ULL, -582, -156 },
+      { 0xA3AB66580D5FDAF6ULL, -555, -148 },
+      { 0xF3E2F893DEC3F126ULL, -529, -140 },
+      { 0xB5B5ADA8AAFF80B8ULL, -502, -132 },
+      { 0x87625F056C7C4A8BULL, -475, -124 },
+      { 0xC9BCFF6034C13053ULL, -449, -116 },
+      { 0x964E858C91BA2655ULL, -422, -108 },
+      { 0xDFF9772470297EBDULL, -396, -100 },
+      { 0xA6DFBD9FB8E5B88FULL, -369, -92 },
+      { 0xF8A95FCF88747D94ULL, -343, -84 },
+      { 0xB94470938FA89BCFULL, -316, -76 },
+      { 0x8A08F0F8BF0F156BULL, -289, -68 },
+      { 0xCDB02555653131B6ULL, -263, -60 },
+      { 0x993FE2C6D07B7FACULL, -236, -52 },
+      { 0xE45C10C42A2B3B06ULL, -210, -44 },
+      { 0xAA242499697392D3ULL, -183, -36 },
+      { 0xFD87B5F28300CA0EULL, -157, -28 },
+      { 0xBCE5086492111AEBULL, -130, -20 },
+      { 0x8CBCCC096F5088CCULL, -103, -12 },
+      { 0xD1B71758E219652CULL, -77, -4 },
+      { 0x9C40000000000000ULL, -50, 4 },
+      { 0xE8D4A51000000000ULL, -24, 12 },
+      { 0xAD78EBC5AC620000ULL, 3, 20 },
+      { 0x813F3978F8940984ULL, 30, 28 },
+      { 0xC097CE7BC90715B3ULL, 56, 36 },
+      { 0x8F7E32CE7BEA5C70ULL, 83, 44 },
+      { 0xD5D238A4ABE98068ULL, 109, 52 },
+      { 0x9F4F2726179A2245ULL, 136, 60 },
+      { 0xED63A231D4C4FB27ULL, 162, 68 },
+      { 0xB0DE65388CC8ADA8ULL, 189, 76 },
+      { 0x83C7088E1AAB65DBULL, 216, 84 },
+      { 0xC45D1DF942711D9AULL, 242, 92 },
+      { 0x924D692CA61BE758ULL, 269, 100 },
+      { 0xDA01EE641A708DEAULL, 295, 108 },
+      { 0xA26DA3999AEF774AULL, 322, 116 },
+      { 0xF209787BB47D6B85ULL, 348, 124 },
+      { 0xB454E4A179DD1877ULL, 375, 132 },
+      { 0x865B86925B9BC5C2ULL, 402, 140 },
+      { 0xC83553C5C8965D3DULL, 428, 148 },
+      { 0x952AB45CFA97A0B3ULL, 455, 156 },
+      { 0xDE469FBD99A05FE3ULL, 481, 164 },
+      { 0xA59BC234DB398C25ULL, 508, 172 },
+      { 0xF6C69A72A3989F5CULL, 534, 180 },
+      { 0xB7DCBF5354E9BECEULL, 561, 188 },
+      { 0x88FCF317F22241E2ULL, 588, 196 },
+      { 0xCC20CE9BD35C78A5ULL, 614, 204 },
+      { 0x98165AF37B2153DFULL, 641, 212 },
+      { 0xE2A0B5DC971F303AULL, 667, 220 },
+      { 0xA8D9D1535CE3B396ULL, 694, 228 },
+      { 0xFB9B7CD9A4A7443CULL, 720, 236 },
+      { 0xBB764C4CA7A44410ULL, 747, 244 },
+      { 0x8BAB8EEFB6409C1AULL, 774, 252 },
+      { 0xD01FEF10A657842CULL, 800, 260 },
+      { 0x9B10A4E5E9913129ULL, 827, 268 },
+      { 0xE7109BFBA19C0C9DULL, 853, 276 },
+      { 0xAC2820D9623BF429ULL, 880, 284 },
+      { 0x80444B5E7AA7CF85ULL, 907, 292 },
+      { 0xBF21E44003ACDD2DULL, 933, 300 },
+      { 0x8E679C2F5E44FF8FULL, 960, 308 },
+      { 0xD433179D9C8CB841ULL, 986, 316 },
+      { 0x9E19DB92B4E31BA9ULL, 1013, 324 },
+  };
+  const int kCachedPowersMinDecExp = -300;
+  const int kCachedPowersDecStep = 8;
+  // k = ceil((kAlpha - e - 1) * log10(2)).
+  const int f = kAlpha - e - 1;
+  const int k = (f * 78913) / (1 << 18) + static_cast<int>(f > 0);
+  const int index = (-kCachedPowersMinDecExp + k + (kCachedPowersDecStep - 1)) /
+                    kCachedPowersDecStep;
+  assert(index >= 0 && index < static_cast<int>(sizeof(kCachedPowers) /
+                                                sizeof(kCachedPowers[0])));
+  return kCachedPowers[index];
+}
+
+// Returns the number of decimal digits of n > 0, and the largest power of ten
+// <= n in *pow10.
+inline int LargestPow10(uint32_t n, uint32_t *pow10) {
+  int k = 10;
+  for (*pow10 = 1000000000; *pow10 > n; *pow10 /= 10) k--;
+  return k;
 }
-template<> inline std::string NumToString<float>(float t) {
-  return NumToString(static_cast<double>(t));
+
+// Moves the last digit towards w (at distance dist from the upper boundary)
+// while that stays within the boundaries.
+inline void Round(char *buf, int len, uint64_t dist, uint64_t delta,
+                  uint64_t rest, uint64_t ten_k) {
+  while (rest < dist && delta - rest >= ten_k &&
+         (rest + ten_k < dist || dist - rest > rest + ten_k - dist)) {
+    buf[len - 1]--;
+    rest += ten_k;
+  }
+}
+
+// Generates the shortest digits of a number within (minus, plus), as close as
+// possible to w. Returns the number of digits, *exp10 is adjusted such that
+// the result is digits * 10^*exp10.
+inline int GenerateDigits(char *buf, int *exp10, DiyFp minus, DiyFp w,
+                          DiyFp plus) {
+  uint64_t delta = Sub(plus, minus).f;
+  uint64_t dist = Sub(plus, w).f;
+  // Split plus into an integral part p1 and fractional part p2 of one.
+  const DiyFp one(uint64_t(1) << -plus.e, plus.e);
+  auto p1 = static_cast<uint32_t>(plus.f >> -one.e);
+  auto p2 = plus.f & (one.f - 1);
+  int len = 0;
+  uint32_t pow10;
+  for (int n = LargestPow10(p1, &pow10); n > 0; n--) {
+    buf[len++] = static_cast<char>('0' + p1 / pow10);
+    p1 %= pow10;
+    const uint64_t rest = (static_cast<uint64_t>(p1) << -one.e) + p2;
+    if (rest <= delta) {
+      *exp10 += n - 1;
+      Round(buf, len, dist, delta, rest,
+            static_cast<uint64_t>(pow10) << -one.e);
+      return len;
+    }
+    pow10 /= 10;
+  }
+  int m = 0;
+  for (;;) {
+    p2 *= 10;
+    buf[len++] = static_cast<char>('0' + (p2 >> -one.e));
+    p2 &= one.f - 1;
+    m++;
+    delta *= 10;
+    dist *= 10;
+    if (p2 <= delta) break;
+  }
+  *exp10 -= m;
+  Round(buf, len, dist, delta, p2, one.f);
+  return len;
+}
+
+// Writes the shortest digits of v > 0 to buf (at most 17), and returns their
+// number. The value is digits * 10^*exp10.
+template<typename T, typename Bits> int ToDigits(T v, char *buf, int *exp10) {
+  const Boundaries b = ComputeBoundaries<T, Bits>(v);
+  assert(b.w.e == b.plus.e);
+  const CachedPower cached = GetCachedPower(b.plus.e);
+  const DiyFp c(cached.f, cached.e);
+  const DiyFp w = Mul(b.w, c);
+  // Narrow the boundaries by one unit, to make up for the rounding errors of
+  // the multiplications.
+  DiyFp minus = Mul(b.minus, c);
+  DiyFp plus = Mul(b.plus, c);
+  minus.f++;
+  plus.f--;
+  *exp10 = -cached.k;
+  return GenerateDigits(buf, exp10, minus, w, plus);
+}
+
+}  // namespace grisu
+
+// Writes the shortest decimal representation of v that reads back as v, in
+// fixed (not scientific) notation, and without a trailing ".0" for whole
+// numbers. Returns the end of the written characters.
+template<typename T, typename Bits> char *FloatToChars(T v, char *buf) {
+  if (v != v) {
+    memcpy(buf, "nan", 3);
+    return buf + 3;
+  }
+  Bits bits;
+  memcpy(&bits, &v, sizeof(v));
+  if (bits >> (sizeof(Bits) * 8 - 1)) {  // Sign bit, also set for -0.0.
+    *buf++ = '-';
+    v = -v;
+  }
+  if (v == 0) {
+    *buf = '0';
+    return buf + 1;
+  }
+  if (v > std::numeric_limits<T>::max()) {
+    memcpy(buf, "inf", 3);
+    return buf + 3;
+  }
+  char digits[20];
+  int exp10;
+  const int len = grisu::ToDigits<T, Bits>(v, digits, &exp10);
+  const int point = len + exp10;  // Position of the decimal point.
+  if (exp10 >= 0) {  // Whole number.
+    memcpy(buf, digits, len);
+    buf += len;
+    memset(buf, '0', exp10);
+    return buf + exp10;
+  }
+  if (point > 0) {
+    memcpy(buf, digits, point);
+    buf += point;
+    *buf++ = '.';
+    memcpy(buf, digits + point, len - point);
+    return buf + len - point;
+  }
+  *buf++ = '0';
+  *buf++ = '.';
+  memset(buf, '0', -point);
+  buf -= point;
+  memcpy(buf, digits, len);
+  return buf + len;
+}
+/// @endcond
+
+// The maximum number of characters NumToChars() writes (for the smallest
+// negative double).
+const size_t kMaxNumToCharsLength = 350;
+
+// Writes an integer or floating point value to buf in text form, like
+// NumToString(), and returns the end of the written characters. Does not add
+// a terminating 0.
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value, char *>::type
+NumToChars(T t, char *buf) {
+  return std::is_signed<T>::value
+    ? IntToChars(static_cast<int64_t>(t), buf)
+    : UIntToChars(static_cast<uint64_t>(t), buf);
+}
+inline char *NumToChars(double t, char *buf) {
+  return FloatToChars<double, uint64_t>(t, buf);
+}
+inline char *NumToChars(float t, char *buf) {
+  return FloatToChars<float, uint32_t>(t, buf);
+}
+
+// Convert an integer or floating point value to a string.
+// In contrast to std::stringstream, "char" values are converted to a string
+// of digits, and we don't use scientific notation. Floating point values
+// use the fewest digits that read back as the same value, which means that a
+// float and a double with the same value (such as 0.1f and 0.1) may print
+// differently.
+/// @cond FLATBUFFERS_INTERNAL
+template<typename T> std::string NumToStringImpl(T t, std::true_type) {
+  char buf[kMaxNumToCharsLength];
+  return std::string(buf, NumToChars(t, buf));
+}
+// Any other type that can be written to a stream, such as enums.
+template<typename T> std::string NumToStringImpl(T t, std::false_type) {
+  std::stringstream ss;
+  ss << t;
+  return ss.str();
+}
+/// @endcond
+template<typename T> std::string NumToString(T t) {
+  return NumToStringImpl(t, std::integral_constant<bool,
+                              std::is_integral<T>::value ||
+                              std::is_same<T, float>::value ||
+                              std::is_same<T, double>::value>());
 }
 
 // Convert an integer value to a hexadecimal string.
 // The returned string length is always xdigits long, prefixed by 0 digits.
 // For example, IntToStringHex(0x23, 8) returns the string "00000023".
 inline std::string IntToStringHex(int i, int xdigits) {
-  std::stringstream ss;
-  ss << std::setw(xdigits)
-     << std::setfill('0')
-     << std::hex
-     << std::uppercase
-     << i;
-  return ss.str();
+  std::string s(xdigits, '0');
+  auto u = static_cast<unsigned int>(i);
+  for (auto p = s.end(); p != s.begin() && u; u >>= 4) {
+    *--p = "0123456789ABCDEF"[u & 0xF];
+  }
+  return s;
 }
 
 // Portable implementation of strtoll().
@@ -114,6 +521,96 @@ inline uint64_t StringToUInt(const char *str, char **endptr = nullptr,
   #endif
 }
 
+/// @cond FLATBUFFERS_INTERNAL
+// Parses the common forms of decimal numbers: [-]digits[.digits][e[+-]digits]
+// with at most 19 significant digits. Returns false for anything else, or if
+// the number doesn't fit in the mantissa.
+inline bool ParseDecimal(const char *str, const char **end, bool *negative,
+                         uint64_t *mantissa, int *exp10) {
+  auto p = str;
+  *negative = *p == '-';
+  if (*negative) p++;
+  uint64_t m = 0;
+  int digits = 0, exp = 0;
+  auto start = p;
+  for (; *p >= '0' && *p <= '9'; p++) {
+    if (m || *p != '0') digits++;
+    m = m * 10 + static_cast<uint64_t>(*p - '0');
+  }
+  auto int_digits = p - start;
+  if (*p == 'x' || *p == 'X') return false;  // Hex, leave it to strtod().
+  if (*p == '.') {
+    p++;
+    auto frac = p;
+    for (; *p >= '0' && *p <= '9'; p++) {
+      if (m || *p != '0') digits++;
+      m = m * 10 + static_cast<uint64_t>(*p - '0');
+    }
+    exp = -static_cast<int>(p - frac);
+    if (!int_digits && p == frac) return false;
+  } else if (!int_digits) {
+    return false;
+  }
+  if (digits > 19) return false;
+  if (*p == 'e' || *p == 'E') {
+    p++;
+    bool neg_exp = *p == '-';
+    if (*p == '-' || *p == '+') p++;
+    if (*p < '0' || *p > '9') return false;
+    int e = 0;
+    for (; *p >= '0' && *p <= '9'; p++) {
+      if (e < 10000) e = e * 10 + (*p - '0');
+    }
+    exp += neg_exp ? -e : e;
+  }
+  *end = p;
+  *mantissa = m;
+  *exp10 = exp;
+  return true;
+}
+/// @endcond
+
+// Locale-independent strtod(). Numbers that can be converted exactly with a
+// single multiplication or division (Clinger's fast path), which covers most
+// numbers in practice, don't need strtod() at all.
+inline double StringToDouble(const char *str, char **endptr = nullptr) {
+  static const double kPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  const char *end;
+  bool negative;
+  uint64_t m;
+  int exp10;
+  if (ParseDecimal(str, &end, &negative, &m, &exp10) &&
+      m <= (uint64_t(1) << 53) && exp10 >= -22 && exp10 <= 22) {
+    auto d = static_cast<double>(m);
+    d = exp10 < 0 ? d / kPow10[-exp10] : d * kPow10[exp10];
+    if (endptr) *endptr = const_cast<char *>(end);
+    return negative ? -d : d;
+  }
+  return FLATBUFFERS_STRTOD(str, endptr);
+}
+
+// Locale-independent strtof(), see StringToDouble().
+inline float StringToFloat(const char *str, char **endptr = nullptr) {
+  static const float kPow10[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+  };
+  const char *end;
+  bool negative;
+  uint64_t m;
+  int exp10;
+  if (ParseDecimal(str, &end, &negative, &m, &exp10) &&
+      m <= (uint64_t(1) << 24) && exp10 >= -10 && exp10 <= 10) {
+    auto f = static_cast<float>(m);
+    f = exp10 < 0 ? f / kPow10[-exp10] : f * kPow10[exp10];
+    if (endptr) *endptr = const_cast<char *>(end);
+    return negative ? -f : f;
+  }
+  return FLATBUFFERS_STRTOF(str, endptr);
+}
+
 typedef bool (*LoadFileFunction)(const char *filename, bool binary,
                                  std::string *dest);
 typedef bool (*FileExistsFunction)(const char *filename);
@@ -136,6 +633,49 @@ bool DirExists(const char *name);
 // no transcoding.
 bool LoadFile(const char *name, bool binary, std::string *buf);
 
+// A read-only view of the contents of a file, as if loaded with LoadFile()
+// in binary mode. Where possible the file is mapped into memory rather than
+// read, so even very large files are neither copied nor take up memory
+// beyond the pages actually accessed. Otherwise, or if a custom
+// LoadFileFunction is set, the file is loaded with LoadFile().
+// The contents must not be modified through data().
+class MappedFile {
+ public:
+  MappedFile() : data_(nullptr), size_(0), mapping_(nullptr) {}
+  ~MappedFile() { Close(); }
+
+  // Returns false if the file couldn't be opened (or is a directory).
+  bool Open(const char *name);
+  void Close();
+
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+  // Whether the contents are mapped, rather than loaded into memory.
+  bool mapped() const { return mapping_ != nullptr; }
+
+ private:
+  MappedFile(const MappedFile &);
+  MappedFile &operator=(const MappedFile &);
+
+  const char *data_;
+  size_t size_;
+  void *mapping_;  // The start of the mapping, or its handle on Windows.
+  std::string loaded_;
+};
+
+// Receives FlatBuffers one at a time, see ReadSizePrefixedStream() and
+// Parser::ParseJsonStream(). Returns false to stop.
+typedef std::function<bool (const uint8_t *buf, size_t len)> BufferSink;
+
+// Reads a stream of size prefixed FlatBuffers (see
+// FlatBufferBuilder::FinishSizePrefixed()), such as a log of them, and
+// passes each buffer (with its size prefix) to sink in turn. All buffers are
+// read into the same memory, so only the largest is held at a time, and
+// each is only valid during its call. Returns false if sink does, or with
+// *error set if the stream can't be read or ends in the middle of a buffer.
+bool ReadSizePrefixedStream(FILE *stream, const BufferSink &sink,
+                            std::string *error);
+
 // Save data "buf" of length "len" bytes into a file
 // "name" returning true if successful, false otherwise.
 // If "binary" is false data is written using ifstream's
@@ -318,6 +858,20 @@ inline int FromUTF8(const char **in) {
   return ucc;
 }
 
+// Whether all of str is valid UTF-8.
+inline bool ValidateUTF8(const std::string &str) {
+  const char *s = str.c_str();
+  const char * const sEnd = s + str.length();
+  while (s < sEnd) {
+    if (!(*s & 0x80)) {  // ASCII, by far the most common.
+      s++;
+    } else if (FromUTF8(&s) < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // Wraps a string to a maximum length, inserting new lines where necessary. Any
 // existing whitespace will be collapsed down to a single space. A prefix or
 // suffix can be provided, which will be inserted before or after a wrapped
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2017 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_VERIFIED_BUFFER_CACHE_H_
+#define FLATBUFFERS_VERIFIED_BUFFER_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/hash.h"
+
+#if FLATBUFFERS_HAS_THREADS
+  #include <atomic>
+  #include <mutex>
+#endif
+
+namespace flatbuffers {
+
+// Remembers which buffers have been verified successfully, so verifying the
+// same (immutable) buffer again is a comparison with a copy of it plus a
+// lookup, rather than a full Verifier pass.
+// Entries are keyed by root type, file identifier and the location and size
+// of the buffer, and hold a copy of the bytes that were verified. A buffer
+// only counts as verified if it is still byte for byte equal to that copy, so
+// a buffer that was modified, or freed and reused for different contents
+// (e.g. the next message in a receive buffer), is verified again. This makes
+// the cache safe for untrusted input, at the cost of holding a copy of each
+// cached buffer: at most max_entries of them, together at most max_bytes.
+// Buffers larger than max_bytes are verified but not cached.
+// The cache evicts the least recently used entries, and is safe to use from
+// multiple threads (unless built without FLATBUFFERS_HAS_THREADS). Buffers
+// are compared with their copy without holding the lock, so hits on large
+// buffers don't hold up other threads.
+class VerifiedBufferCache {
+ public:
+  explicit VerifiedBufferCache(size_t max_entries = 4096,
+                               size_t max_bytes = 64 * 1024 * 1024,
+                               size_t max_depth = 64,
+                               size_t max_tables = 1000000)
+    : max_entries_(max_entries), max_bytes_(max_bytes),
+      max_depth_(max_depth), max_tables_(max_tables), bytes_(0), hits_(0),
+      misses_(0) {}
+
+  // Same as Verifier::VerifyBuffer<T>(identifier), on a buffer of len bytes.
+  template<typename T> bool VerifyBuffer(const uint8_t *buf, size_t len,
+                                         const char *identifier = nullptr) {
+    Key key;
+    key.root_type = RootTypeId<T>();
+    key.identifier = identifier ? HashFnv1a<uint64_t>(identifier) : 0;
+    key.buf = buf;
+    key.len = len;
+    Contents cached;
+    {
+      Lock lock(mutex_);
+      auto it = index_.find(key);
+      if (it != index_.end()) {
+        cached = it->second->contents;
+        // Move to the front of the LRU list.
+        lru_.splice(lru_.begin(), lru_, it->second);
+      }
+    }
+    // The shared_ptr keeps the copy alive even if it is evicted meanwhile.
+    if (cached && !memcmp(cached->data(), buf, len)) {
+      hits_++;
+      return true;
+    }
+    misses_++;
+    // Verify a copy, so what ends up in the cache is exactly what was
+    // verified, even if the buffer changes meanwhile. This happens without
+    // holding the lock, other threads may verify (or look up) other buffers.
+    auto contents = std::make_shared<std::vector<uint8_t>>(buf, buf + len);
+    Verifier verifier(contents->data(), len, max_depth_, max_tables_);
+    if (!verifier.VerifyBuffer<T>(identifier)) return false;
+    if (!max_entries_ || len > max_bytes_) return true;
+    Lock lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      // Different contents at the same location, or raced with another.
+      // Same key, so the same size.
+      it->second->contents = contents;
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return true;
+    }
+    lru_.push_front(Entry());
+    lru_.front().key = key;
+    lru_.front().contents = contents;
+    index_[key] = lru_.begin();
+    bytes_ += len;
+    // The new entry fits by itself, so it is never evicted here.
+    while (index_.size() > max_entries_ || bytes_ > max_bytes_) {
+      bytes_ -= lru_.back().key.len;
+      index_.erase(lru_.back().key);
+      lru_.pop_back();
+    }
+    return true;
+  }
+
+  // Forget all verified buffers, and free the copies kept of them.
+  void Clear() {
+    Lock lock(mutex_);
+    index_.clear();
+    lru_.clear();
+    bytes_ = 0;
+  }
+
+  size_t size() const {
+    Lock lock(mutex_);
+    return index_.size();
+  }
+
+  // The total size of the copies of the cached buffers.
+  size_t bytes() const {
+    Lock lock(mutex_);
+    return bytes_;
+  }
+
+  // The number of VerifyBuffer() calls that were / were not found in the
+  // cache.
+  size_t hits() const { return hits_; }
+  size_t misses() const { return misses_; }
+
+ private:
+  VerifiedBufferCache(const VerifiedBufferCache &);
+  VerifiedBufferCache &operator=(const VerifiedBufferCache &);
+
+  // A unique address per root type, to identify the schema without RTTI.
+  // Not const: identical constants may be folded into one (e.g. /OPT:ICF or
+  // --icf=all), which would make all root types share the same address.
+  template<typename T> static const void *RootTypeId() {
+    static char id;
+    return &id;
+  }
+
+  struct Key {
+    const void *root_type;
+    uint64_t identifier;
+    const uint8_t *buf;
+    size_t len;
+
+    bool operator==(const Key &o) const {
+      return root_type == o.root_type && identifier == o.identifier &&
+             buf == o.buf && len == o.len;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key &key) const {
+      const uint64_t fields[] = {
+        reinterpret_cast<size_t>(key.root_type), key.identifier,
+        reinterpret_cast<size_t>(key.buf), key.len
+      };
+      return static_cast<size_t>(HashBuffer64(fields, sizeof(fields)));
+    }
+  };
+
+  // The bytes that were verified, shared with lookups that compare against
+  // them.
+  typedef std::shared_ptr<const std::vector<uint8_t>> Contents;
+
+  struct Entry {
+    Key key;
+    Contents contents;
+  };
+
+  #if FLATBUFFERS_HAS_THREADS
+    typedef std::mutex Mutex;
+    typedef std::lock_guard<std::mutex> Lock;
+    typedef std::atomic<size_t> Counter;
+  #else
+    // Without threads there is nothing to lock.
+    typedef int Mutex;
+    struct Lock { explicit Lock(Mutex &) {} };
+    typedef size_t Counter;
+  #endif
+
+  typedef std::list<Entry> LruList;
+
+  size_t max_entries_;
+  size_t max_bytes_;
+  size_t max_depth_;
+  size_t max_tables_;
+  mutable Mutex mutex_;
+  LruList lru_;  // Most recently used first.
+  std::unordered_map<Key, LruList::iterator, KeyHash> index_;
+  size_t bytes_;
+  Counter hits_;
+  Counter misses_;
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_VERIFIED_BUFFER_CACHE_H_
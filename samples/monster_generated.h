@@ -93,6 +93,7 @@ struct EquipmentUnion {
 
   static flatbuffers::NativeTable *UnPack(const void *obj, Equipment type, const flatbuffers::resolver_function_t *resolver);
   flatbuffers::Offset<void> Pack(flatbuffers::FlatBufferBuilder &_fbb, const flatbuffers::rehasher_function_t *_rehasher = nullptr) const;
+  size_t SizeHint() const;
 
   WeaponT *AsWeapon() {
     return type == Equipment_Weapon ?
@@ -157,6 +158,7 @@ struct MonsterT : public flatbuffers::NativeTable {
         hp(100),
         color(Color_Blue) {
   }
+  size_t SizeHint() const;
 };
 
 struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
@@ -348,6 +350,7 @@ struct WeaponT : public flatbuffers::NativeTable {
   WeaponT()
       : damage(0) {
   }
+  size_t SizeHint() const;
 };
 
 struct Weapon FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
@@ -443,7 +446,17 @@ inline void Monster::UnPackTo(MonsterT *_o, const flatbuffers::resolver_function
   { auto _e = equipped(); if (_e) _o->equipped.table = EquipmentUnion::UnPack(_e, equipped_type(),_resolver); };
 }
 
+inline size_t MonsterT::SizeHint() const {
+  size_t _s = 83;
+  _s += name.size() + 8;
+  _s += inventory.size() * 1 + 7;
+  _s += weapons.size() * 4 + 10; for (size_t _i = 0; _i < weapons.size(); _i++) { _s += weapons[_i]->SizeHint(); }
+  _s += equipped.SizeHint();
+  return _s;
+}
+
 inline flatbuffers::Offset<Monster> Monster::Pack(flatbuffers::FlatBufferBuilder &_fbb, const MonsterT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  _fbb.Reserve(_o->SizeHint());
   return CreateMonster(_fbb, _o, _rehasher);
 }
 
@@ -485,7 +498,14 @@ inline void Weapon::UnPackTo(WeaponT *_o, const flatbuffers::resolver_function_t
   { auto _e = damage(); _o->damage = _e; };
 }
 
+inline size_t WeaponT::SizeHint() const {
+  size_t _s = 25;
+  _s += name.size() + 8;
+  return _s;
+}
+
 inline flatbuffers::Offset<Weapon> Weapon::Pack(flatbuffers::FlatBufferBuilder &_fbb, const WeaponT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  _fbb.Reserve(_o->SizeHint());
   return CreateWeapon(_fbb, _o, _rehasher);
 }
 
@@ -500,6 +520,27 @@ inline flatbuffers::Offset<Weapon> CreateWeapon(flatbuffers::FlatBufferBuilder &
       _damage);
 }
 
+inline flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Weapon>>> CreateVectorOfWeapon(
+    flatbuffers::FlatBufferBuilder &_fbb, const WeaponT *_o, size_t _len) {
+  std::vector<flatbuffers::Offset<Weapon>> _tables(_len);
+  _fbb.StartTableBatch(4);
+  for (size_t _i = 0; _i < _len; _i++) {
+    const auto &_e = _o[_i];
+    auto _name = _fbb.CreateString(_e.name);
+    const auto _start = _fbb.StartBatchedTable();
+    _fbb.AddBatchedOffset(Weapon::VT_NAME, _name);
+    _fbb.AddBatchedElement<int16_t>(Weapon::VT_DAMAGE, _e.damage);
+    _tables[_i] = flatbuffers::Offset<Weapon>(
+        _fbb.EndBatchedTable(_start, 2));
+  }
+  return _fbb.CreateVector(_tables);
+}
+
+inline flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Weapon>>> CreateVectorOfWeapon(
+    flatbuffers::FlatBufferBuilder &_fbb, const std::vector<WeaponT> &_o) {
+  return CreateVectorOfWeapon(_fbb, _o.data(), _o.size());
+}
+
 inline bool VerifyEquipment(flatbuffers::Verifier &verifier, const void *obj, Equipment type) {
   switch (type) {
     case Equipment_NONE: {
@@ -544,6 +585,16 @@ inline flatbuffers::Offset<void> EquipmentUnion::Pack(flatbuffers::FlatBufferBui
   }
 }
 
+inline size_t EquipmentUnion::SizeHint() const {
+  switch (type) {
+    case Equipment_Weapon: {
+      auto ptr = reinterpret_cast<const WeaponT *>(table);
+      return ptr->SizeHint();
+    }
+    default: return 0;
+  }
+}
+
 inline void EquipmentUnion::Reset() {
   switch (type) {
     case Equipment_Weapon: {
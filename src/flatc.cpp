@@ -15,12 +15,26 @@
  */
 
 #include "flatbuffers/flatc.h"
+#include "flatbuffers/hash.h"
+#include "flatbuffers/schema_cache.h"
+
+#include <deque>
+
+#if FLATBUFFERS_HAS_THREADS
+  #include <atomic>
+  #include <chrono>
+  #include <condition_variable>
+  #include <mutex>
+  #include <thread>
+#else
+  #include <ctime>
+#endif
 
 #define FLATC_VERSION "1.5.0 (" __DATE__ ")"
 
 namespace flatbuffers {
 
-void FlatCompiler::ParseFile(
+bool FlatCompiler::ParseFile(
     flatbuffers::Parser &parser,
     const std::string &filename,
     const std::string &contents,
@@ -28,11 +42,11 @@ void FlatCompiler::ParseFile(
   auto local_include_directory = flatbuffers::StripFileName(filename);
   include_directories.push_back(local_include_directory.c_str());
   include_directories.push_back(nullptr);
-  if (!parser.Parse(contents.c_str(), &include_directories[0],
-                    filename.c_str()))
-    Error(parser.error_, false, false);
+  auto ok = parser.Parse(contents.c_str(), &include_directories[0],
+                         filename.c_str());
   include_directories.pop_back();
   include_directories.pop_back();
+  return ok;
 }
 
 void FlatCompiler::Warn(const std::string &warn, bool show_exe_name) const {
@@ -44,6 +58,216 @@ void FlatCompiler::Error(const std::string &err, bool usage,
   params_.error_fn(this, err, usage, show_exe_name);
 }
 
+void FlatCompiler::Report(const RunResult &result) const {
+  for (auto it = result.warnings.begin(); it != result.warnings.end(); ++it)
+    Warn(*it);
+  if (!result.make_rules.empty()) printf("%s", result.make_rules.c_str());
+  if (result.failed) Error(result.error, result.usage, result.show_exe_name);
+}
+
+// The cache is a text file with a line per schema, followed by a line for
+// each file it includes (itself too) and each file generated from it:
+//   schema KEY PATH
+//   dep HASH PATH
+//   out PATH
+static const char *kCacheHeader = "flatc cache 1";
+
+bool FlatCompiler::LoadCache(const std::string &filename, Cache *cache) {
+  std::string contents;
+  if (!flatbuffers::LoadFile(filename.c_str(), false, &contents)) return false;
+  std::stringstream ss(contents);
+  std::string line;
+  if (!std::getline(ss, line) || line != kCacheHeader) return false;
+  CacheEntry *entry = nullptr;
+  while (std::getline(ss, line)) {
+    auto kind_end = line.find(' ');
+    if (kind_end == std::string::npos) return false;
+    auto kind = line.substr(0, kind_end);
+    if (kind == "out") {
+      if (!entry) return false;
+      entry->outputs.push_back(line.substr(kind_end + 1));
+      continue;
+    }
+    char *end;
+    auto hash = flatbuffers::StringToUInt(line.c_str() + kind_end + 1, &end);
+    if (*end != ' ') return false;
+    std::string path(end + 1);
+    if (kind == "schema") {
+      entry = &(*cache)[path];
+      entry->key = hash;
+      entry->deps.clear();
+      entry->outputs.clear();
+    } else if (kind == "dep" && entry) {
+      entry->deps.push_back(std::make_pair(path, hash));
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool FlatCompiler::SaveCache(const std::string &filename, const Cache &cache) {
+  std::string contents = kCacheHeader;
+  contents += "\n";
+  for (auto it = cache.begin(); it != cache.end(); ++it) {
+    auto &entry = it->second;
+    contents += "schema " + flatbuffers::NumToString(entry.key) + " " +
+                it->first + "\n";
+    for (auto dep = entry.deps.begin(); dep != entry.deps.end(); ++dep) {
+      contents += "dep " + flatbuffers::NumToString(dep->second) + " " +
+                  dep->first + "\n";
+    }
+    for (auto out = entry.outputs.begin(); out != entry.outputs.end(); ++out)
+      contents += "out " + *out + "\n";
+  }
+  // Write a new file and rename it, so an interrupted flatc can't leave a
+  // truncated cache behind.
+  auto tmp = filename + ".tmp";
+  if (!flatbuffers::SaveFile(tmp.c_str(), contents, false)) return false;
+  #ifdef _WIN32
+    remove(filename.c_str());
+  #endif
+  return rename(tmp.c_str(), filename.c_str()) == 0;
+}
+
+static bool HashFile(const std::string &filename, uint64_t *hash) {
+  std::string contents;
+  if (!flatbuffers::LoadFile(filename.c_str(), true, &contents)) return false;
+  *hash = flatbuffers::HashBuffer64(contents.c_str(), contents.size());
+  return true;
+}
+
+bool FlatCompiler::IsUpToDate(const CacheEntry &entry, uint64_t key) {
+  if (entry.key != key) return false;
+  for (auto it = entry.deps.begin(); it != entry.deps.end(); ++it) {
+    uint64_t hash;
+    if (!HashFile(it->first, &hash) || hash != it->second) return false;
+  }
+  for (auto it = entry.outputs.begin(); it != entry.outputs.end(); ++it) {
+    if (!flatbuffers::FileExists(it->c_str())) return false;
+  }
+  return true;
+}
+
+// Without FLATBUFFERS_HAS_THREADS, --jobs is ignored and everything below
+// runs on the calling thread, with nothing to synchronize.
+#if FLATBUFFERS_HAS_THREADS
+  typedef std::atomic<size_t> AtomicSize;
+  typedef std::atomic<bool> AtomicBool;
+  typedef std::mutex Mutex;
+  typedef std::lock_guard<std::mutex> Lock;
+#else
+  typedef size_t AtomicSize;
+  typedef bool AtomicBool;
+  typedef int Mutex;
+  struct Lock { explicit Lock(Mutex &) {} };
+#endif
+
+// Calls worker() on jobs threads at once (one of them the calling thread),
+// and returns once all of them have returned.
+template<typename F> void RunOnThreads(size_t jobs, F worker) {
+  #if FLATBUFFERS_HAS_THREADS
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < jobs; i++) threads.push_back(std::thread(worker));
+    worker();
+    for (auto it = threads.begin(); it != threads.end(); ++it) it->join();
+  #else
+    (void)jobs;
+    worker();
+  #endif
+}
+
+// Seconds since some fixed point in time.
+static double WallSeconds() {
+  #if FLATBUFFERS_HAS_THREADS
+    return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+  #else
+    return static_cast<double>(clock()) / CLOCKS_PER_SEC;
+  #endif
+}
+
+// Saves files on a thread of its own, so the threads converting a --batch
+// don't wait for each file to be written before starting on the next.
+// Write() blocks while more than kMaxQueued bytes are waiting to be written.
+// Without threads, Write() saves the file right away.
+class BatchWriter {
+ public:
+  #if FLATBUFFERS_HAS_THREADS
+  BatchWriter() : queued_(0), done_(false), thread_(&BatchWriter::Run, this) {}
+  #else
+  BatchWriter() {}
+  #endif
+  ~BatchWriter() { Finish(); }
+
+  #if FLATBUFFERS_HAS_THREADS
+  void Write(std::string &filename, std::string &contents) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    space_.wait(lock, [&]() { return queued_ < kMaxQueued; });
+    queued_ += contents.size();
+    queue_.push_back(std::make_pair(std::string(), std::string()));
+    queue_.back().first.swap(filename);
+    queue_.back().second.swap(contents);
+    ready_.notify_one();
+  }
+  #else
+  void Write(std::string &filename, std::string &contents) {
+    if (!flatbuffers::SaveFile(filename.c_str(), contents, true))
+      failed_.push_back(filename);
+  }
+  #endif
+
+  // Waits for all files to be written, and returns those that couldn't be.
+  const std::vector<std::string> &Finish() {
+    #if FLATBUFFERS_HAS_THREADS
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+    }
+    ready_.notify_one();
+    if (thread_.joinable()) thread_.join();
+    #endif
+    return failed_;
+  }
+
+ private:
+  #if FLATBUFFERS_HAS_THREADS
+  static const size_t kMaxQueued = 64 * 1024 * 1024;
+
+  void Run() {
+    for (;;) {
+      std::pair<std::string, std::string> file;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [&]() { return !queue_.empty() || done_; });
+        if (queue_.empty()) return;
+        file.first.swap(queue_.front().first);
+        file.second.swap(queue_.front().second);
+        queue_.pop_front();
+      }
+      auto ok = flatbuffers::SaveFile(file.first.c_str(), file.second, true);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued_ -= file.second.size();
+        if (!ok) failed_.push_back(file.first);
+      }
+      space_.notify_all();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable ready_;  // Signaled when a file is queued.
+  std::condition_variable space_;  // Signaled when a file was written.
+  std::deque<std::pair<std::string, std::string>> queue_;
+  size_t queued_;
+  bool done_;
+  std::vector<std::string> failed_;
+  std::thread thread_;  // Last, it uses all of the above.
+  #else
+  std::vector<std::string> failed_;
+  #endif
+};
+
 std::string FlatCompiler::GetUsageString(const char* program_name) const {
   std::stringstream ss;
   ss << "Usageaa: " << program_name << " [OPTION]... FILE... [-- FILE...]\n";
@@ -81,6 +305,10 @@ std::string FlatCompiler::GetUsageString(const char* program_name) const {
       "  --no-includes      Don\'t generate include statements for included\n"
       "                     schemas the generated file depends on (C++).\n"
       "  --gen-mutable      Generate accessors that can mutate buffers in-place.\n"
+      "  --gen-checked-accessors\n"
+      "                     Generate accessors that bounds-check on access (C++).\n"
+      "  --gen-json-parser  Generate functions that parse JSON straight into a\n"
+      "                     FlatBufferBuilder (C++).\n"
       "  --gen-onefile      Generate single output file for C#.\n"
       "  --gen-name-strings Generate type name functions for C++.\n"
       "  --escape-proto-ids Disable appending '_' in namespaces names.\n"
@@ -99,6 +327,15 @@ std::string FlatCompiler::GetUsageString(const char* program_name) const {
       "    PATH             \n"
       "  --include-prefix   Prefix this path to any generated include statements.\n"
       "    PATH\n"
+      "  --jobs N           Compile up to N schemas, each with the files that\n"
+      "                     follow it, in parallel (0: one per CPU).\n"
+      "  --cache FILE       Remember the inputs of each schema in FILE, and\n"
+      "                     skip schemas that haven't changed, leaving their\n"
+      "                     outputs untouched.\n"
+      "  --batch            Convert the JSON and binary files following each\n"
+      "                     schema on --jobs threads, and print throughput.\n"
+      "  --stream           Binary files are streams of size prefixed buffers,\n"
+      "                     JSON files have an object per line (NDJSON).\n"
       "FILEs may be schemas, or JSON files (conforming to preceding schema)\n"
       "FILEs after the -- must be binary flatbuffer format files.\n"
       "Output files are named using the base file name of the input,\n"
@@ -126,13 +363,41 @@ int FlatCompiler::Compile(int argc, const char** argv) {
   std::vector<bool> generator_enabled(params_.num_generators, false);
   size_t binary_files_from = std::numeric_limits<size_t>::max();
   std::string conform_to_schema;
+  size_t jobs = 1;
+  bool batch = false;
+  bool stream = false;
+  std::string cache_file;
+  // Everything that affects the output of a schema, besides its contents.
+  std::string cache_key = FLATC_VERSION "\n";
 
   for (int argi = 0; argi < argc; argi++) {
     std::string arg = argv[argi];
     if (arg[0] == '-') {
       if (filenames.size() && arg[1] != '-')
         Error("invalid option location: " + arg, true);
-      if (arg == "-o") {
+      auto first_argi = argi;
+      if (arg == "--jobs") {
+        if (++argi >= argc) Error("missing number following: " + arg, true);
+        char *end;
+        jobs = static_cast<size_t>(flatbuffers::StringToUInt(argv[argi], &end));
+        if (*end || end == argv[argi])
+          Error("invalid number following: " + arg, true);
+        #if FLATBUFFERS_HAS_THREADS
+          if (!jobs) jobs = std::max(std::thread::hardware_concurrency(), 1u);
+        #else
+          jobs = 1;
+        #endif
+        continue;
+      } else if (arg == "--batch") {
+        batch = true;
+        continue;
+      } else if (arg == "--stream") {
+        stream = true;
+      } else if (arg == "--cache") {
+        if (++argi >= argc) Error("missing path following: " + arg, true);
+        cache_file = argv[argi];
+        continue;
+      } else if (arg == "-o") {
         if (++argi >= argc) Error("missing path following: " + arg, true);
         output_path = flatbuffers::ConCatPathFileName(argv[argi], "");
       } else if(arg == "-I") {
@@ -170,6 +435,10 @@ int FlatCompiler::Compile(int argc, const char** argv) {
         opts.union_value_namespacing = false;
       } else if(arg == "--gen-mutable") {
         opts.mutable_buffer = true;
+      } else if(arg == "--gen-checked-accessors") {
+        opts.generate_checked_accessors = true;
+      } else if(arg == "--gen-json-parser") {
+        opts.generate_json_parser = true;
       } else if(arg == "--gen-name-strings") {
         opts.generate_name_strings = true;
       } else if(arg == "--gen-object-api") {
@@ -218,6 +487,10 @@ int FlatCompiler::Compile(int argc, const char** argv) {
         Error("unknown commandline argument: " + arg, true);
         found:;
       }
+      for (; first_argi <= argi; first_argi++) {
+        cache_key += argv[first_argi];
+        cache_key += "\n";
+      }
     } else {
       filenames.push_back(argv[argi]);
     }
@@ -232,67 +505,384 @@ int FlatCompiler::Compile(int argc, const char** argv) {
     Error("no options: specify at least one generator.", true);
   }
 
+  if (batch || stream) {
+    auto data_only = !print_make_rules && !schema_binary && !opts.proto_mode;
+    for (size_t i = 0; i < params_.num_generators; ++i) {
+      if (generator_enabled[i] &&
+          params_.generators[i].lang != flatbuffers::IDLOptions::kJson &&
+          params_.generators[i].lang != flatbuffers::IDLOptions::kBinary)
+        data_only = false;
+    }
+    if (!data_only)
+      Error(std::string(batch ? "--batch" : "--stream") + " only converts "
+            "data: use it with --json and/or --binary", true);
+    if (batch && stream) Error("--batch can't be used with --stream", true);
+  }
+
   flatbuffers::Parser conform_parser;
   if (!conform_to_schema.empty()) {
     std::string contents;
     if (!flatbuffers::LoadFile(conform_to_schema.c_str(), true, &contents))
       Error("unable to load schema: " + conform_to_schema);
-    ParseFile(conform_parser, conform_to_schema, contents,
-              conform_include_directories);
+    if (!ParseFile(conform_parser, conform_to_schema, contents,
+                   conform_include_directories))
+      Error(conform_parser.error_, false, false);
+    cache_key += contents;
+    cache_key += "\n";
+  }
+
+  Cache cache;
+  if (!cache_file.empty() && flatbuffers::FileExists(cache_file.c_str()) &&
+      !LoadCache(cache_file, &cache)) {
+    Warn("ignoring unreadable cache: " + cache_file);
+    cache.clear();
+  }
+
+  // Every schema starts from scratch: if it depends on previous schemas it
+  // must do so explicitly using an include. This splits the inputs into
+  // independent runs, each a schema and the files that follow it, which are
+  // compiled against it.
+  std::vector<size_t> runs;
+  for (size_t i = 0; i < filenames.size(); i++) {
+    if (!i || (i < binary_files_from &&
+               flatbuffers::GetExtension(filenames[i]) == "fbs")) {
+      runs.push_back(i);
+    }
   }
+  runs.push_back(filenames.size());
 
-  std::unique_ptr<flatbuffers::Parser> parser(new flatbuffers::Parser(opts));
+  // Binary inputs are converted to text straight from the mapped file, all
+  // other generators (and make rules) need a copy in the builder.
+  bool binary_to_text_only = !print_make_rules;
+  for (size_t i = 0; i < params_.num_generators; ++i) {
+    if (generator_enabled[i] &&
+        params_.generators[i].lang != flatbuffers::IDLOptions::kJson)
+      binary_to_text_only = false;
+  }
 
-  for (auto file_it = filenames.begin();
-            file_it != filenames.end();
-          ++file_it) {
+  // Schemas often include the same files, share those between runs.
+  flatbuffers::ParsedSchemaCache schema_cache;
+
+  // Generally reading binaries that do not correspond to the schema will
+  // crash, and sadly there's no way around that when the binary does not
+  // contain a file identifier.
+  // We'd expect that typically any binary used as a file would have such an
+  // identifier, so by default we require them to match.
+  auto check_identifier = [&](const flatbuffers::Parser &parser,
+                              const std::string &filename,
+                              const void *binary, size_t size)
+                              -> std::string {
+    if (raw_binary) return "";
+    if (!parser.file_identifier_.length()) {
+      return "current schema has no file_identifier: cannot test if \"" +
+             filename + "\" matches the schema, use --raw-binary to read "
+             "this file anyway.";
+    }
+    if (size < sizeof(flatbuffers::uoffset_t) +
+          flatbuffers::FlatBufferBuilder::kFileIdentifierLength ||
+        !flatbuffers::BufferHasIdentifier(binary,
+                                          parser.file_identifier_.c_str())) {
+      return "binary \"" + filename +
+             "\" does not have expected file_identifier \"" +
+             parser.file_identifier_ +
+             "\", use --raw-binary to read this file anyway.";
+    }
+    return "";
+  };
+
+  // With --stream, data files hold any number of FlatBuffers, which are
+  // converted one at a time: binary files are streams of size prefixed
+  // buffers, and JSON files have one per line. --json writes the text of
+  // each on a line of its own, --binary writes a stream.
+  auto convert_stream = [&](flatbuffers::Parser &parser,
+                            const std::string &filename,
+                            bool is_binary) -> std::string {
+    auto in = fopen(filename.c_str(), is_binary ? "rb" : "r");
+    if (!in) return "unable to load file: " + filename;
+    auto filebase = flatbuffers::StripPath(
+                      flatbuffers::StripExtension(filename));
+    std::vector<std::pair<FILE *, size_t>> outs;  // File, generator.
+    std::vector<std::string> out_names;
+    std::string err;
+    flatbuffers::EnsureDirExists(output_path);
+    for (size_t g = 0; g < params_.num_generators && err.empty(); ++g) {
+      if (!generator_enabled[g]) continue;
+      auto name = params_.generators[g].lang == flatbuffers::IDLOptions::kJson
+        ? flatbuffers::TextFileName(output_path, filebase)
+        : flatbuffers::BinaryFileName(parser, output_path, filebase);
+      auto out = fopen(name.c_str(), "wb");
+      if (!out) {
+        err = "unable to write file: " + name;
+      } else {
+        outs.push_back(std::make_pair(out, g));
+        out_names.push_back(name);
+      }
+    }
+    auto write = [&](size_t out, const void *data, size_t size) {
+      if (fwrite(data, 1, size, outs[out].first) == size) return true;
+      err = "unable to write file: " + out_names[out];
+      return false;
+    };
+    if (err.empty() && is_binary) {
+      // One pass over the stream per output: the text of the buffers comes
+      // from GenerateTextStream(), binary outputs get them as they are.
+      if (!raw_binary && parser.file_identifier_.empty())
+        err = check_identifier(parser, filename, nullptr, 0);
+      for (size_t i = 0; i < outs.size() && err.empty(); i++) {
+        if (i) rewind(in);
+        std::string stream_err;
+        bool ok;
+        if (params_.generators[outs[i].second].lang ==
+            flatbuffers::IDLOptions::kJson) {
+          ok = flatbuffers::GenerateTextStream(parser, in, !raw_binary,
+                 [&](const char *text, size_t len) {
+            return write(i, text, len);
+          }, &stream_err);
+        } else {
+          uint64_t offset = 0;
+          ok = flatbuffers::ReadSizePrefixedStream(in,
+                 [&](const uint8_t *buf, size_t len) {
+            err = check_identifier(parser, filename,
+                                   buf + sizeof(flatbuffers::uoffset_t),
+                                   len - sizeof(flatbuffers::uoffset_t));
+            if (!err.empty()) {
+              err = "buffer at offset " + flatbuffers::NumToString(offset) +
+                    ": " + err;
+              return false;
+            }
+            offset += len;
+            return write(i, buf, len);
+          }, &stream_err);
+        }
+        if (!ok && err.empty())  // Otherwise writing failed.
+          err = "binary \"" + filename + "\": " + stream_err;
+      }
+    } else if (err.empty()) {
+      auto line_opts = parser.opts;
+      line_opts.indent_step = -1;
+      flatbuffers::TextGenerator text(parser, line_opts);
+      std::string line;
+      auto convert = [&](const uint8_t *buf, size_t len) {
+        for (size_t i = 0; i < outs.size(); i++) {
+          if (params_.generators[outs[i].second].lang ==
+              flatbuffers::IDLOptions::kJson) {
+            line.clear();
+            if (!text.Generate(buf + sizeof(flatbuffers::uoffset_t), &line)) {
+              err = "Unable to generate text for " + filebase;
+              return false;
+            }
+            line += '\n';
+            if (!write(i, line.c_str(), line.size())) return false;
+          } else if (!write(i, buf, len)) {
+            return false;
+          }
+        }
+        return true;
+      };
+      if (!parser.ParseJsonStream(in, convert, filename.c_str()) &&
+          err.empty()) {  // Otherwise convert() failed.
+        err = parser.error_;
+      }
+    }
+    fclose(in);
+    for (size_t i = 0; i < outs.size(); i++) {
+      if (fclose(outs[i].first) && err.empty())
+        err = "unable to write file: " + out_names[i];
+    }
+    // Don't leave truncated files behind.
+    if (!err.empty()) {
+      for (auto it = out_names.begin(); it != out_names.end(); ++it)
+        remove(it->c_str());
+    }
+    return err;
+  };
+
+  // With --batch, the data files following a schema are spread over jobs
+  // threads, each converting them with a Parser of its own, and their
+  // outputs are saved by a BatchWriter.
+  size_t batch_files = 0;
+  uint64_t batch_bytes_in = 0;
+  uint64_t batch_bytes_out = 0;
+  double batch_seconds = 0;
+  size_t batch_threads = 0;  // The most used for any one schema.
+  auto convert_batch = [&](const flatbuffers::Parser &schema, size_t first,
+                           size_t last, RunResult *result) {
+    auto start = WallSeconds();
+    BatchWriter writer;
+    Mutex mutex;
+    AtomicSize next_file(first);
+    // Report the first file that failed, as converting them in order would:
+    // files after it are skipped, but those before it are still converted,
+    // and may fail first.
+    AtomicSize failed_file(last);
+    auto fail = [&](size_t i, const std::string &err, bool usage,
+                    bool show_exe_name) {
+      Lock lock(mutex);
+      if (i < failed_file) {
+        failed_file = i;
+        result->error = err;
+        result->usage = usage;
+        result->show_exe_name = show_exe_name;
+      }
+    };
+    auto convert = [&]() {
+      flatbuffers::Parser parser(opts, &schema_cache);
+      if (!parser.ImportDefinitions(schema))
+        return fail(first, "unable to copy the schema's definitions", false,
+                    true);
+      flatbuffers::TextGenerator text(parser);
+      auto includes = include_directories;
       std::string contents;
-      if (!flatbuffers::LoadFile(file_it->c_str(), true, &contents))
-        Error("unable to load file: " + *file_it);
+      size_t files = 0;
+      uint64_t bytes_in = 0;
+      uint64_t bytes_out = 0;
+      for (;;) {
+        auto i = next_file++;
+        if (i >= last || i > failed_file) break;
+        auto &filename = filenames[i];
+        flatbuffers::MappedFile binary;
+        const void *flatbuffer;
+        size_t size;
+        if (i >= binary_files_from) {
+          if (!binary.Open(filename.c_str()))
+            return fail(i, "unable to load file: " + filename, true, true);
+          auto err = check_identifier(parser, filename, binary.data(),
+                                      binary.size());
+          if (!err.empty()) return fail(i, err, true, true);
+          flatbuffer = binary.data();
+          size = binary.size();
+          bytes_in += size;
+        } else {
+          if (!flatbuffers::LoadFile(filename.c_str(), true, &contents))
+            return fail(i, "unable to load file: " + filename, true, true);
+          if (contents.length() != strlen(contents.c_str()))
+            return fail(i, "input file appears to be binary: " + filename,
+                        true, true);
+          if (!ParseFile(parser, filename, contents, includes))
+            return fail(i, parser.error_, false, false);
+          flatbuffer = parser.builder_.GetBufferPointer();
+          size = parser.builder_.GetSize();
+          bytes_in += contents.size();
+        }
+        files++;
+        if (!size) continue;
+        auto filebase = flatbuffers::StripPath(
+                          flatbuffers::StripExtension(filename));
+        for (size_t g = 0; g < params_.num_generators; ++g) {
+          if (!generator_enabled[g]) continue;
+          std::string output_file;
+          std::string output;
+          if (params_.generators[g].lang == flatbuffers::IDLOptions::kBinary) {
+            output_file = flatbuffers::BinaryFileName(parser, output_path,
+                                                      filebase);
+            output.assign(static_cast<const char *>(flatbuffer), size);
+          } else {
+            if (!parser.root_struct_def_) continue;
+            output_file = flatbuffers::TextFileName(output_path, filebase);
+            if (size < sizeof(flatbuffers::uoffset_t) ||
+                !text.Generate(flatbuffer, &output))
+              return fail(i, "Unable to generate text for " + filebase, true,
+                          true);
+          }
+          bytes_out += output.size();
+          writer.Write(output_file, output);
+        }
+      }
+      Lock lock(mutex);
+      batch_files += files;
+      batch_bytes_in += bytes_in;
+      batch_bytes_out += bytes_out;
+    };
+    flatbuffers::EnsureDirExists(output_path);
+    auto threads = std::min(jobs, last - first);
+    batch_threads = std::max(batch_threads, threads);
+    RunOnThreads(threads, convert);
+    auto &unwritten = writer.Finish();
+    if (failed_file == last && !unwritten.empty()) {
+      failed_file = first;
+      result->error = "unable to write file: " + unwritten.front();
+      result->usage = false;
+    }
+    result->failed = failed_file < last;
+    batch_seconds += WallSeconds() - start;
+  };
 
+  auto compile_run = [&](size_t run, RunResult *result) {
+    auto fail = [&](const std::string &err, bool usage, bool show_exe_name) {
+      result->failed = true;
+      result->error = err;
+      result->usage = usage;
+      result->show_exe_name = show_exe_name;
+    };
+    auto includes = include_directories;
+    std::unique_ptr<flatbuffers::Parser> parser(
+      new flatbuffers::Parser(opts, &schema_cache));
+
+    // With --batch, only the schema is compiled here, the files following it
+    // are converted by convert_batch.
+    auto batch_from = runs[run + 1];
+    if (batch) {
+      batch_from = runs[run];
+      if (batch_from < binary_files_from &&
+          flatbuffers::GetExtension(filenames[batch_from]) == "fbs")
+        batch_from++;
+    }
+    for (auto file_it = filenames.begin() + runs[run];
+              file_it != filenames.begin() + batch_from;
+            ++file_it) {
       bool is_binary = static_cast<size_t>(file_it - filenames.begin()) >=
                        binary_files_from;
+      if (stream && (is_binary ||
+                     flatbuffers::GetExtension(*file_it) != "fbs")) {
+        auto err = convert_stream(*parser.get(), *file_it, is_binary);
+        if (!err.empty()) return fail(err, false, true);
+        continue;
+      }
+      std::string contents;
+      flatbuffers::MappedFile binary;
+      if (!(is_binary ? binary.Open(file_it->c_str())
+                      : flatbuffers::LoadFile(file_it->c_str(), true,
+                                              &contents)))
+        return fail("unable to load file: " + *file_it, true, true);
+      auto is_schema = !is_binary &&
+                       flatbuffers::GetExtension(*file_it) == "fbs";
+      // Only a schema on its own can be cached: the files following it
+      // need its parser.
+      result->cacheable = !cache_file.empty() && is_schema &&
+                          runs[run + 1] - runs[run] == 1 &&
+                          !print_make_rules && !opts.proto_mode;
+      auto &entry = result->cache_entry;
+      if (result->cacheable) {
+        entry.key = flatbuffers::HashBuffer64((cache_key + contents).c_str(),
+                                              cache_key.size() +
+                                              contents.size());
+        auto cached = cache.find(*file_it);
+        if (cached != cache.end() && IsUpToDate(cached->second, entry.key)) {
+          result->cacheable = false;  // Already there.
+          return;
+        }
+      }
       if (is_binary) {
         parser->builder_.Clear();
-        parser->builder_.PushFlatBuffer(
-          reinterpret_cast<const uint8_t *>(contents.c_str()),
-          contents.length());
-        if (!raw_binary) {
-          // Generally reading binaries that do not correspond to the schema
-          // will crash, and sadly there's no way around that when the binary
-          // does not contain a file identifier.
-          // We'd expect that typically any binary used as a file would have
-          // such an identifier, so by default we require them to match.
-          if (!parser->file_identifier_.length()) {
-            Error("current schema has no file_identifier: cannot test if \"" +
-                 *file_it +
-                 "\" matches the schema, use --raw-binary to read this file"
-                 " anyway.");
-          } else if (!flatbuffers::BufferHasIdentifier(contents.c_str(),
-                         parser->file_identifier_.c_str())) {
-            Error("binary \"" +
-                 *file_it +
-                 "\" does not have expected file_identifier \"" +
-                 parser->file_identifier_ +
-                 "\", use --raw-binary to read this file anyway.");
-          }
+        if (!binary_to_text_only) {
+          parser->builder_.PushFlatBuffer(
+            reinterpret_cast<const uint8_t *>(binary.data()), binary.size());
         }
+        auto err = check_identifier(*parser.get(), *file_it, binary.data(),
+                                    binary.size());
+        if (!err.empty()) return fail(err, true, true);
       } else {
         // Check if file contains 0 bytes.
         if (contents.length() != strlen(contents.c_str())) {
-          Error("input file appears to be binary: " + *file_it, true);
-        }
-        auto is_schema = flatbuffers::GetExtension(*file_it) == "fbs";
-        if (is_schema) {
-          // If we're processing multiple schemas, make sure to start each
-          // one from scratch. If it depends on previous schemas it must do
-          // so explicitly using an include.
-          parser.reset(new flatbuffers::Parser(opts));
+          return fail("input file appears to be binary: " + *file_it, true,
+                      true);
         }
-        ParseFile(*parser.get(), *file_it, contents, include_directories);
+        if (!ParseFile(*parser.get(), *file_it, contents, includes))
+          return fail(parser->error_, false, false);
         if (is_schema && !conform_to_schema.empty()) {
           auto err = parser->ConformTo(conform_parser);
-          if (!err.empty()) Error("schemas don\'t conform: " + err);
+          if (!err.empty())
+            return fail("schemas don\'t conform: " + err, true, true);
         }
         if (schema_binary) {
           parser->Serialize();
@@ -308,29 +898,51 @@ int FlatCompiler::Compile(int argc, const char** argv) {
         if (generator_enabled[i]) {
           if (!print_make_rules) {
             flatbuffers::EnsureDirExists(output_path);
-            if (!params_.generators[i].generate(*parser.get(), output_path, filebase)) {
-              Error(std::string("Unable to generate ") +
-                    params_.generators[i].lang_name +
-                    " for " +
-                    filebase);
+            auto generated = is_binary && binary_to_text_only
+              ? flatbuffers::GenerateTextFile(*parser.get(), output_path,
+                                              filebase, binary.data(),
+                                              binary.size())
+              : params_.generators[i].generate(*parser.get(), output_path,
+                                               filebase);
+            if (!generated) {
+              return fail(std::string("Unable to generate ") +
+                          params_.generators[i].lang_name +
+                          " for " +
+                          filebase, true, true);
             }
           } else {
             std::string make_rule = params_.generators[i].make_rule(
                 *parser.get(), output_path, *file_it);
             if (!make_rule.empty())
-              printf("%s\n", flatbuffers::WordWrap(
-                  make_rule, 80, " ", " \\").c_str());
+              result->make_rules += flatbuffers::WordWrap(
+                  make_rule, 80, " ", " \\") + "\n";
           }
           if (grpc_enabled) {
             if (params_.generators[i].generateGRPC != nullptr) {
               if (!params_.generators[i].generateGRPC(*parser.get(), output_path,
                                               filebase)) {
-                Error(std::string("Unable to generate GRPC interface for") +
-                      params_.generators[i].lang_name);
+                return fail(
+                  std::string("Unable to generate GRPC interface for") +
+                  params_.generators[i].lang_name, true, true);
               }
             } else {
-              Warn(std::string("GRPC interface generator not implemented for ")
-                   + params_.generators[i].lang_name);
+              result->warnings.push_back(
+                std::string("GRPC interface generator not implemented for ") +
+                params_.generators[i].lang_name);
+            }
+          }
+          if (result->cacheable) {
+            // The outputs are the targets of the generator's make rule.
+            // Some of these may name types from included files, which
+            // aren't generated here.
+            auto make_rule = params_.generators[i].make_rule(
+                *parser.get(), output_path, *file_it);
+            auto targets = make_rule.substr(0, make_rule.find(": "));
+            std::stringstream ss(targets);
+            std::string output;
+            while (ss >> output) {
+              if (flatbuffers::FileExists(output.c_str()))
+                entry.outputs.push_back(output);
             }
           }
         }
@@ -338,11 +950,68 @@ int FlatCompiler::Compile(int argc, const char** argv) {
 
       if (opts.proto_mode) GenerateFBS(*parser.get(), output_path, filebase);
 
+      if (result->cacheable) {
+        auto deps = parser->GetIncludedFilesRecursive(*file_it);
+        for (auto it = deps.begin(); it != deps.end(); ++it) {
+          uint64_t hash;
+          if (!HashFile(*it, &hash)) {
+            result->cacheable = false;
+            break;
+          }
+          entry.deps.push_back(std::make_pair(*it, hash));
+        }
+      }
+
       // We do not want to generate code for the definitions in this file
       // in any files coming up next.
       parser->MarkGenerated();
+    }
+    if (batch_from < runs[run + 1])
+      convert_batch(*parser.get(), batch_from, runs[run + 1], result);
+  };
+
+  // With --gen-all, schemas including the same file would write the same
+  // outputs, so those can't be compiled at the same time. With --batch, the
+  // threads convert the files of one schema at a time instead.
+  auto run_jobs = opts.generate_all || batch ? 1 : jobs;
+  std::vector<RunResult> results(runs.size() - 1);
+  AtomicSize next_run(0);
+  AtomicBool failed(false);
+  auto worker = [&]() {
+    for (;;) {
+      auto run = next_run++;
+      if (run >= results.size() || failed) break;
+      compile_run(run, &results[run]);
+      if (results[run].failed) failed = true;
+    }
+  };
+  RunOnThreads(std::min(run_jobs, results.size()), worker);
+
+  if (!cache_file.empty()) {
+    for (size_t run = 0; run < results.size(); run++) {
+      if (results[run].cacheable && !results[run].failed)
+        cache[filenames[runs[run]]] = results[run].cache_entry;
+    }
+    if (!SaveCache(cache_file, cache))
+      Warn("unable to write cache: " + cache_file);
+  }
+
+  int status = 0;
+  for (auto it = results.begin(); it != results.end(); ++it) {
+    Report(*it);
+    if (it->failed) status = 1;
+  }
+  if (batch && !status) {
+    printf("converted %s files (%s bytes) to %s bytes in %.3f s "
+           "on %s threads: %.0f files/s, %.1f MB/s\n",
+           flatbuffers::NumToString(batch_files).c_str(),
+           flatbuffers::NumToString(batch_bytes_in).c_str(),
+           flatbuffers::NumToString(batch_bytes_out).c_str(), batch_seconds,
+           flatbuffers::NumToString(batch_threads).c_str(),
+           batch_seconds > 0 ? batch_files / batch_seconds : 0,
+           batch_seconds > 0 ? batch_bytes_in / batch_seconds / 1e6 : 0);
   }
-  return 0;
+  return status;
 }
 
 }  // namespace flatbuffers
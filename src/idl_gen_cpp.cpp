@@ -18,6 +18,7 @@
 
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/idl.h"
+#include "flatbuffers/json_reader.h"
 #include "flatbuffers/util.h"
 #include "flatbuffers/code_generators.h"
 
@@ -92,6 +93,9 @@ class CppGenerator : public BaseGenerator {
     code_ += "";
 
     code_ += "#include \"flatbuffers/flatbuffers.h\"";
+    if (parser_.opts.generate_json_parser) {
+      code_ += "#include \"flatbuffers/json_reader.h\"";
+    }
     code_ += "";
 
     if (parser_.opts.include_dependence_headers) {
@@ -161,6 +165,29 @@ class CppGenerator : public BaseGenerator {
       }
     }
 
+    // Generate the JSON parse functions, declared up front as types may refer
+    // to each other in any order.
+    if (parser_.opts.generate_json_parser) {
+      for (int decl = 1; decl >= 0; decl--) {
+        for (auto it = parser_.enums_.vec.begin();
+             it != parser_.enums_.vec.end(); ++it) {
+          const auto &enum_def = **it;
+          if (!enum_def.generated) {
+            SetNameSpace(enum_def.defined_namespace);
+            GenEnumJsonParser(enum_def, decl != 0);
+          }
+        }
+        for (auto it = parser_.structs_.vec.begin();
+             it != parser_.structs_.vec.end(); ++it) {
+          const auto &struct_def = **it;
+          if (!struct_def.generated) {
+            SetNameSpace(struct_def.defined_namespace);
+            GenJsonParser(struct_def, decl != 0);
+          }
+        }
+      }
+    }
+
     // Generate convenient global helper functions:
     if (parser_.root_struct_def_) {
       auto &struct_def = *parser_.root_struct_def_;
@@ -217,6 +244,16 @@ class CppGenerator : public BaseGenerator {
       code_ += "}";
       code_ += "";
 
+      if (parser_.opts.generate_checked_accessors) {
+        // The root accessor for checked accessors, returns nullptr if the root
+        // table isn't within the buffer.
+        code_ += "inline const {{CPP_NAME}} *Get{{STRUCT_NAME}}(";
+        code_ += "    flatbuffers::AccessChecker &_checker) {";
+        code_ += "  return _checker.GetRoot<{{CPP_NAME}}>({{ID}});";
+        code_ += "}";
+        code_ += "";
+      }
+
       if (parser_.file_extension_.length()) {
         // Return the extension
         code_ += "inline const char *{{STRUCT_NAME}}Extension() {";
@@ -253,6 +290,25 @@ class CppGenerator : public BaseGenerator {
         code_ += "}";
         code_ += "";
       }
+
+      if (parser_.opts.generate_json_parser) {
+        // Parse JSON straight into a finished buffer.
+        code_ += "inline bool Parse{{STRUCT_NAME}}FromJson(";
+        code_ += "    const char *json, size_t len,";
+        code_ += "    flatbuffers::FlatBufferBuilder &fbb,";
+        code_ += "    std::string *error = nullptr) {";
+        code_ += "  flatbuffers::JsonReader reader(json, len);";
+        code_ += "  flatbuffers::Offset<{{CPP_NAME}}> root;";
+        code_ += "  if (!ParseFromJson(reader, fbb, &root) || "
+                 "!reader.AtEnd()) {";
+        code_ += "    if (error) *error = reader.error();";
+        code_ += "    return false;";
+        code_ += "  }";
+        code_ += "  Finish{{STRUCT_NAME}}Buffer(fbb, root);";
+        code_ += "  return true;";
+        code_ += "}";
+        code_ += "";
+      }
     }
 
     assert(cur_name_space_);
@@ -426,6 +482,19 @@ class CppGenerator : public BaseGenerator {
     }
   }
 
+  // The type of the argument of KeyCompareWithValue() for a key field, with
+  // a trailing space for pointers.
+  std::string GenKeyValueType(const FieldDef &field) {
+    if (field.value.type.base_type == BASE_TYPE_STRING) {
+      return "const char *";
+    } else if (parser_.opts.scoped_enums && field.value.type.enum_def &&
+               IsScalar(field.value.type.base_type)) {
+      return GenTypeGet(field.value.type, " ", "const ", " *", true);
+    } else {
+      return GenTypeBasic(field.value.type, false) + " ";
+    }
+  }
+
   std::string GenEnumDecl(const EnumDef &enum_def) const {
     const IDLOptions &opts = parser_.opts;
     return (opts.scoped_enums ? "enum class " : "enum ") + enum_def.name;
@@ -670,6 +739,7 @@ class CppGenerator : public BaseGenerator {
       code_ += "";
       code_ += "  " + UnionUnPackSignature(enum_def, true) + ";";
       code_ += "  " + UnionPackSignature(enum_def, true) + ";";
+      code_ += "  size_t SizeHint() const;";
       code_ += "";
 
       for (auto it = enum_def.vals.vec.begin(); it != enum_def.vals.vec.end();
@@ -789,6 +859,27 @@ class CppGenerator : public BaseGenerator {
       code_ += "}";
       code_ += "";
 
+      code_ += "inline size_t {{ENUM_NAME}}Union::SizeHint() const {";
+      code_ += "  switch (type) {";
+      for (auto it = enum_def.vals.vec.begin(); it != enum_def.vals.vec.end();
+           ++it) {
+        auto &ev = **it;
+        if (!ev.value) {
+          continue;
+        }
+
+        code_.SetValue("LABEL", GetEnumValUse(enum_def, ev));
+        code_.SetValue("TYPE", NativeName(WrapInNameSpace(*ev.struct_def)));
+        code_ += "    case {{LABEL}}: {";
+        code_ += "      auto ptr = reinterpret_cast<const {{TYPE}} *>(table);";
+        code_ += "      return ptr->SizeHint();";
+        code_ += "    }";
+      }
+      code_ += "    default: return 0;";
+      code_ += "  }";
+      code_ += "}";
+      code_ += "";
+
       // Union Reset() function.
       code_.SetValue("NONE",
           GetEnumValUse(enum_def, *enum_def.vals.Lookup("NONE")));
@@ -973,6 +1064,7 @@ class CppGenerator : public BaseGenerator {
       GenMember(**it);
     }
     GenDefaultConstructor(struct_def);
+    code_ += "  size_t SizeHint() const;";
     code_ += "};";
     code_ += "";
   }
@@ -1142,6 +1234,30 @@ class CppGenerator : public BaseGenerator {
         }
       }
 
+      if (parser_.opts.generate_checked_accessors) {
+        // Same as the accessor above, but only reads the field after checking
+        // it is within the buffer, see flatbuffers::AccessChecker.
+        code_.SetValue("OFFSET_NAME", offset_str);
+        code_.SetValue("FIELD_TYPE",
+            GenTypeGet(field.value.type, " ", "const ", " *", true));
+        code_.SetValue("SIZE", GenTypeSize(field.value.type));
+        if (is_scalar) {
+          code_.SetValue("FIELD_VALUE", field.name + "() : " +
+                                        GetDefaultScalarValue(field));
+        } else if (is_struct) {
+          code_.SetValue("FIELD_VALUE", field.name + "() : nullptr");
+        } else {
+          code_.SetValue("FIELD_VALUE",
+                         "_checker.Checked(" + field.name + "()) : nullptr");
+        }
+
+        code_ += "  {{FIELD_TYPE}}{{FIELD_NAME}}("
+                 "flatbuffers::AccessChecker &_checker) const {";
+        code_ += "    return CheckedField<{{SIZE}}>(_checker, {{OFFSET_NAME}})";
+        code_ += "           ? {{FIELD_VALUE}};";
+        code_ += "  }";
+      }
+
       auto nested = field.attributes.Lookup("nested_flatbuffer");
       if (nested) {
         std::string qualified_name =
@@ -1158,6 +1274,29 @@ class CppGenerator : public BaseGenerator {
         code_ += "  }";
       }
 
+      auto hash_index = field.attributes.Lookup("hash_index");
+      if (hash_index) {
+        // Lookup by key through the index in the field named by the
+        // attribute, see Vector::LookupByKeyHashed().
+        auto &elem_def = *field.value.type.struct_def;
+        const FieldDef *key_field = nullptr;
+        for (auto key_it = elem_def.fields.vec.begin();
+             key_it != elem_def.fields.vec.end(); ++key_it) {
+          if ((*key_it)->key) key_field = *key_it;
+        }
+        assert(key_field);  // Guaranteed to exist by parser.
+        code_.SetValue("KEY_TYPE", GenKeyValueType(*key_field));
+        code_.SetValue("ELEM_TYPE", WrapInNameSpace(elem_def));
+        code_.SetValue("INDEX_NAME", hash_index->constant);
+
+        code_ += "  const {{ELEM_TYPE}} *{{FIELD_NAME}}_by_key("
+                 "{{KEY_TYPE}}key) const {";
+        code_ += "    auto vec = {{FIELD_NAME}}();";
+        code_ += "    return vec ? vec->LookupByKeyHashed(key, "
+                 "{{INDEX_NAME}}()) : nullptr;";
+        code_ += "  }";
+      }
+
       // Generate a comparison function for this field if it is a key.
       if (field.key) {
         const bool is_string = (field.value.type.base_type == BASE_TYPE_STRING);
@@ -1174,23 +1313,24 @@ class CppGenerator : public BaseGenerator {
           code_ += "  int KeyCompareWithValue(const char *val) const {";
           code_ += "    return strcmp({{FIELD_NAME}}()->c_str(), val);";
           code_ += "  }";
+          code_ += "  uint32_t KeyHash() const {";
+          code_ += "    return KeyHash({{FIELD_NAME}}()->c_str());";
+          code_ += "  }";
+          code_ += "  static uint32_t KeyHash(const char *val) {";
+          code_ += "    return flatbuffers::HashKey(val);";
+          code_ += "  }";
         } else {
-          auto type = GenTypeBasic(field.value.type, false);
-          if (parser_.opts.scoped_enums && field.value.type.enum_def &&
-              IsScalar(field.value.type.base_type)) {
-            type = GenTypeGet(field.value.type, " ", "const ", " *", true);
-          }
-
-          code_.SetValue("KEY_TYPE", type);
-          code_ += "  int KeyCompareWithValue({{KEY_TYPE}} val) const {";
+          code_.SetValue("KEY_TYPE", GenKeyValueType(field));
+          code_ += "  int KeyCompareWithValue({{KEY_TYPE}}val) const {";
           code_ += "    const auto key = {{FIELD_NAME}}();";
-          code_ += "    if (key < val) {";
-          code_ += "      return -1;";
-          code_ += "    } else if (key > val) {";
-          code_ += "      return 1;";
-          code_ += "    } else {";
-          code_ += "      return 0;";
-          code_ += "    }";
+          code_ += "    return static_cast<int>(key > val) - "
+                   "static_cast<int>(key < val);";
+          code_ += "  }";
+          code_ += "  uint32_t KeyHash() const {";
+          code_ += "    return KeyHash({{FIELD_NAME}}());";
+          code_ += "  }";
+          code_ += "  static uint32_t KeyHash({{KEY_TYPE}}val) {";
+          code_ += "    return flatbuffers::HashKey(val);";
           code_ += "  }";
         }
       }
@@ -1208,6 +1348,14 @@ class CppGenerator : public BaseGenerator {
       }
       GenVerifyCall(field, " &&\n           ");
     }
+    for (auto it = struct_def.fields.vec.begin();
+         it != struct_def.fields.vec.end(); ++it) {
+      const auto &field = **it;
+      auto hash_index = field.attributes.Lookup("hash_index");
+      if (field.deprecated || !hash_index) continue;
+      code_ += " &&\n           verifier.VerifyKeyHashIndex(" + field.name +
+               "(), " + hash_index->constant + "())\\";
+    }
 
     code_ += " &&\n           verifier.EndTable();";
     code_ += "  }";
@@ -1604,6 +1752,67 @@ class CppGenerator : public BaseGenerator {
     return code;
   }
 
+  // Generate code that adds the size of the out-of-line data of a field of a
+  // native table to _s, of the form:
+  //   _s += field.size() + 8;
+  std::string GenSizeHintStatement(const FieldDef &field) {
+    const auto &name = field.name;
+    switch (field.value.type.base_type) {
+      case BASE_TYPE_STRING: {
+        // The string is 0-terminated.
+        return "_s += " + name + ".size() + " +
+               NumToString(2 * sizeof(uoffset_t)) + ";";
+      }
+      case BASE_TYPE_VECTOR: {
+        const auto vector_type = field.value.type.VectorType();
+        const auto elem_size = NumToString(InlineSize(vector_type));
+        // Length prefix, its padding and the padding of the elements.
+        const auto header = NumToString(2 * sizeof(uoffset_t) - 1 +
+                                        InlineAlignment(vector_type) - 1);
+        std::string code = "_s += " + name + ".size() * " + elem_size +
+                           " + " + header + ";";
+        std::string elem;
+        switch (vector_type.base_type) {
+          case BASE_TYPE_STRING: {
+            elem = name + "[_i].size() + " +
+                   NumToString(2 * sizeof(uoffset_t));
+            break;
+          }
+          case BASE_TYPE_STRUCT: {
+            if (!IsStruct(vector_type)) {
+              elem = name + "[_i]->SizeHint()";
+            }
+            break;
+          }
+          case BASE_TYPE_UNION: {
+            elem = name + "[_i].SizeHint()";
+            break;
+          }
+          default: {
+            break;
+          }
+        }
+        if (!elem.empty()) {
+          code += " for (size_t _i = 0; _i < " + name + ".size(); _i++) { ";
+          code += "_s += " + elem + "; }";
+        }
+        return code;
+      }
+      case BASE_TYPE_UNION: {
+        return "_s += " + name + ".SizeHint();";
+      }
+      case BASE_TYPE_STRUCT: {
+        if (IsStruct(field.value.type)) {
+          return "";
+        }
+        return "if (" + name + ") _s += " + name + "->SizeHint();";
+      }
+      default: {
+        return "";
+      }
+    }
+  }
+
   // Generate code for tables that needs to come after the regular definition.
   void GenTablePost(const StructDef &struct_def) {
     code_.SetValue("STRUCT_NAME", struct_def.name);
@@ -1645,9 +1854,38 @@ class CppGenerator : public BaseGenerator {
       code_ += "}";
       code_ += "";
 
-      // Generate the X::Pack member function that simply calls the global
-      // CreateX function.
+      // Generate the XT::SizeHint() method, which returns an upper bound of
+      // the number of bytes CreateX() will serialize for this object. The
+      // fixed part (table, vtable and worst case padding) is computed here.
+      auto fixed_size = sizeof(soffset_t) + sizeof(soffset_t) - 1 +
+                        sizeof(voffset_t) * (2 + struct_def.fields.vec.size());
+      for (auto it = struct_def.fields.vec.begin();
+           it != struct_def.fields.vec.end(); ++it) {
+        const auto &type = (*it)->value.type;
+        fixed_size += InlineSize(type) + InlineAlignment(type) - 1;
+      }
+      code_.SetValue("FIXED_SIZE", NumToString(fixed_size));
+      code_ += "inline size_t {{NATIVE_NAME}}::SizeHint() const {";
+      code_ += "  size_t _s = {{FIXED_SIZE}};";
+      for (auto it = struct_def.fields.vec.begin();
+           it != struct_def.fields.vec.end(); ++it) {
+        const auto &field = **it;
+        if (field.deprecated) {
+          continue;
+        }
+        const auto statement = GenSizeHintStatement(field);
+        if (!statement.empty()) {
+          code_ += "  " + statement;
+        }
+      }
+      code_ += "  return _s;";
+      code_ += "}";
+      code_ += "";
+
+      // Generate the X::Pack member function that calls the global CreateX
+      // function, with the buffer grown to its final size up front.
       code_ += "inline " + TablePackSignature(struct_def, false) + " {";
+      code_ += "  _fbb.Reserve(_o->SizeHint());";
       code_ += "  return Create{{STRUCT_NAME}}(_fbb, _o, _rehasher);";
       code_ += "}";
       code_ += "";
@@ -1699,9 +1937,506 @@ class CppGenerator : public BaseGenerator {
       code_ += ");";
       code_ += "}";
       code_ += "";
+
+      if (CanBatchTable(struct_def)) {
+        GenBatchedVectorCreate(struct_def);
+      }
     }
   }
 
+  // Whether CreateVectorOfX() can be generated for a table: all its fields
+  // must be scalars, strings or structs stored inline in the native object
+  // (a null struct pointer would mean leaving the field out), such that all
+  // tables written from an array of native objects have the same layout.
+  bool CanBatchTable(const StructDef &struct_def) {
+    bool has_fields = false;
+    for (auto it = struct_def.fields.vec.begin();
+         it != struct_def.fields.vec.end(); ++it) {
+      const auto &field = **it;
+      if (field.deprecated) {
+        continue;
+      }
+      const auto &type = field.value.type;
+      if (field.attributes.Lookup("cpp_type") ||
+          (IsStruct(type) &&
+           (!field.native_inline ||
+            type.struct_def->attributes.Lookup("native_type"))) ||
+          !(IsScalar(type.base_type) || IsStruct(type) ||
+            type.base_type == BASE_TYPE_STRING) ||
+          type.base_type == BASE_TYPE_UTYPE) {
+        return false;
+      }
+      has_fields = true;
+    }
+    return has_fields;
+  }
+
+  // Generate a CreateVectorOfX function that serializes an array of native
+  // objects as a batch of tables sharing a single vtable, see
+  // FlatBufferBuilder::StartTableBatch(). Unlike CreateX(), this always
+  // writes all fields, including those equal to their default.
+  void GenBatchedVectorCreate(const StructDef &struct_def) {
+    size_t alignment = 1;
+    for (auto it = struct_def.fields.vec.begin();
+         it != struct_def.fields.vec.end(); ++it) {
+      if (!(*it)->deprecated) {
+        alignment = std::max(alignment, InlineAlignment((*it)->value.type));
+      }
+    }
+    code_.SetValue("ALIGN", NumToString(alignment));
+    code_.SetValue("NUM_FIELDS", NumToString(struct_def.fields.vec.size()));
+
+    code_ += "inline flatbuffers::Offset<flatbuffers::Vector<"
+             "flatbuffers::Offset<{{STRUCT_NAME}}>>> "
+             "CreateVectorOf{{STRUCT_NAME}}(";
+    code_ += "    flatbuffers::FlatBufferBuilder &_fbb, "
+             "const {{NATIVE_NAME}} *_o, size_t _len) {";
+    code_ += "  std::vector<flatbuffers::Offset<{{STRUCT_NAME}}>> "
+             "_tables(_len);";
+    code_ += "  _fbb.StartTableBatch({{ALIGN}});";
+    code_ += "  for (size_t _i = 0; _i < _len; _i++) {";
+    code_ += "    const auto &_e = _o[_i];";
+    for (auto it = struct_def.fields.vec.begin();
+         it != struct_def.fields.vec.end(); ++it) {
+      const auto &field = **it;
+      if (!field.deprecated &&
+          field.value.type.base_type == BASE_TYPE_STRING) {
+        code_.SetValue("FIELD_NAME", field.name);
+        code_ += "    auto _{{FIELD_NAME}} = "
+                 "_fbb.CreateString(_e.{{FIELD_NAME}});";
+      }
+    }
+    code_ += "    const auto _start = _fbb.StartBatchedTable();";
+    // Add the fields in the same order as CreateX() does.
+    for (size_t size = struct_def.sortbysize ? sizeof(largest_scalar_t) : 1;
+         size; size /= 2) {
+      for (auto it = struct_def.fields.vec.rbegin();
+           it != struct_def.fields.vec.rend(); ++it) {
+        const auto &field = **it;
+        if (field.deprecated || (struct_def.sortbysize &&
+                                 size != SizeOf(field.value.type.base_type))) {
+          continue;
+        }
+        code_.SetValue("FIELD_NAME", field.name);
+        code_.SetValue("OFFSET_NAME",
+                       struct_def.name + "::" + GenFieldOffsetName(field));
+        if (IsScalar(field.value.type.base_type)) {
+          code_.SetValue("FIELD_TYPE",
+                         GenTypeWire(field.value.type, "", false));
+          code_.SetValue("FIELD_VALUE",
+                         GenUnderlyingCast(field, false, "_e." + field.name));
+          code_ += "    _fbb.AddBatchedElement<{{FIELD_TYPE}}>("
+                   "{{OFFSET_NAME}}, {{FIELD_VALUE}});";
+        } else if (IsStruct(field.value.type)) {
+          code_ += "    _fbb.AddBatchedStruct({{OFFSET_NAME}}, "
+                   "_e.{{FIELD_NAME}});";
+        } else {
+          code_ += "    _fbb.AddBatchedOffset({{OFFSET_NAME}}, "
+                   "_{{FIELD_NAME}});";
+        }
+      }
+    }
+    code_ += "    _tables[_i] = flatbuffers::Offset<{{STRUCT_NAME}}>(";
+    code_ += "        _fbb.EndBatchedTable(_start, {{NUM_FIELDS}}));";
+    code_ += "  }";
+    code_ += "  return _fbb.CreateVector(_tables);";
+    code_ += "}";
+    code_ += "";
+
+    code_ += "inline flatbuffers::Offset<flatbuffers::Vector<"
+             "flatbuffers::Offset<{{STRUCT_NAME}}>>> "
+             "CreateVectorOf{{STRUCT_NAME}}(";
+    code_ += "    flatbuffers::FlatBufferBuilder &_fbb, "
+             "const std::vector<{{NATIVE_NAME}}> &_o) {";
+    code_ += "  return CreateVectorOf{{STRUCT_NAME}}(_fbb, _o.data(), "
+             "_o.size());";
+    code_ += "}";
+    code_ += "";
+  }
+
+  // The JSON parse functions (--gen-json-parser) are overloads of
+  // ParseFromJson() that read JSON with a flatbuffers::JsonReader, and so
+  // find each other through ADL whatever namespace they're in. Tables are
+  // built straight into a FlatBufferBuilder, structs and enums are parsed
+  // into their C++ type.
+  std::string JsonParserSignature(const std::string &args) {
+    return "inline bool ParseFromJson(flatbuffers::JsonReader &_r, " + args +
+           ")";
+  }
+
+  std::string JsonTableParserArgs(const std::string &table_name) {
+    return "flatbuffers::FlatBufferBuilder &_fbb, "
+           "flatbuffers::Offset<" + table_name + "> *_o";
+  }
+
+  // For enums, maps value names to values.
+  void GenEnumJsonParser(const EnumDef &enum_def, bool decl) {
+    code_.SetValue("ENUM_NAME", enum_def.name);
+    if (decl) {
+      code_ += JsonParserSignature("{{ENUM_NAME}} *_o") + ";";
+      if (enum_def.is_union) {
+        code_ += JsonParserSignature("flatbuffers::FlatBufferBuilder &_fbb, "
+                                     "{{ENUM_NAME}} _type, "
+                                     "flatbuffers::Offset<void> *_o") + ";";
+      }
+      return;
+    }
+
+    code_ += JsonParserSignature("{{ENUM_NAME}} *_o") + " {";
+
+    code_ += "  static const flatbuffers::JsonReader::EnumValue kValues[] = {";
+    for (auto it = enum_def.vals.vec.begin(); it != enum_def.vals.vec.end();
+         ++it) {
+      const auto &ev = **it;
+      code_ += "    { \"" + ev.name + "\", " + NumToString(ev.value) + " },";
+    }
+    code_ += "  };";
+    code_ += "  int64_t _v;";
+    code_ += "  if (!_r.ParseEnum(kValues, "
+             "sizeof(kValues) / sizeof(kValues[0]), &_v)) {";
+    code_ += "    return false;";
+    code_ += "  }";
+    code_ += "  *_o = static_cast<{{ENUM_NAME}}>(_v);";
+    code_ += "  return true;";
+    code_ += "}";
+    code_ += "";
+    if (!enum_def.is_union) return;
+
+    // For unions, the type was read from the preceding _type field.
+    code_ += JsonParserSignature("flatbuffers::FlatBufferBuilder &_fbb, "
+                                 "{{ENUM_NAME}} _type, "
+                                 "flatbuffers::Offset<void> *_o") + " {";
+    code_ += "  switch (_type) {";
+    for (auto it = enum_def.vals.vec.begin(); it != enum_def.vals.vec.end();
+         ++it) {
+      const auto &ev = **it;
+      if (!ev.value) continue;
+      code_.SetValue("LABEL", GetEnumValUse(enum_def, ev));
+      code_.SetValue("TYPE", WrapInNameSpace(*ev.struct_def));
+      code_ += "    case {{LABEL}}: {";
+      code_ += "      flatbuffers::Offset<{{TYPE}}> _p;";
+      code_ += "      if (!ParseFromJson(_r, _fbb, &_p)) return false;";
+      code_ += "      *_o = _p.Union();";
+      code_ += "      return true;";
+      code_ += "    }";
+    }
+    code_ += "    default:";
+    code_ += "      return _r.Error("
+             "\"missing type field for this union value\");";
+    code_ += "  }";
+    code_ += "}";
+    code_ += "";
+  }
+
+  // Declares a local variable that can hold a value of type, initialized to
+  // zero for scalars.
+  std::string GenJsonLocal(const Type &type, const std::string &name) {
+    if (IsStruct(type)) {
+      return WrapInNameSpace(*type.struct_def) + " " + name + ";";
+    } else if (type.base_type == BASE_TYPE_STRING) {
+      return "std::string " + name + ";";
+    } else if (type.enum_def) {
+      auto enum_type = GenTypeBasic(type, true);
+      return enum_type + " " + name + " = static_cast<" + enum_type + ">(0);";
+    } else if (type.base_type == BASE_TYPE_BOOL) {
+      return "bool " + name + " = false;";
+    } else {
+      return GenTypeBasic(type, true) + " " + name + " = 0;";
+    }
+  }
+
+  // An expression parsing a scalar, string or struct into dest.
+  std::string GenJsonParseValue(const Type &type, const FieldDef &field,
+                                const std::string &dest) {
+    auto hash_name = field.attributes.Lookup("hash");
+    if (IsStruct(type) || (IsScalar(type.base_type) && type.enum_def)) {
+      return "ParseFromJson(_r, &" + dest + ")";
+    } else if (hash_name && IsScalar(type.base_type)) {
+      auto &name = hash_name->constant;
+      auto function = name.compare(0, 5, "fnv1a") ? "HashFnv1" : "HashFnv1a";
+      auto bits = name.compare(name.size() - 2, 2, "64") ? "uint32_t"
+                                                          : "uint64_t";
+      return "_r.ParseHashed(&" + dest + ", flatbuffers::" + function + "<" +
+             bits + ">)";
+    } else {
+      return "_r.Parse(&" + dest + ")";
+    }
+  }
+
+  // The type of the elements of a vector, as passed to CreateVector().
+  std::string GenJsonVectorElement(const Type &vector_type) {
+    return IsStruct(vector_type) ? WrapInNameSpace(*vector_type.struct_def)
+                                 : GenTypeWire(vector_type, "", false);
+  }
+
+  // Whether a field is a vector of the types of a vector of unions. Its
+  // elements are kept until the end of the table, to parse the unions with.
+  static bool IsJsonUnionTypeVector(const FieldDef &field) {
+    return field.value.type.base_type == BASE_TYPE_VECTOR &&
+           field.value.type.element == BASE_TYPE_UTYPE;
+  }
+
+  // Generates the statements that parse the value of a field into a local,
+  // and return whether that succeeded. For tables, strings, vectors and
+  // unions, the value is added to the builder right away, and the local
+  // holds its offset.
+  void GenJsonParseField(const FieldDef &field, bool fixed,
+                         const std::string &indent) {
+    const auto &type = field.value.type;
+    const auto &dest = field.name;
+    code_.SetValue("DEST", dest);
+    if (fixed) {
+      code_ += indent + "return " + GenJsonParseValue(type, field, dest) +
+               ";";
+      return;
+    }
+    if (field.deprecated) {
+      code_ += indent + "return _r.SkipValue();";
+      return;
+    }
+    switch (type.base_type) {
+      case BASE_TYPE_UNION: {
+        code_.SetValue("TYPE_FIELD", field.name + UnionTypeFieldSuffix());
+        // Like Parser, accepts the type field right after the value too.
+        code_ += indent + "if (!_has_{{TYPE_FIELD}} && "
+                 "!_r.PeekNextField(\"{{TYPE_FIELD}}\", [&]() {";
+        code_ += indent + "      return ParseFromJson(_r, &{{TYPE_FIELD}});";
+        code_ += indent + "    })) {";
+        code_ += indent + "  return false;";
+        code_ += indent + "}";
+        code_ += indent +
+                 "return ParseFromJson(_r, _fbb, {{TYPE_FIELD}}, &{{DEST}});";
+        break;
+      }
+      case BASE_TYPE_STRING: {
+        code_ += indent + "if (!_r.Parse(&_str)) return false;";
+        code_ += indent + "{{DEST}} = _fbb.CreateString(_str);";
+        code_ += indent + "return true;";
+        break;
+      }
+      case BASE_TYPE_STRUCT: {
+        if (IsStruct(type)) {
+          code_ += indent + "return ParseFromJson(_r, &{{DEST}});";
+        } else {
+          code_ += indent + "return ParseFromJson(_r, _fbb, &{{DEST}});";
+        }
+        break;
+      }
+      case BASE_TYPE_VECTOR: {
+        auto vector_type = type.VectorType();
+        code_.SetValue("ELEMENT", GenJsonVectorElement(vector_type));
+        if (IsJsonUnionTypeVector(field)) {
+          code_.SetValue("VALUES", "_" + dest + "_values");
+          code_ += indent + "{{VALUES}}.clear();";
+        } else {
+          code_.SetValue("VALUES", "_values");
+          code_ += indent + "std::vector<{{ELEMENT}}> {{VALUES}};";
+        }
+        code_ += indent + "if (!_r.ParseArray([&]() -> bool {";
+        switch (vector_type.base_type) {
+          case BASE_TYPE_UNION: {
+            code_.SetValue("TYPES",
+                           "_" + dest + UnionTypeFieldSuffix() + "_values");
+            code_.SetValue("ENUM_NAME",
+                           WrapInNameSpace(*vector_type.enum_def));
+            code_ += indent + "  if ({{VALUES}}.size() == "
+                     "{{TYPES}}.size()) {";
+            code_ += indent + "    return _r.Error("
+                     "\"missing type field for this union value\");";
+            code_ += indent + "  }";
+            code_ += indent + "  flatbuffers::Offset<void> _e;";
+            code_ += indent + "  if (!ParseFromJson(_r, _fbb, "
+                     "static_cast<{{ENUM_NAME}}>(";
+            code_ += indent + "          {{TYPES}}[{{VALUES}}.size()]), "
+                     "&_e)) {";
+            code_ += indent + "    return false;";
+            code_ += indent + "  }";
+            code_ += indent + "  {{VALUES}}.push_back(_e);";
+            break;
+          }
+          case BASE_TYPE_STRING: {
+            code_ += indent + "  if (!_r.Parse(&_str)) return false;";
+            code_ += indent +
+                     "  {{VALUES}}.push_back(_fbb.CreateString(_str));";
+            break;
+          }
+          case BASE_TYPE_STRUCT: {
+            code_ += indent + "  {{ELEMENT}} _e;";
+            code_ += indent + (IsStruct(vector_type)
+                               ? "  if (!ParseFromJson(_r, &_e)) return false;"
+                               : "  if (!ParseFromJson(_r, _fbb, &_e)) "
+                                 "return false;");
+            code_ += indent + "  {{VALUES}}.push_back(_e);";
+            break;
+          }
+          default: {
+            // Enums and bools are stored as their underlying type.
+            code_ += indent + "  " + GenJsonLocal(vector_type, "_e");
+            code_ += indent + "  if (!" +
+                     GenJsonParseValue(vector_type, field, "_e") +
+                     ") return false;";
+            code_ += indent +
+                     (vector_type.enum_def ||
+                      vector_type.base_type == BASE_TYPE_BOOL
+                        ? "  {{VALUES}}.push_back("
+                          "static_cast<{{ELEMENT}}>(_e));"
+                        : "  {{VALUES}}.push_back(_e);");
+            break;
+          }
+        }
+        code_ += indent + "  return true;";
+        code_ += indent + "})) {";
+        code_ += indent + "  return false;";
+        code_ += indent + "}";
+        code_ += indent + "{{DEST}} = _fbb.CreateVector" +
+                 (IsStruct(vector_type) ? "OfStructs" : "") + "({{VALUES}});";
+        code_ += indent + "return true;";
+        break;
+      }
+      default: {
+        code_ += indent + "return " + GenJsonParseValue(type, field, dest) +
+                 ";";
+        break;
+      }
+    }
+  }
+
+  // Declares the local a table field is parsed into, see GenJsonParseField().
+  // Scalars start out with their default, like the arguments of CreateX().
+  void GenJsonTableLocal(const FieldDef &field) {
+    const auto &type = field.value.type;
+    code_.SetValue("FIELD_NAME", field.name);
+    if (IsStruct(type)) {
+      code_.SetValue("TYPE", WrapInNameSpace(*type.struct_def));
+      code_ += "  {{TYPE}} {{FIELD_NAME}};";
+    } else {
+      code_.SetValue("TYPE", GenTypeWire(type, " ", true));
+      code_.SetValue("VALUE", IsScalar(type.base_type)
+                                ? " = " + GetDefaultScalarValue(field)
+                                : "");
+      code_ += "  {{TYPE}}{{FIELD_NAME}}{{VALUE}};";
+    }
+    if (IsJsonUnionTypeVector(field)) {
+      code_ += "  std::vector<uint8_t> _{{FIELD_NAME}}_values;";
+    }
+  }
+
+  // For structs and tables, dispatches on a hash of the field name. The
+  // hash is seeded such that the names of all fields of this type hash to
+  // distinct values, making it a perfect hash for them.
+  void GenJsonParser(const StructDef &struct_def, bool decl) {
+    const auto fixed = struct_def.fixed;
+    const auto &fields = struct_def.fields.vec;
+    code_.SetValue("STRUCT_NAME", struct_def.name);
+    code_ += JsonParserSignature(fixed ? "{{STRUCT_NAME}} *_o"
+                                       : JsonTableParserArgs(struct_def.name)) +
+             (decl ? ";" : " {");
+    if (decl) return;
+
+    uint32_t seed = 0;
+    for (;; seed++) {
+      std::set<uint32_t> hashes;
+      auto it = fields.begin();
+      while (it != fields.end() &&
+             hashes.insert(JsonReader::HashName((*it)->name.c_str(),
+                                                (*it)->name.size(),
+                                                seed)).second) {
+        ++it;
+      }
+      if (it == fields.end()) break;
+    }
+
+    // Fields are read into locals first: structs are immutable, and a table
+    // can only be started once its strings, vectors and subtables are built.
+    // Every field also has a flag, as like with Parser, each may be set only
+    // once.
+    auto has_strings = false;
+    for (auto it = fields.begin(); it != fields.end(); ++it) {
+      const auto &field = **it;
+      const auto &type = field.value.type;
+      if (fixed) {
+        code_ += "  " + GenJsonLocal(type, field.name);
+      } else if (!field.deprecated) {
+        GenJsonTableLocal(field);
+        has_strings = has_strings || type.base_type == BASE_TYPE_STRING ||
+                      (type.base_type == BASE_TYPE_VECTOR &&
+                       type.element == BASE_TYPE_STRING);
+      }
+      code_.SetValue("FIELD_NAME", field.name);
+      code_ += "  bool _has_{{FIELD_NAME}} = false;";
+    }
+    if (has_strings) code_ += "  std::string _str;";
+    code_ += "  if (!_r.ParseObject([&](const char *_name, size_t _len) "
+             "-> bool {";
+    if (!fields.empty()) {
+      code_.SetValue("SEED", NumToString(seed));
+      code_ += "    switch (flatbuffers::JsonReader::HashName(_name, _len, "
+               "{{SEED}})) {";
+      for (auto it = fields.begin(); it != fields.end(); ++it) {
+        const auto &field = **it;
+        auto hash = JsonReader::HashName(field.name.c_str(),
+                                         field.name.size(), seed);
+        code_.SetValue("HASH", IntToStringHex(static_cast<int>(hash), 8));
+        code_.SetValue("FIELD_NAME", field.name);
+        code_.SetValue("LEN", NumToString(field.name.size()));
+        code_ += "      case 0x{{HASH}}u:";
+        code_ += "        if (_len == {{LEN}} && "
+                 "!memcmp(_name, \"{{FIELD_NAME}}\", {{LEN}})) {";
+        code_ += "          if (_has_{{FIELD_NAME}}) {";
+        code_ += "            return _r.Error(\"field set more than once: "
+                 "{{FIELD_NAME}}\");";
+        code_ += "          }";
+        code_ += "          _has_{{FIELD_NAME}} = true;";
+        GenJsonParseField(field, fixed, "          ");
+        code_ += "        }";
+        code_ += "        break;";
+      }
+      code_ += "    }";
+    }
+    code_ += "    return _r.UnknownField(_name, _len);";
+    code_ += "  })) {";
+    code_ += "    return false;";
+    code_ += "  }";
+    if (fixed) {
+      std::string args, missing;
+      for (auto it = fields.begin(); it != fields.end(); ++it) {
+        if (it != fields.begin()) args += ", ";
+        args += (*it)->name;
+        if (it != fields.begin()) missing += " || ";
+        missing += "!_has_" + (*it)->name;
+      }
+      // Parser requires all fields of a struct.
+      code_ += "  if (" + missing + ") {";
+      code_ += "    return _r.Error(\"struct: wrong number of initializers: "
+               "{{STRUCT_NAME}}\");";
+      code_ += "  }";
+      // Constructed in place: structs have no assignment operator of their
+      // own.
+      code_ += "  new (_o) {{STRUCT_NAME}}(" + args + ");";
+    } else {
+      std::string args;
+      for (auto it = fields.begin(); it != fields.end(); ++it) {
+        const auto &field = **it;
+        if (field.deprecated) continue;
+        code_.SetValue("FIELD_NAME", field.name);
+        if (field.required) {
+          code_ += "  if (!_has_{{FIELD_NAME}}) {";
+          code_ += "    return _r.Error(\"required field is missing: "
+                   "{{FIELD_NAME}}\");";
+          code_ += "  }";
+        }
+        args += ",\n      ";
+        args += IsStruct(field.value.type)
+                  ? "_has_" + field.name + " ? &" + field.name + " : nullptr"
+                  : field.name;
+      }
+      code_ += "  *_o = Create{{STRUCT_NAME}}(_fbb" + args + ");";
+    }
+    code_ += "  return true;";
+    code_ += "}";
+    code_ += "";
+  }
+
   static void GenPadding(
       const FieldDef &field, std::string *code_ptr, int *id,
       const std::function<void(int bits, std::string *code_ptr, int *id)> &f) {
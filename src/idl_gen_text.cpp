@@ -22,41 +22,44 @@
 
 namespace flatbuffers {
 
-static bool GenStruct(const StructDef &struct_def, const Table *table,
-                      int indent, const IDLOptions &opts,
-                      std::string *_text);
+// When streaming, passes the text generated so far on to the sink once
+// enough of it has accumulated.
+bool TextGenerator::Flush() {
+  if (!sink_ || text_->size() < kTextSinkChunkSize) return true;
+  auto ok = (*sink_)(text_->data(), text_->size());
+  text_->clear();
+  return ok;
+}
 
 // If indentation is less than 0, that indicates we don't want any newlines
 // either.
-const char *NewLine(const IDLOptions &opts) {
-  return opts.indent_step >= 0 ? "\n" : "";
+void TextGenerator::NewLine() {
+  if (opts_.indent_step >= 0) *text_ += '\n';
 }
 
-int Indent(const IDLOptions &opts) {
-  return std::max(opts.indent_step, 0);
+int TextGenerator::Indent() const {
+  return std::max(opts_.indent_step, 0);
 }
 
 // Output an identifier with or without quotes depending on strictness.
-void OutputIdentifier(const std::string &name, const IDLOptions &opts,
-                      std::string *_text) {
-  std::string &text = *_text;
-  if (opts.strict_json) text += "\"";
+void TextGenerator::OutputIdentifier(const std::string &name) {
+  std::string &text = *text_;
+  if (opts_.strict_json) text += '\"';
   text += name;
-  if (opts.strict_json) text += "\"";
+  if (opts_.strict_json) text += '\"';
 }
 
 // Print (and its template specialization below for pointers) generate text
 // for a single FlatBuffer value into JSON format.
 // The general case for scalars:
-template<typename T> bool Print(T val, Type type, int /*indent*/,
-                                StructDef * /*union_sd*/,
-                                const IDLOptions &opts,
-                                std::string *_text) {
-  std::string &text = *_text;
-  if (type.enum_def && opts.output_enum_identifiers) {
+template<typename T> bool TextGenerator::Print(T val, Type type,
+                                               int /*indent*/,
+                                               StructDef * /*union_sd*/) {
+  std::string &text = *text_;
+  if (type.enum_def && opts_.output_enum_identifiers) {
     auto enum_val = type.enum_def->ReverseLookup(static_cast<int>(val));
     if (enum_val) {
-      OutputIdentifier(enum_val->name, opts, _text);
+      OutputIdentifier(enum_val->name);
       return true;
     }
   }
@@ -64,48 +67,79 @@ template<typename T> bool Print(T val, Type type, int /*indent*/,
   if (type.base_type == BASE_TYPE_BOOL) {
     text += val != 0 ? "true" : "false";
   } else {
-    text += NumToString(val);
+    char buf[kMaxNumToCharsLength];
+    text.append(buf, NumToChars(val, buf));
   }
 
   return true;
 }
 
 // Print a vector a sequence of JSON values, comma separated, wrapped in "[]".
-template<typename T> bool PrintVector(const Vector<T> &v, Type type,
-                                      int indent, const IDLOptions &opts,
-                                      std::string *_text) {
-  std::string &text = *_text;
-  text += "[";
-  text += NewLine(opts);
+template<typename T> bool TextGenerator::PrintVector(const Vector<T> &v,
+                                                     Type type, int indent) {
+  std::string &text = *text_;
+  text += '[';
+  NewLine();
   for (uoffset_t i = 0; i < v.size(); i++) {
     if (i) {
-      text += ",";
-      text += NewLine(opts);
+      text += ',';
+      NewLine();
     }
-    text.append(indent + Indent(opts), ' ');
+    text.append(indent + Indent(), ' ');
     if (IsStruct(type)) {
       if (!Print(v.GetStructFromOffset(i * type.struct_def->bytesize), type,
-                 indent + Indent(opts), nullptr, opts, _text)) {
+                 indent + Indent(), nullptr)) {
         return false;
       }
     } else {
-      if (!Print(v[i], type, indent + Indent(opts), nullptr,
-                 opts, _text)) {
+      if (!Print(v[i], type, indent + Indent(), nullptr)) {
         return false;
       }
     }
+    if (!Flush()) return false;
   }
-  text += NewLine(opts);
+  NewLine();
   text.append(indent, ' ');
-  text += "]";
+  text += ']';
   return true;
 }
 
-static bool EscapeString(const String &s, std::string *_text, const IDLOptions& opts) {
-  std::string &text = *_text;
-  text += "\"";
-  for (uoffset_t i = 0; i < s.size(); i++) {
-    char c = s[i];
+// Returns the first character at or after p that is not printable ASCII, or
+// needs escaping in a JSON string anyway.
+static const char *ScanPrintable(const char *p, const char *end) {
+  #ifdef FLATBUFFERS_SSE2
+    const auto space = _mm_set1_epi8(' ');
+    const auto del = _mm_set1_epi8(0x7F);
+    const auto quote = _mm_set1_epi8('\"');
+    const auto backslash = _mm_set1_epi8('\\');
+    while (end - p >= 16) {
+      auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+      // Signed compare, so bytes >= 0x80 count as < ' ' too.
+      auto special = _mm_or_si128(
+                       _mm_or_si128(_mm_cmplt_epi8(v, space),
+                                    _mm_cmpeq_epi8(v, del)),
+                       _mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                                    _mm_cmpeq_epi8(v, backslash)));
+      auto mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+      if (mask) return p + LowestBitSet(mask);
+      p += 16;
+    }
+  #endif
+  while (p < end && *p >= ' ' && *p <= '~' && *p != '\"' && *p != '\\') p++;
+  return p;
+}
+
+bool TextGenerator::EscapeString(const String &s) {
+  std::string &text = *text_;
+  text += '\"';
+  const char *end = s.c_str() + s.size();
+  for (const char *p = s.c_str(); p < end; ) {
+    // Copy everything that doesn't need escaping in one go.
+    const char *run = ScanPrintable(p, end);
+    text.append(p, run);
+    p = run;
+    if (p == end) break;
+    char c = *p++;
     switch (c) {
       case '\n': text += "\\n"; break;
       case '\t': text += "\\t"; break;
@@ -114,64 +148,59 @@ static bool EscapeString(const String &s, std::string *_text, const IDLOptions&
       case '\f': text += "\\f"; break;
       case '\"': text += "\\\""; break;
       case '\\': text += "\\\\"; break;
-      default:
-        if (c >= ' ' && c <= '~') {
-          text += c;
-        } else {
-          // Not printable ASCII data. Let's see if it's valid UTF-8 first:
-          const char *utf8 = s.c_str() + i;
-          int ucc = FromUTF8(&utf8);
-          if (ucc < 0) {
-            if (opts.allow_non_utf8) {
-              text += "\\x";
-              text += IntToStringHex(static_cast<uint8_t>(c), 2);
-            } else {
-              // There are two cases here:
-              //
-              // 1) We reached here by parsing an IDL file. In that case,
-              // we previously checked for non-UTF-8, so we shouldn't reach
-              // here.
-              //
-              // 2) We reached here by someone calling GenerateText()
-              // on a previously-serialized flatbuffer. The data might have
-              // non-UTF-8 Strings, or might be corrupt.
-              //
-              // In both cases, we have to give up and inform the caller
-              // they have no JSON.
-              return false;
-            }
+      default: {
+        // Not printable ASCII data. Let's see if it's valid UTF-8 first:
+        const char *utf8 = p - 1;
+        int ucc = FromUTF8(&utf8);
+        if (ucc < 0) {
+          if (opts_.allow_non_utf8) {
+            text += "\\x";
+            text += IntToStringHex(static_cast<uint8_t>(c), 2);
           } else {
-            if (ucc <= 0xFFFF) {
-              // Parses as Unicode within JSON's \uXXXX range, so use that.
-              text += "\\u";
-              text += IntToStringHex(ucc, 4);
-            } else if (ucc <= 0x10FFFF) {
-              // Encode Unicode SMP values to a surrogate pair using two \u escapes.
-              uint32_t base = ucc - 0x10000;
-              auto high_surrogate = (base >> 10) + 0xD800;
-              auto low_surrogate = (base & 0x03FF) + 0xDC00;
-              text += "\\u";
-              text += IntToStringHex(high_surrogate, 4);
-              text += "\\u";
-              text += IntToStringHex(low_surrogate, 4);
-            }
-            // Skip past characters recognized.
-            i = static_cast<uoffset_t>(utf8 - s.c_str() - 1);
+            // There are two cases here:
+            //
+            // 1) We reached here by parsing an IDL file. In that case,
+            // we previously checked for non-UTF-8, so we shouldn't reach
+            // here.
+            //
+            // 2) We reached here by someone calling GenerateText()
+            // on a previously-serialized flatbuffer. The data might have
+            // non-UTF-8 Strings, or might be corrupt.
+            //
+            // In both cases, we have to give up and inform the caller
+            // they have no JSON.
+            return false;
           }
+        } else {
+          if (ucc <= 0xFFFF) {
+            // Parses as Unicode within JSON's \uXXXX range, so use that.
+            text += "\\u";
+            text += IntToStringHex(ucc, 4);
+          } else if (ucc <= 0x10FFFF) {
+            // Encode Unicode SMP values to a surrogate pair using two \u escapes.
+            uint32_t base = ucc - 0x10000;
+            auto high_surrogate = (base >> 10) + 0xD800;
+            auto low_surrogate = (base & 0x03FF) + 0xDC00;
+            text += "\\u";
+            text += IntToStringHex(high_surrogate, 4);
+            text += "\\u";
+            text += IntToStringHex(low_surrogate, 4);
+          }
+          // Skip past characters recognized.
+          p = utf8;
         }
         break;
+      }
     }
   }
-  text += "\"";
+  text += '\"';
   return true;
 }
 
 // Specialization of Print above for pointer types.
-template<> bool Print<const void *>(const void *val,
-                                    Type type, int indent,
-                                    StructDef *union_sd,
-                                    const IDLOptions &opts,
-                                    std::string *_text) {
+template<> bool TextGenerator::Print<const void *>(const void *val,
+                                                   Type type, int indent,
+                                                   StructDef *union_sd) {
   switch (type.base_type) {
     case BASE_TYPE_UNION:
       // If this assert hits, you have an corrupt buffer, a union type field
@@ -179,23 +208,19 @@ template<> bool Print<const void *>(const void *val,
       assert(union_sd);
       if (!GenStruct(*union_sd,
                      reinterpret_cast<const Table *>(val),
-                     indent,
-                     opts,
-                     _text)) {
+                     indent)) {
         return false;
       }
       break;
     case BASE_TYPE_STRUCT:
       if (!GenStruct(*type.struct_def,
                      reinterpret_cast<const Table *>(val),
-                     indent,
-                     opts,
-                     _text)) {
+                     indent)) {
         return false;
       }
       break;
     case BASE_TYPE_STRING: {
-      if (!EscapeString(*reinterpret_cast<const String *>(val), _text, opts)) {
+      if (!EscapeString(*reinterpret_cast<const String *>(val))) {
         return false;
       }
       break;
@@ -209,7 +234,7 @@ template<> bool Print<const void *>(const void *val,
           case BASE_TYPE_ ## ENUM: \
             if (!PrintVector<CTYPE>( \
                   *reinterpret_cast<const Vector<CTYPE> *>(val), \
-                  type, indent, opts, _text)) { \
+                  type, indent)) { \
               return false; \
             } \
             break;
@@ -223,21 +248,18 @@ template<> bool Print<const void *>(const void *val,
 }
 
 // Generate text for a scalar field.
-template<typename T> static bool GenField(const FieldDef &fd,
-                                          const Table *table, bool fixed,
-                                          const IDLOptions &opts,
-                                          int indent,
-                                          std::string *_text) {
+template<typename T> bool TextGenerator::GenField(const FieldDef &fd,
+                                                  const Table *table,
+                                                  bool fixed, int indent) {
   return Print(fixed ?
     reinterpret_cast<const Struct *>(table)->GetField<T>(fd.value.offset) :
-    table->GetField<T>(fd.value.offset, 0), fd.value.type, indent, nullptr,
-                                            opts, _text);
+    table->GetField<T>(fd.value.offset, 0), fd.value.type, indent, nullptr);
 }
 
 // Generate text for non-scalar field.
-static bool GenFieldOffset(const FieldDef &fd, const Table *table, bool fixed,
-                           int indent, StructDef *union_sd,
-                           const IDLOptions &opts, std::string *_text) {
+bool TextGenerator::GenFieldOffset(const FieldDef &fd, const Table *table,
+                                   bool fixed, int indent,
+                                   StructDef *union_sd) {
   const void *val = nullptr;
   if (fixed) {
     // The only non-scalar fields in structs are structs.
@@ -249,41 +271,57 @@ static bool GenFieldOffset(const FieldDef &fd, const Table *table, bool fixed,
       ? table->GetStruct<const void *>(fd.value.offset)
       : table->GetPointer<const void *>(fd.value.offset);
   }
-  return Print(val, fd.value.type, indent, union_sd, opts, _text);
+  return Print(val, fd.value.type, indent, union_sd);
+}
+
+const std::vector<std::string> &TextGenerator::FieldNames(
+    const StructDef &struct_def) {
+  if (names_strict_json_ != opts_.strict_json) {
+    field_names_.clear();
+    names_strict_json_ = opts_.strict_json;
+  }
+  auto &names = field_names_[&struct_def];
+  if (names.empty()) {
+    for (auto it = struct_def.fields.vec.begin();
+         it != struct_def.fields.vec.end(); ++it) {
+      auto name = opts_.strict_json ? "\"" + (*it)->name + "\"" : (*it)->name;
+      names.push_back(name + ": ");
+    }
+  }
+  return names;
 }
 
 // Generate text for a struct or table, values separated by commas, indented,
 // and bracketed by "{}"
-static bool GenStruct(const StructDef &struct_def, const Table *table,
-                      int indent, const IDLOptions &opts,
-                      std::string *_text) {
-  std::string &text = *_text;
-  text += "{";
+bool TextGenerator::GenStruct(const StructDef &struct_def, const Table *table,
+                              int indent) {
+  std::string &text = *text_;
+  text += '{';
   int fieldout = 0;
   StructDef *union_sd = nullptr;
+  auto name = FieldNames(struct_def).begin();
   for (auto it = struct_def.fields.vec.begin();
        it != struct_def.fields.vec.end();
-       ++it) {
+       ++it, ++name) {
     FieldDef &fd = **it;
     auto is_present = struct_def.fixed || table->CheckField(fd.value.offset);
-    auto output_anyway = opts.output_default_scalars_in_json &&
+    auto output_anyway = opts_.output_default_scalars_in_json &&
                          IsScalar(fd.value.type.base_type) &&
                          !fd.deprecated;
     if (is_present || output_anyway) {
       if (fieldout++) {
-        text += ",";
+        text += ',';
       }
-      text += NewLine(opts);
-      text.append(indent + Indent(opts), ' ');
-      OutputIdentifier(fd.name, opts, _text);
-      text += ": ";
+      NewLine();
+      text.append(indent + Indent(), ' ');
+      text += *name;
       if (is_present) {
         switch (fd.value.type.base_type) {
            #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE, \
              PTYPE) \
              case BASE_TYPE_ ## ENUM: \
                 if (!GenField<CTYPE>(fd, table, struct_def.fixed, \
-                                     opts, indent + Indent(opts), _text)) { \
+                                     indent + Indent())) { \
                   return false; \
                 } \
                 break;
@@ -295,8 +333,8 @@ static bool GenStruct(const StructDef &struct_def, const Table *table,
             case BASE_TYPE_ ## ENUM:
             FLATBUFFERS_GEN_TYPES_POINTER(FLATBUFFERS_TD)
           #undef FLATBUFFERS_TD
-              if (!GenFieldOffset(fd, table, struct_def.fixed, indent + Indent(opts),
-                                  union_sd, opts, _text)) {
+              if (!GenFieldOffset(fd, table, struct_def.fixed,
+                                  indent + Indent(), union_sd)) {
                 return false;
               }
               break;
@@ -312,29 +350,96 @@ static bool GenStruct(const StructDef &struct_def, const Table *table,
       {
         text += fd.value.constant;
       }
+      if (!Flush()) return false;
     }
   }
-  text += NewLine(opts);
+  NewLine();
   text.append(indent, ' ');
-  text += "}";
+  text += '}';
   return true;
 }
 
+bool TextGenerator::Generate(const void *flatbuffer, std::string *text) {
+  assert(parser_.root_struct_def_);  // call SetRootType()
+  text->reserve(1024);   // Reduce amount of inevitable reallocs.
+  text_ = text;
+  auto ok = GenStruct(*parser_.root_struct_def_, GetRoot<Table>(flatbuffer),
+                      0);
+  if (ok) NewLine();
+  text_ = nullptr;
+  return ok;
+}
+
+bool TextGenerator::Generate(const void *flatbuffer, const TextSink &sink) {
+  assert(parser_.root_struct_def_);  // call SetRootType()
+  // Leave room for the piece that takes us over the limit.
+  chunk_.clear();
+  chunk_.reserve(kTextSinkChunkSize + kTextSinkChunkSize / 4);
+  text_ = &chunk_;
+  sink_ = &sink;
+  auto ok = GenStruct(*parser_.root_struct_def_, GetRoot<Table>(flatbuffer),
+                      0);
+  if (ok) {
+    NewLine();
+    ok = sink(chunk_.data(), chunk_.size());
+  }
+  chunk_.clear();
+  text_ = nullptr;
+  sink_ = nullptr;
+  return ok;
+}
+
 // Generate a text representation of a flatbuffer in JSON format.
 bool GenerateText(const Parser &parser, const void *flatbuffer,
                   std::string *_text) {
-  std::string &text = *_text;
-  assert(parser.root_struct_def_);  // call SetRootType()
-  text.reserve(1024);   // Reduce amount of inevitable reallocs.
-  if (!GenStruct(*parser.root_struct_def_,
-                 GetRoot<Table>(flatbuffer),
-                 0,
-                 parser.opts,
-                 _text)) {
-    return false;
-  }
-  text += NewLine(parser.opts);
-  return true;
+  TextGenerator generator(parser);
+  return generator.Generate(flatbuffer, _text);
+}
+
+bool GenerateText(const Parser &parser, const void *flatbuffer,
+                  const TextSink &sink) {
+  TextGenerator generator(parser);
+  return generator.Generate(flatbuffer, sink);
+}
+
+bool GenerateText(const Parser &parser, const void *flatbuffer, FILE *file) {
+  return GenerateText(parser, flatbuffer,
+                      [file](const char *text, size_t len) {
+    return fwrite(text, 1, len, file) == len;
+  });
+}
+
+bool GenerateTextStream(const Parser &parser,
+                        FILE *stream,
+                        bool check_identifier,
+                        const TextSink &sink,
+                        std::string *error) {
+  auto opts = parser.opts;
+  opts.indent_step = -1;
+  TextGenerator generator(parser, opts);
+  std::string line;
+  uint64_t offset = 0;
+  return ReadSizePrefixedStream(stream, [&](const uint8_t *buf, size_t len) {
+    auto flatbuffer = buf + sizeof(uoffset_t);
+    auto min_len = sizeof(uoffset_t) * 2 +
+                   FlatBufferBuilder::kFileIdentifierLength;
+    if (check_identifier &&
+        (parser.file_identifier_.empty() || len < min_len ||
+         !BufferHasIdentifier(flatbuffer, parser.file_identifier_.c_str()))) {
+      *error = "buffer at offset " + NumToString(offset) +
+               " does not have the file_identifier of the schema";
+      return false;
+    }
+    line.clear();
+    if (!generator.Generate(flatbuffer, &line)) {
+      *error = "unable to generate text for the buffer at offset " +
+               NumToString(offset);
+      return false;
+    }
+    offset += len;
+    line += '\n';
+    return sink(line.c_str(), line.size());
+  }, error);
 }
 
 std::string TextFileName(const std::string &path,
@@ -345,14 +450,33 @@ std::string TextFileName(const std::string &path,
 bool GenerateTextFile(const Parser &parser,
                       const std::string &path,
                       const std::string &file_name) {
-  if (!parser.builder_.GetSize() || !parser.root_struct_def_) return true;
-  std::string text;
-  if (!GenerateText(parser, parser.builder_.GetBufferPointer(), &text)) {
-    return false;
-  }
-  return flatbuffers::SaveFile(TextFileName(path, file_name).c_str(),
-                               text,
-                               false);
+  if (!parser.builder_.GetSize()) return true;
+  return GenerateTextFile(parser, path, file_name,
+                          parser.builder_.GetBufferPointer(),
+                          parser.builder_.GetSize());
+}
+
+bool GenerateTextFile(const Parser &parser,
+                      const std::string &path,
+                      const std::string &file_name,
+                      const void *flatbuffer,
+                      size_t size) {
+  // Nothing to convert if empty, and no room for the root offset otherwise.
+  if (size < sizeof(uoffset_t)) return !size;
+  if (!parser.root_struct_def_) return true;
+  auto filename = TextFileName(path, file_name);
+  std::ofstream ofs(filename.c_str(), std::ofstream::out);
+  if (!ofs.is_open()) return false;
+  auto ok = GenerateText(parser, flatbuffer,
+                         [&ofs](const char *text, size_t len) {
+    ofs.write(text, len);
+    return !ofs.bad();
+  });
+  ofs.close();
+  ok = ok && !ofs.fail();
+  // Don't leave a truncated file behind.
+  if (!ok) remove(filename.c_str());
+  return ok;
 }
 
 std::string TextMakeRule(const Parser &parser,
@@ -61,17 +61,6 @@ static_assert(BASE_TYPE_UNION ==
 #define NEXT() ECHECK(Next())
 #define EXPECT(tok) ECHECK(Expect(tok))
 
-static bool ValidateUTF8(const std::string &str) {
-  const char *s = &str[0];
-  const char * const sEnd = s + str.length();
-  while (s < sEnd) {
-    if (FromUTF8(&s) < 0) {
-      return false;
-    }
-  }
-  return true;
-}
-
 CheckedError Parser::Error(const std::string &msg) {
   error_ = file_being_parsed_.length() ? AbsolutePath(file_being_parsed_) : "";
   #ifdef _WIN32
@@ -124,13 +113,13 @@ template<> inline CheckedError atot<bool>(const char *s, Parser &parser,
 template<> inline CheckedError atot<float>(const char *s, Parser &parser,
                                            float *val) {
   (void)parser;
-  *val = static_cast<float>(strtod(s, nullptr));
+  *val = StringToFloat(s);
   return NoError();
 }
 template<> inline CheckedError atot<double>(const char *s, Parser &parser,
                                             double *val) {
   (void)parser;
-  *val = strtod(s, nullptr);
+  *val = StringToDouble(s);
   return NoError();
 }
 
@@ -141,6 +130,72 @@ template<> inline CheckedError atot<Offset<void>>(const char *s, Parser &parser,
   return NoError();
 }
 
+// Faster StringToInt() for the decimal integer tokens produced by the lexer.
+inline int64_t DecimalToInt(const std::string &s) {
+  auto p = s.c_str();
+  auto neg = *p == '-';
+  auto digits = s.length() - neg;
+  // Up to 18 digits can't overflow, leave anything longer to strtoll.
+  if (!digits || digits > 18) return StringToInt(p);
+  int64_t i = 0;
+  for (p += neg; *p; p++) i = i * 10 + (*p - '0');
+  return neg ? -i : i;
+}
+
+// tokentot: like atot, but for the current integer or float token, which
+// allows a faster path for integers.
+template<typename T> inline CheckedError tokentot(const std::string &s,
+                                                  Parser &parser, T *val) {
+  int64_t i = DecimalToInt(s);
+  ECHECK(parser.CheckBitsFit(i, sizeof(T) * 8));
+  *val = (T)i;
+  return NoError();
+}
+template<> inline CheckedError tokentot<uint64_t>(const std::string &s,
+                                                  Parser &parser,
+                                                  uint64_t *val) {
+  (void)parser;
+  *val = s.length() > 18 ? StringToUInt(s.c_str())
+                         : static_cast<uint64_t>(DecimalToInt(s));
+  return NoError();
+}
+template<> inline CheckedError tokentot<bool>(const std::string &s,
+                                              Parser &parser, bool *val) {
+  (void)parser;
+  *val = 0 != DecimalToInt(s);
+  return NoError();
+}
+template<> inline CheckedError tokentot<float>(const std::string &s,
+                                               Parser &parser, float *val) {
+  return atot(s.c_str(), parser, val);
+}
+template<> inline CheckedError tokentot<double>(const std::string &s,
+                                                Parser &parser, double *val) {
+  return atot(s.c_str(), parser, val);
+}
+
+// Store / retrieve a value parsed from JSON, which is either in binary form
+// (Value::typed) or text.
+template<typename T> inline void SetTyped(Value &val, T x) {
+  static_assert(sizeof(T) <= sizeof(val.bits), "value too large");
+  memcpy(&val.bits, &x, sizeof(T));
+  val.typed = true;
+}
+template<typename T> inline CheckedError GetTyped(const Value &val,
+                                                  Parser &parser, T *x) {
+  if (!val.typed) return atot(val.constant.c_str(), parser, x);
+  memcpy(x, &val.bits, sizeof(T));
+  return NoError();
+}
+template<> inline CheckedError GetTyped<Offset<void>>(const Value &val,
+                                                      Parser &parser,
+                                                      Offset<void> *x) {
+  uoffset_t o;
+  ECHECK(GetTyped(val, parser, &o));
+  *x = Offset<void>(o);
+  return NoError();
+}
+
 std::string Namespace::GetFullyQualifiedName(const std::string &name,
                                              size_t max_components) const {
   // Early exit if we don't have a defined namespace.
@@ -240,6 +295,73 @@ CheckedError Parser::SkipByteOrderMark() {
   return NoError();
 }
 
+// The lexer helpers below scan 16 bytes at a time with SSE2 where available,
+// and only read up to end (the terminating '\0') so they never read past the
+// source. The scalar loops finish the last few bytes and stop at the '\0'.
+
+// Returns the first character at or after p that is not a space, tab or
+// newline, and adds the number of newlines skipped to *lines.
+static const char *SkipWhitespace(const char *p, const char *end,
+                                  int *lines) {
+  #ifdef FLATBUFFERS_SSE2
+    // Only worth it for longer runs, such as indentation.
+    if ((p[0] == ' ' || p[0] == '\n') && (p[1] == ' ' || p[1] == '\n')) {
+      const auto space = _mm_set1_epi8(' ');
+      const auto tab = _mm_set1_epi8('\t');
+      const auto cr = _mm_set1_epi8('\r');
+      const auto nl = _mm_set1_epi8('\n');
+      while (end - p >= 16) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        auto newlines = _mm_cmpeq_epi8(v, nl);
+        auto ws = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(v, space), newlines),
+                    _mm_or_si128(_mm_cmpeq_epi8(v, tab),
+                                 _mm_cmpeq_epi8(v, cr)));
+        auto other = ~static_cast<uint32_t>(_mm_movemask_epi8(ws)) & 0xFFFF;
+        auto nlmask = static_cast<uint32_t>(_mm_movemask_epi8(newlines));
+        auto n = other ? LowestBitSet(other) : 16;
+        nlmask &= (1U << n) - 1;
+        for (; nlmask; nlmask &= nlmask - 1) (*lines)++;
+        p += n;
+        if (other) return p;
+      }
+    }
+  #else
+    (void)end;
+  #endif
+  for (;; p++) {
+    if (*p == '\n') (*lines)++;
+    else if (*p != ' ' && *p != '\t' && *p != '\r') return p;
+  }
+}
+
+// Returns the first character at or after p inside a string constant that
+// needs special handling: the closing quote, a backslash, or a control
+// character (which includes the terminating '\0').
+static const char *ScanStringRun(const char *p, const char *end, char quote) {
+  #ifdef FLATBUFFERS_SSE2
+    const auto q = _mm_set1_epi8(quote);
+    const auto backslash = _mm_set1_epi8('\\');
+    const auto control = _mm_set1_epi8(' ' - 1);
+    while (end - p >= 16) {
+      auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+      auto special = _mm_or_si128(
+                       _mm_or_si128(_mm_cmpeq_epi8(v, q),
+                                    _mm_cmpeq_epi8(v, backslash)),
+                       // Unsigned v <= ' ' - 1.
+                       _mm_cmpeq_epi8(_mm_max_epu8(v, control), control));
+      auto mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+      if (mask) return p + LowestBitSet(mask);
+      p += 16;
+    }
+  #else
+    (void)end;
+  #endif
+  while (*p != quote && *p != '\\' &&
+         static_cast<unsigned char>(*p) >= ' ') p++;
+  return p;
+}
+
 bool IsIdentifierStart(char c) {
   return isalpha(static_cast<unsigned char>(c)) || c == '_';
 }
@@ -249,6 +371,9 @@ CheckedError Parser::Next() {
   bool seen_newline = false;
   attribute_.clear();
   for (;;) {
+    auto line = line_;
+    cursor_ = SkipWhitespace(cursor_, source_end_, &line_);
+    if (line != line_) seen_newline = true;
     char c = *cursor_++;
     token_ = c;
     switch (c) {
@@ -329,7 +454,11 @@ CheckedError Parser::Next() {
               return Error(
                 "illegal Unicode sequence (unpaired high surrogate)");
             }
-            attribute_ += *cursor_++;
+            // Copy all of them up to the next quote, escape or control
+            // character in one go.
+            auto run = ScanStringRun(cursor_, source_end_, c);
+            attribute_.append(cursor_, run);
+            cursor_ = run;
           }
         }
         if (unicode_high_surrogate != -1) {
@@ -471,7 +600,7 @@ CheckedError Parser::Next() {
               while (isdigit(static_cast<unsigned char>(*cursor_))) cursor_++;
             }
             // See if this float has a scientific notation suffix. Both JSON
-            // and C++ (through strtod() we use) have the same format:
+            // and C++ (through StringToDouble() we use) have the same format:
             if (*cursor_ == 'e' || *cursor_ == 'E') {
               cursor_++;
               if (*cursor_ == '+' || *cursor_ == '-') cursor_++;
@@ -741,18 +870,21 @@ CheckedError Parser::ParseAnyValue(Value &val, FieldDef *field,
   switch (val.type.base_type) {
     case BASE_TYPE_UNION: {
       assert(field);
-      std::string constant;
+      const Value *type_value = nullptr;
       // Find corresponding type field we may have already parsed.
       for (auto elem = field_stack_.rbegin();
            elem != field_stack_.rbegin() + parent_fieldn; ++elem) {
         auto &type = elem->second->value.type;
         if (type.base_type == BASE_TYPE_UTYPE &&
             type.enum_def == val.type.enum_def) {
-          constant = elem->first.constant;
+          type_value = &elem->first;
           break;
         }
       }
-      if (constant.empty()) {
+      uint8_t enum_idx;
+      if (type_value) {
+        ECHECK(GetTyped(*type_value, *this, &enum_idx));
+      } else {
         // We haven't seen the type field yet. Sadly a lot of JSON writers
         // output these in alphabetical order, meaning it comes after this
         // value. So we scan past the value to find it, then come back here.
@@ -774,33 +906,40 @@ CheckedError Parser::ParseAnyValue(Value &val, FieldDef *field,
           return Error("missing type field after this union value: " +
                        type_name);
         EXPECT(':');
-        Value type_val = type_field->value;
+        Value type_val;
+        type_val.type = type_field->value.type;
         ECHECK(ParseAnyValue(type_val, type_field, 0, nullptr));
-        constant = type_val.constant;
+        ECHECK(GetTyped(type_val, *this, &enum_idx));
         // Got the information we needed, now rewind:
         *static_cast<ParserState *>(this) = backup;
       }
-      uint8_t enum_idx;
-      ECHECK(atot(constant.c_str(), *this, &enum_idx));
       auto enum_val = val.type.enum_def->ReverseLookup(enum_idx);
       if (!enum_val) return Error("illegal type id for: " + field->name);
-      ECHECK(ParseTable(*enum_val->struct_def, &val.constant, nullptr));
+      uoffset_t off;
+      ECHECK(ParseTable(*enum_val->struct_def, nullptr, &off));
+      SetTyped(val, off);
       break;
     }
     case BASE_TYPE_STRUCT:
-      ECHECK(ParseTable(*val.type.struct_def, &val.constant, nullptr));
+      if (val.type.struct_def->fixed) {
+        ECHECK(ParseTable(*val.type.struct_def, &val.constant, nullptr));
+      } else {
+        uoffset_t off;
+        ECHECK(ParseTable(*val.type.struct_def, nullptr, &off));
+        SetTyped(val, off);
+      }
       break;
     case BASE_TYPE_STRING: {
       auto s = attribute_;
       EXPECT(kTokenStringConstant);
-      val.constant = NumToString(builder_.CreateString(s).o);
+      SetTyped(val, builder_.CreateString(s).o);
       break;
     }
     case BASE_TYPE_VECTOR: {
       EXPECT('[');
       uoffset_t off;
       ECHECK(ParseVector(val.type.VectorType(), &off));
-      val.constant = NumToString(off);
+      SetTyped(val, off);
       break;
     }
     case BASE_TYPE_INT:
@@ -811,17 +950,43 @@ CheckedError Parser::ParseAnyValue(Value &val, FieldDef *field,
           (token_ == kTokenIdentifier || token_ == kTokenStringConstant)) {
         ECHECK(ParseHash(val, field));
       } else {
-        ECHECK(ParseSingleValue(val));
+        ECHECK(ParseScalar(val));
       }
       break;
     }
     default:
-      ECHECK(ParseSingleValue(val));
+      ECHECK(ParseScalar(val));
       break;
   }
   return NoError();
 }
 
+// Parses a scalar JSON value. Plain numbers (by far the most common) are
+// converted straight to the field type, everything else (enum identifiers,
+// numbers in strings, conversion functions, errors) goes through
+// ParseSingleValue().
+CheckedError Parser::ParseScalar(Value &val) {
+  if (token_ != kTokenIntegerConstant &&
+      (token_ != kTokenFloatConstant || !IsFloat(val.type.base_type))) {
+    return ParseSingleValue(val);
+  }
+  switch (val.type.base_type) {
+    #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE, PTYPE) \
+      case BASE_TYPE_ ## ENUM: { \
+        CTYPE x; \
+        ECHECK(tokentot(attribute_, *this, &x)); \
+        SetTyped(val, x); \
+        break; \
+      }
+      FLATBUFFERS_GEN_TYPES_SCALAR(FLATBUFFERS_TD);
+    #undef FLATBUFFERS_TD
+    default:
+      return ParseSingleValue(val);
+  }
+  NEXT();
+  return NoError();
+}
+
 void Parser::SerializeStruct(const StructDef &struct_def, const Value &val) {
   assert(val.constant.length() == struct_def.bytesize);
   builder_.Align(struct_def.minalign);
@@ -836,26 +1001,29 @@ CheckedError Parser::ParseTable(const StructDef &struct_def, std::string *value,
   size_t fieldn = 0;
   for (;;) {
     if ((!opts.strict_json || !fieldn) && Is('}')) { NEXT(); break; }
-    std::string name = attribute_;
+    // Look the field up while its name is still the current token, so the
+    // common case doesn't need a copy of it.
+    auto field = struct_def.fields.Lookup(attribute_);
+    if (!field && !opts.skip_unexpected_fields_in_json &&
+        (Is(kTokenStringConstant) ||
+         (Is(kTokenIdentifier) && !opts.strict_json)))
+      return Error("unknown field: " + attribute_);
     if (Is(kTokenStringConstant)) {
       NEXT();
     } else {
       EXPECT(opts.strict_json ? kTokenStringConstant : kTokenIdentifier);
     }
-    auto field = struct_def.fields.Lookup(name);
     if (!field) {
-      if (!opts.skip_unexpected_fields_in_json) {
-        return Error("unknown field: " + name);
-      } else {
-        EXPECT(':');
-        ECHECK(SkipAnyJsonValue());
-      }
+      EXPECT(':');
+      ECHECK(SkipAnyJsonValue());
     } else {
       EXPECT(':');
       if (Is(kTokenNull)) {
         NEXT(); // Ignore this field.
       } else {
-        Value val = field->value;
+        Value val;
+        val.type = field->value.type;
+        val.offset = field->value.offset;
         ECHECK(ParseAnyValue(val, field, fieldn, &struct_def));
         // Hardcoded insertion-sort with error-check.
         // If fields are specified in order, then this loop exits immediately.
@@ -868,7 +1036,7 @@ CheckedError Parser::ParseTable(const StructDef &struct_def, std::string *value,
         }
         // Note: elem points to before the insertion point, thus .base() points
         // to the correct spot.
-        field_stack_.insert(elem.base(), std::make_pair(val, field));
+        field_stack_.insert(elem.base(), std::make_pair(std::move(val), field));
         fieldn++;
       }
     }
@@ -900,12 +1068,12 @@ CheckedError Parser::ParseTable(const StructDef &struct_def, std::string *value,
               builder_.Pad(field->padding); \
               if (struct_def.fixed) { \
                 CTYPE val; \
-                ECHECK(atot(field_value.constant.c_str(), *this, &val)); \
+                ECHECK(GetTyped(field_value, *this, &val)); \
                 builder_.PushElement(val); \
               } else { \
                 CTYPE val, valdef; \
-                ECHECK(atot(field_value.constant.c_str(), *this, &val)); \
-                ECHECK(atot(field->value.constant.c_str(), *this, &valdef)); \
+                ECHECK(GetTyped(field_value, *this, &val)); \
+                ECHECK(GetTyped(field->value, *this, &valdef)); \
                 builder_.AddElement(field_value.offset, val, valdef); \
               } \
               break;
@@ -919,7 +1087,7 @@ CheckedError Parser::ParseTable(const StructDef &struct_def, std::string *value,
                 SerializeStruct(*field->value.type.struct_def, field_value); \
               } else { \
                 CTYPE val; \
-                ECHECK(atot(field_value.constant.c_str(), *this, &val)); \
+                ECHECK(GetTyped(field_value, *this, &val)); \
                 builder_.AddOffset(field_value.offset, val); \
               } \
               break;
@@ -958,7 +1126,7 @@ CheckedError Parser::ParseVector(const Type &type, uoffset_t *ovalue) {
     Value val;
     val.type = type;
     ECHECK(ParseAnyValue(val, nullptr, 0, nullptr));
-    field_stack_.push_back(std::make_pair(val, nullptr));
+    field_stack_.push_back(std::make_pair(std::move(val), nullptr));
     count++;
     if (Is(']')) { NEXT(); break; }
     EXPECT(',');
@@ -975,7 +1143,7 @@ CheckedError Parser::ParseVector(const Type &type, uoffset_t *ovalue) {
           if (IsStruct(val.type)) SerializeStruct(*val.type.struct_def, val); \
           else { \
              CTYPE elem; \
-             ECHECK(atot(val.constant.c_str(), *this, &elem)); \
+             ECHECK(GetTyped(val, *this, &elem)); \
              builder_.PushElement(elem); \
           } \
           break;
@@ -1108,7 +1276,7 @@ CheckedError Parser::ParseSingleValue(Value &e) {
     EXPECT(')');
     #define FLATBUFFERS_FN_DOUBLE(name, op) \
       if (functionname == name) { \
-        auto x = strtod(e.constant.c_str(), nullptr); \
+        auto x = StringToDouble(e.constant.c_str()); \
         e.constant = NumToString(op); \
       }
     FLATBUFFERS_FN_DOUBLE("deg", x / M_PI * 180);
@@ -1138,7 +1306,7 @@ CheckedError Parser::ParseSingleValue(Value &e) {
           return Error("invalid integer: " + attribute_);
       } else if (IsFloat(e.type.base_type)) {
         char *end;
-        e.constant = NumToString(strtod(attribute_.c_str(), &end));
+        e.constant = NumToString(StringToDouble(attribute_.c_str(), &end));
         if (*end)
           return Error("invalid float: " + attribute_);
       } else {
@@ -1853,6 +2021,67 @@ bool Parser::Parse(const char *source, const char **include_paths,
   return !DoParse(source, include_paths, source_filename).Check();
 }
 
+bool Parser::ParseJsonStream(FILE *stream, const BufferSink &sink,
+                             const char *source_filename) {
+  file_being_parsed_ = source_filename ? source_filename : "";
+  std::string record;
+  char chunk[4096];
+  size_t pos = 0, len = 0;
+  for (int line = 1; ; line++) {
+    record.clear();
+    auto eol = false;
+    while (!eol) {
+      if (pos == len) {
+        pos = 0;
+        len = fread(chunk, 1, sizeof(chunk), stream);
+        if (!len) break;
+      }
+      auto start = chunk + pos;
+      auto end = static_cast<char *>(memchr(start, '\n', len - pos));
+      eol = end != nullptr;
+      if (!eol) end = chunk + len;
+      record.append(start, end);
+      pos = static_cast<size_t>(end - chunk) + eol;
+    }
+    if (!eol && record.empty()) break;
+    // The record is parsed as a C string, which would end at a NUL.
+    if (record.find('\0') != std::string::npos) {
+      line_ = line;
+      Error("illegal NUL character in json").Check();
+      return false;
+    }
+    if (record.find_first_not_of(" \t\r") == std::string::npos) continue;
+    if (ParseJsonRecord(record.c_str(), line).Check()) return false;
+    if (!sink(builder_.GetBufferPointer(), builder_.GetSize())) return false;
+  }
+  if (ferror(stream)) {
+    Error("unable to read the stream").Check();
+    return false;
+  }
+  return true;
+}
+
+// Parses a single table of the root type, unlike DoParse() without touching
+// any of the definitions.
+CheckedError Parser::ParseJsonRecord(const char *source, int line) {
+  source_ = cursor_ = source;
+  source_end_ = source + strlen(source);
+  line_ = line;
+  error_.clear();
+  field_stack_.clear();
+  builder_.Clear();
+  if (!root_struct_def_) return Error("no root type set to parse json with");
+  ECHECK(SkipByteOrderMark());
+  NEXT();
+  uoffset_t toff;
+  ECHECK(ParseTable(*root_struct_def_, nullptr, &toff));
+  if (token_ != kTokenEof)
+    return Error("expecting a single json object per line");
+  builder_.FinishSizePrefixed(Offset<Table>(toff),
+                file_identifier_.length() ? file_identifier_.c_str() : nullptr);
+  return NoError();
+}
+
 CheckedError Parser::DoParse(const char *source, const char **include_paths,
                              const char *source_filename) {
   file_being_parsed_ = source_filename ? source_filename : "";
@@ -1866,6 +2095,7 @@ CheckedError Parser::DoParse(const char *source, const char **include_paths,
     include_paths = current_directory;
   }
   source_ = cursor_ = source;
+  source_end_ = source + strlen(source);
   line_ = 1;
   error_.clear();
   field_stack_.clear();
@@ -1909,7 +2139,9 @@ CheckedError Parser::DoParse(const char *source, const char **include_paths,
         std::string contents;
         if (!LoadFile(filepath.c_str(), true, &contents))
           return Error("unable to load include file: " + name);
-        ECHECK(DoParse(contents.c_str(), include_paths, filepath.c_str()));
+        if (!schema_cache_ || opts.proto_mode ||
+            !ImportFromSchemaCache(filepath, contents, include_paths))
+          ECHECK(DoParse(contents.c_str(), include_paths, filepath.c_str()));
         // We generally do not want to output code for any included files:
         if (!opts.generate_all) MarkGenerated();
         // This is the easiest way to continue this file after an include:
@@ -1990,6 +2222,31 @@ CheckedError Parser::DoParse(const char *source, const char **include_paths,
       return Error("type referenced but not defined: " + (*it)->name);
     }
   }
+  // Now that all types are known, check hash indices refer to a keyed vector
+  // of tables and an index field of the right type.
+  for (auto it = structs_.vec.begin(); it != structs_.vec.end(); ++it) {
+    auto &struct_def = **it;
+    for (auto field_it = struct_def.fields.vec.begin();
+         field_it != struct_def.fields.vec.end(); ++field_it) {
+      auto &field = **field_it;
+      auto hash_index = field.attributes.Lookup("hash_index");
+      if (!hash_index) continue;
+      if (hash_index->type.base_type != BASE_TYPE_STRING)
+        return Error("hash_index attribute must be a string (the index field)");
+      auto &type = field.value.type;
+      if (type.base_type != BASE_TYPE_VECTOR ||
+          type.element != BASE_TYPE_STRUCT || type.struct_def->fixed ||
+          !type.struct_def->has_key)
+        return Error("hash_index attribute may only apply to a vector of "
+                     "tables with a key: " + field.name);
+      auto index_field = struct_def.fields.Lookup(hash_index->constant);
+      if (!index_field ||
+          index_field->value.type.base_type != BASE_TYPE_VECTOR ||
+          index_field->value.type.element != BASE_TYPE_UINT)
+        return Error("hash_index must name a [uint] field of the same "
+                     "table: " + hash_index->constant);
+    }
+  }
   for (auto it = enums_.vec.begin(); it != enums_.vec.end(); ++it) {
     auto &enum_def = **it;
     if (enum_def.is_union) {
@@ -2005,6 +2262,211 @@ CheckedError Parser::DoParse(const char *source, const char **include_paths,
   return NoError();
 }
 
+// Creates a copy of each of the symbols in table, keeping both the order in
+// which they were added and the order of vec (which the parser may have
+// sorted).
+template<typename T, typename F>
+static void CopySymbolTable(const SymbolTable<T> &table, SymbolTable<T> *copy,
+                            F clone) {
+  auto &symbols = table.symbols();
+  auto same_order = table.vec.size() == symbols.size();
+  for (size_t i = 0; same_order && i < table.vec.size(); i++)
+    same_order = table.vec[i] == symbols[i].second;
+  if (same_order) {  // The common case.
+    for (auto it = symbols.begin(); it != symbols.end(); ++it)
+      copy->Add(it->first, clone(*it->second));
+    return;
+  }
+  std::map<const T *, T *> copies;
+  for (auto it = symbols.begin(); it != symbols.end(); ++it) {
+    auto sym = clone(*it->second);
+    copies[it->second] = sym;
+    copy->Add(it->first, sym);
+  }
+  copy->vec.clear();
+  for (auto it = table.vec.begin(); it != table.vec.end(); ++it) {
+    auto sym = copies.find(*it);
+    // Duplicates were kept in vec only.
+    copy->vec.push_back(sym != copies.end() ? sym->second : clone(**it));
+  }
+}
+
+// Definitions from files are new, all others must exist already.
+template<typename T>
+static bool CanImportSymbols(const SymbolTable<T> &table,
+                             const std::set<std::string> &files,
+                             const SymbolTable<T> &dest) {
+  auto &symbols = table.symbols();
+  for (auto it = symbols.begin(); it != symbols.end(); ++it) {
+    auto is_new = files.find(it->second->file) != files.end();
+    if (is_new == (dest.Lookup(it->first) != nullptr)) return false;
+  }
+  return true;
+}
+
+// Adds an empty symbol to dest for each of table's symbols from files, in
+// the same order, and maps all of table's symbols to those in dest.
+template<typename T>
+static void ImportSymbols(const SymbolTable<T> &table,
+                          const std::set<std::string> &files,
+                          SymbolTable<T> *dest, std::map<const T *, T *> *map) {
+  auto size = dest->vec.size();
+  auto &symbols = table.symbols();
+  for (auto it = symbols.begin(); it != symbols.end(); ++it) {
+    if (files.find(it->second->file) != files.end()) {
+      auto sym = new T();
+      (*map)[it->second] = sym;
+      dest->Add(it->first, sym);
+    } else {
+      (*map)[it->second] = dest->Lookup(it->first);
+    }
+  }
+  dest->vec.resize(size);
+  for (auto it = table.vec.begin(); it != table.vec.end(); ++it) {
+    if (files.find((*it)->file) != files.end())
+      dest->vec.push_back((*map)[*it]);
+  }
+}
+
+// Copies the definitions of the files src parsed that haven't been included
+// here yet, as if this parser had parsed them. Returns false, without
+// changing anything, if any of them clash with definitions here.
+bool Parser::ImportDefinitions(const Parser &src) {
+  std::set<std::string> files;
+  for (auto it = src.included_files_.begin(); it != src.included_files_.end();
+       ++it) {
+    if (included_files_.find(it->first) == included_files_.end())
+      files.insert(it->first);
+  }
+  if (!CanImportSymbols(src.structs_, files, structs_) ||
+      !CanImportSymbols(src.enums_, files, enums_) ||
+      !CanImportSymbols(src.services_, files, services_)) {
+    return false;
+  }
+
+  std::map<const StructDef *, StructDef *> structs;
+  std::map<const EnumDef *, EnumDef *> enums;
+  std::map<const ServiceDef *, ServiceDef *> services;
+  ImportSymbols(src.structs_, files, &structs_, &structs);
+  ImportSymbols(src.enums_, files, &enums_, &enums);
+  ImportSymbols(src.services_, files, &services_, &services);
+  auto is_new = [&](const Definition &def) {
+    return files.find(def.file) != files.end();
+  };
+
+  std::map<const Namespace *, Namespace *> namespaces;
+  auto copy_type = [&](const Type &type) {
+    auto copy = type;
+    if (type.struct_def) copy.struct_def = structs[type.struct_def];
+    if (type.enum_def) copy.enum_def = enums[type.enum_def];
+    return copy;
+  };
+  auto copy_value = [&](const Value &val) {
+    auto copy = new Value(val);
+    copy->type = copy_type(val.type);
+    return copy;
+  };
+  auto copy_definition = [&](const Definition &def, Definition *copy) {
+    copy->name = def.name;
+    copy->file = def.file;
+    copy->doc_comment = def.doc_comment;
+    CopySymbolTable(def.attributes, &copy->attributes, copy_value);
+    copy->generated = def.generated;
+    if (def.defined_namespace) {  // Not set for fields.
+      auto &ns = namespaces[def.defined_namespace];
+      if (!ns) {
+        ns = new Namespace(*def.defined_namespace);
+        namespaces_.push_back(ns);
+      }
+      copy->defined_namespace = ns;
+    }
+    copy->serialized_location = def.serialized_location;
+    copy->index = def.index;
+  };
+
+  for (auto it = src.structs_.vec.begin(); it != src.structs_.vec.end();
+       ++it) {
+    auto &def = **it;
+    if (!is_new(def)) continue;
+    auto &copy = *structs[&def];
+    copy_definition(def, &copy);
+    CopySymbolTable(def.fields, &copy.fields, [&](const FieldDef &field) {
+      auto f = new FieldDef();
+      copy_definition(field, f);
+      f->value = field.value;
+      f->value.type = copy_type(field.value.type);
+      f->deprecated = field.deprecated;
+      f->required = field.required;
+      f->key = field.key;
+      f->native_inline = field.native_inline;
+      f->padding = field.padding;
+      return f;
+    });
+    copy.fixed = def.fixed;
+    copy.predecl = def.predecl;
+    copy.sortbysize = def.sortbysize;
+    copy.has_key = def.has_key;
+    copy.minalign = def.minalign;
+    copy.bytesize = def.bytesize;
+  }
+  for (auto it = src.enums_.vec.begin(); it != src.enums_.vec.end(); ++it) {
+    auto &def = **it;
+    if (!is_new(def)) continue;
+    auto &copy = *enums[&def];
+    copy_definition(def, &copy);
+    CopySymbolTable(def.vals, &copy.vals, [&](const EnumVal &val) {
+      auto v = new EnumVal(val.name, val.value);
+      v->doc_comment = val.doc_comment;
+      v->struct_def = val.struct_def ? structs[val.struct_def] : nullptr;
+      return v;
+    });
+    copy.is_union = def.is_union;
+    copy.underlying_type = copy_type(def.underlying_type);
+  }
+  for (auto it = src.services_.vec.begin(); it != src.services_.vec.end();
+       ++it) {
+    auto &def = **it;
+    if (!is_new(def)) continue;
+    auto &copy = *services[&def];
+    copy_definition(def, &copy);
+    CopySymbolTable(def.calls, &copy.calls, [&](const RPCCall &call) {
+      auto c = new RPCCall();
+      c->name = call.name;
+      CopySymbolTable(call.attributes, &c->attributes, copy_value);
+      c->request = structs[call.request];
+      c->response = structs[call.response];
+      return c;
+    });
+  }
+  for (auto it = src.types_.symbols().begin();
+       it != src.types_.symbols().end(); ++it) {
+    auto &type = *it->second;
+    if ((type.struct_def && is_new(*type.struct_def)) ||
+        (type.enum_def && is_new(*type.enum_def))) {
+      types_.Add(it->first, new Type(copy_type(type)));
+    }
+  }
+
+  for (auto it = files.begin(); it != files.end(); ++it) {
+    included_files_[*it] = true;
+    auto included = src.files_included_per_file_.find(*it);
+    if (included != src.files_included_per_file_.end())
+      files_included_per_file_[*it] = included->second;
+  }
+  for (auto it = src.native_included_files_.begin();
+       it != src.native_included_files_.end(); ++it) {
+    if (std::find(native_included_files_.begin(), native_included_files_.end(),
+                  *it) == native_included_files_.end())
+      native_included_files_.push_back(*it);
+  }
+  known_attributes_.insert(src.known_attributes_.begin(),
+                           src.known_attributes_.end());
+  if (src.root_struct_def_) root_struct_def_ = structs[src.root_struct_def_];
+  if (!src.file_identifier_.empty()) file_identifier_ = src.file_identifier_;
+  if (!src.file_extension_.empty()) file_extension_ = src.file_extension_;
+  return true;
+}
+
 std::set<std::string> Parser::GetIncludedFilesRecursive(
     const std::string &file_name) const {
   std::set<std::string> included_files;
@@ -2101,7 +2563,7 @@ Offset<reflection::Field> FieldDef::Serialize(FlatBufferBuilder *builder,
                                    ? StringToInt(value.constant.c_str())
                                    : 0,
                                  IsFloat(value.type.base_type)
-                                   ? strtod(value.constant.c_str(), nullptr)
+                                   ? StringToDouble(value.constant.c_str())
                                    : 0.0,
                                  deprecated,
                                  required,
@@ -2149,7 +2611,10 @@ flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<
     Definition::SerializeAttributes(FlatBufferBuilder *builder,
                                     const Parser &parser) const {
   std::vector<flatbuffers::Offset<reflection::KeyValue>> attrs;
-  for (auto kv = attributes.dict.begin(); kv != attributes.dict.end(); ++kv) {
+  // Serialize in name order, independent of the order in the schema.
+  auto sorted = attributes.symbols();
+  std::sort(sorted.begin(), sorted.end());
+  for (auto kv = sorted.begin(); kv != sorted.end(); ++kv) {
     auto it = parser.known_attributes_.find(kv->first);
     assert(it != parser.known_attributes_.end());
     if (!it->second) {  // Custom attribute.
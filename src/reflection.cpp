@@ -53,7 +53,7 @@ double GetAnyValueF(reflection::BaseType type, const uint8_t *data) {
     case reflection::String: {
       auto s = reinterpret_cast<const String *>(ReadScalar<uoffset_t>(data) +
                                                 data);
-      return s ? strtod(s->c_str(), nullptr) : 0.0;
+      return s ? StringToDouble(s->c_str()) : 0.0;
     }
     default: return static_cast<double>(GetAnyValueI(type, data));
   }
@@ -142,7 +142,7 @@ void SetAnyValueS(reflection::BaseType type, uint8_t *data, const char *val) {
   switch (type) {
     case reflection::Float:
     case reflection::Double:
-      SetAnyValueF(type, data, strtod(val, nullptr));
+      SetAnyValueF(type, data, StringToDouble(val));
       break;
     // TODO: support strings.
     default: SetAnyValueI(type, data, StringToInt(val)); break;
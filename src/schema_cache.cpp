@@ -0,0 +1,30 @@
+/*
+ * Copyright 2017 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flatbuffers/schema_cache.h"
+
+namespace flatbuffers {
+
+// Kept out of idl_parser.cpp, so the parser itself doesn't depend on the
+// cache (and its locking).
+bool Parser::ImportFromSchemaCache(const std::string &filepath,
+                                   const std::string &contents,
+                                   const char **include_paths) {
+  auto cached = schema_cache_->Lookup(filepath, contents, include_paths, opts);
+  return cached && ImportDefinitions(*cached);
+}
+
+}  // namespace flatbuffers
@@ -16,6 +16,12 @@
 
 #include "flatbuffers/util.h"
 
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
 namespace flatbuffers {
 
 bool FileExistsRaw(const char *name) {
@@ -69,6 +75,101 @@ bool DirExists(const char *name) {
   return (file_info.st_mode & FLATBUFFERS_S_IFDIR) != 0;
 }
 
+bool MappedFile::Open(const char *name) {
+  Close();
+  if (g_load_file_function == LoadFileRaw && !DirExists(name)) {
+    #ifdef _WIN32
+      auto file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+      if (file == INVALID_HANDLE_VALUE) return false;
+      LARGE_INTEGER size;
+      HANDLE mapping = nullptr;
+      if (GetFileSizeEx(file, &size) && size.QuadPart > 0 &&
+          static_cast<uint64_t>(size.QuadPart) <=
+            static_cast<uint64_t>((std::numeric_limits<size_t>::max)())) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0,
+                                     nullptr);
+      }
+      CloseHandle(file);  // The mapping keeps the file open.
+      if (mapping) {
+        auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view) {
+          mapping_ = mapping;
+          data_ = static_cast<const char *>(view);
+          size_ = static_cast<size_t>(size.QuadPart);
+          return true;
+        }
+        CloseHandle(mapping);
+      }
+    #else
+      auto fd = open(name, O_RDONLY);
+      if (fd < 0) return false;
+      struct stat file_info;
+      void *view = MAP_FAILED;
+      if (fstat(fd, &file_info) == 0 && S_ISREG(file_info.st_mode) &&
+          file_info.st_size > 0 &&
+          static_cast<uint64_t>(file_info.st_size) <=
+            static_cast<uint64_t>(std::numeric_limits<size_t>::max())) {
+        view = mmap(nullptr, static_cast<size_t>(file_info.st_size),
+                    PROT_READ, MAP_PRIVATE, fd, 0);
+      }
+      close(fd);  // The mapping keeps the file open.
+      if (view != MAP_FAILED) {
+        mapping_ = view;
+        data_ = static_cast<const char *>(view);
+        size_ = static_cast<size_t>(file_info.st_size);
+        return true;
+      }
+    #endif
+  }
+  // Empty files, pipes etc. can't be mapped.
+  if (!LoadFile(name, true, &loaded_)) return false;
+  data_ = loaded_.c_str();
+  size_ = loaded_.size();
+  return true;
+}
+
+void MappedFile::Close() {
+  if (mapping_) {
+    #ifdef _WIN32
+      UnmapViewOfFile(data_);
+      CloseHandle(mapping_);
+    #else
+      munmap(mapping_, size_);
+    #endif
+  }
+  mapping_ = nullptr;
+  data_ = nullptr;
+  size_ = 0;
+  std::string().swap(loaded_);
+}
+
+bool ReadSizePrefixedStream(FILE *stream, const BufferSink &sink,
+                            std::string *error) {
+  std::vector<uint8_t> buf;
+  for (uint64_t offset = 0;; ) {
+    uint8_t prefix[sizeof(uoffset_t)];
+    auto read = fread(prefix, 1, sizeof(prefix), stream);
+    if (!read && feof(stream)) return true;
+    if (read < sizeof(prefix)) break;
+    // A buffer holds at least the offset of its root table.
+    auto size = ReadScalar<uoffset_t>(prefix);
+    if (size < sizeof(uoffset_t) || size > FLATBUFFERS_MAX_BUFFER_SIZE) {
+      *error = "invalid buffer size " + NumToString(size) + " at offset " +
+               NumToString(offset);
+      return false;
+    }
+    buf.resize(sizeof(prefix) + size);
+    memcpy(buf.data(), prefix, sizeof(prefix));
+    if (fread(buf.data() + sizeof(prefix), 1, size, stream) < size) break;
+    if (!sink(buf.data(), buf.size())) return false;
+    offset += buf.size();
+  }
+  *error = ferror(stream) ? "unable to read the stream"
+                          : "the stream ends in the middle of a buffer";
+  return false;
+}
+
 LoadFileFunction SetLoadFileFunction(LoadFileFunction load_file_function) {
   LoadFileFunction previous_function = g_load_file_function;
   g_load_file_function = load_file_function ? load_file_function : LoadFileRaw;
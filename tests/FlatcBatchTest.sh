@@ -0,0 +1,86 @@
+#!/bin/bash -eu
+#
+# Copyright 2017 Google Inc. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Checks that flatc --batch writes the same files, and fails with the same
+# error, as converting the same inputs one at a time.
+# Usage: FlatcBatchTest.sh [path to flatc]
+
+flatc=${1:-$(dirname $0)/../flatc}
+flatc="$(cd "$(dirname ${flatc})" && pwd)/$(basename ${flatc})"
+pushd "$(dirname $0)" >/dev/null
+tmp_dir="$(mktemp -d)"
+trap "rm -rf ${tmp_dir}" EXIT
+
+for name in a b c d e f; do
+  cp monsterdata_test.json ${tmp_dir}/${name}.json
+  cp monsterdata_test.mon ${tmp_dir}/bin_${name}.mon
+done
+json=(${tmp_dir}/{a,b,c,d,e,f}.json)
+binaries=(${tmp_dir}/bin_{a,b,c,d,e,f}.mon)
+
+# Runs flatc with the given arguments, writing to out_<name>, and keeps its
+# exit status and what it printed in <name>.status and <name>.out.
+function convert() {
+  local name=$1
+  shift
+  local status=0
+  ${flatc} -o ${tmp_dir}/out_${name} --binary --json "$@" \
+    >${tmp_dir}/${name}.out 2>&1 || status=$?
+  echo ${status} >${tmp_dir}/${name}.status
+}
+
+function fail() {
+  echo "FlatcBatchTest: $1"
+  exit 1
+}
+
+convert serial monster_test.fbs "${json[@]}" -- "${binaries[@]}"
+convert batch --batch --jobs 4 monster_test.fbs "${json[@]}" -- \
+  "${binaries[@]}"
+[ "$(cat ${tmp_dir}/batch.status)" == 0 ] || fail "--batch failed"
+diff -r ${tmp_dir}/out_serial ${tmp_dir}/out_batch ||
+  fail "--batch output differs from serial conversion"
+grep -q "^converted 12 files .* on 4 threads" ${tmp_dir}/batch.out ||
+  fail "unexpected --batch summary: $(cat ${tmp_dir}/batch.out)"
+
+# Fewer files than --jobs only use as many threads as there are files.
+convert few --batch --jobs 8 monster_test.fbs ${json[0]} ${json[1]}
+grep -q " on 2 threads" ${tmp_dir}/few.out ||
+  fail "unexpected --batch summary: $(cat ${tmp_dir}/few.out)"
+
+# With several bad files, both report the first of them, and convert all the
+# files before it.
+echo "{ name: \"c\", hp: \"x\" }" >${tmp_dir}/c.json
+echo "{ name: \"e\", nope: 1 }" >${tmp_dir}/e.json
+rm -rf ${tmp_dir}/out_serial ${tmp_dir}/out_batch
+convert serial monster_test.fbs "${json[@]}"
+convert batch --batch --jobs 4 monster_test.fbs "${json[@]}"
+[ "$(cat ${tmp_dir}/serial.status)" != 0 ] || fail "bad input accepted"
+[ "$(cat ${tmp_dir}/batch.status)" == "$(cat ${tmp_dir}/serial.status)" ] ||
+  fail "--batch exit status differs from serial conversion"
+diff ${tmp_dir}/serial.out ${tmp_dir}/batch.out ||
+  fail "--batch error differs from serial conversion"
+grep -q "c.json" ${tmp_dir}/batch.out || fail "wrong file reported"
+for name in a b; do
+  for ext in json mon; do
+    cmp ${tmp_dir}/out_serial/${name}.${ext} \
+        ${tmp_dir}/out_batch/${name}.${ext} ||
+      fail "--batch didn't convert ${name}.json before the error"
+  done
+done
+
+echo "FlatcBatchTest: OK"
+popd >/dev/null
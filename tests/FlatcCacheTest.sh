@@ -0,0 +1,87 @@
+#!/bin/bash -eu
+#
+# Copyright 2017 Google Inc. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Checks which schemas flatc --cache compiles again: only those whose
+# options, contents, included files or outputs changed.
+# Usage: FlatcCacheTest.sh [path to flatc]
+
+flatc=${1:-$(dirname $0)/../flatc}
+flatc="$(cd "$(dirname ${flatc})" && pwd)/$(basename ${flatc})"
+tmp_dir="$(mktemp -d)"
+trap "rm -rf ${tmp_dir}" EXIT
+pushd ${tmp_dir} >/dev/null
+
+echo "table Inc { a:int; }" >inc.fbs
+echo "include \"inc.fbs\"; table A { inc:Inc; } root_type A;" >a.fbs
+echo "table B { b:int; } root_type B;" >b.fbs
+
+function compile() {
+  ${flatc} --cpp --jobs 2 --cache cache.txt -o out "$@" a.fbs b.fbs
+}
+
+function fail() {
+  echo "FlatcCacheTest: $1"
+  exit 1
+}
+
+# Outputs that flatc skips keep whatever they hold, so overwriting them shows
+# which ones were generated again.
+function mark_outputs() {
+  echo stale >out/a_generated.h
+  echo stale >out/b_generated.h
+}
+
+function expect_compiled() {
+  for schema in a b; do
+    local output=$(cat out/${schema}_generated.h 2>/dev/null || true)
+    if [[ " $* " == *" ${schema} "* ]]; then
+      [ "${output}" != stale ] && [ -n "${output}" ] ||
+        fail "$1: ${schema}.fbs was not compiled"
+    else
+      [ "${output}" == stale ] || fail "$1: ${schema}.fbs was compiled"
+    fi
+  done
+}
+
+compile
+[ -s out/a_generated.h ] && [ -s out/b_generated.h ] ||
+  fail "nothing generated"
+
+mark_outputs
+compile
+expect_compiled "unchanged"
+
+mark_outputs
+echo "table Inc { a:int; b:int; }" >inc.fbs
+compile
+expect_compiled "included file changed" a
+
+mark_outputs
+compile --gen-mutable
+expect_compiled "option changed" a b
+
+mark_outputs
+rm out/b_generated.h
+compile --gen-mutable
+expect_compiled "output deleted" b
+
+mark_outputs
+echo "table B { b:long; } root_type B;" >b.fbs
+compile --gen-mutable
+expect_compiled "schema changed" b
+
+echo "FlatcCacheTest: OK"
+popd >/dev/null
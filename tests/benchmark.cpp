@@ -0,0 +1,492 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Timing of the builder, verifier, parser and text generator on large inputs.
+// The behavior measured here is tested in test.cpp, this only checks enough to
+// know the numbers are for work that actually succeeded.
+// Run from the root of the repository, like flattests.
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/util.h"
+
+#include "monster_test_generated.h"
+#include "hash_index/hash_index_test_generated.h"
+
+#ifndef FLATBUFFERS_CPP98_STL
+  #include "flatbuffers/verified_buffer_cache.h"
+#endif
+#if FLATBUFFERS_HAS_THREADS
+  #include <atomic>
+  #include <chrono>
+  #include <thread>
+#endif
+
+#include <ctime>
+
+using namespace MyGame::Example;
+
+#define BENCHMARK_OUTPUT_LINE(...) \
+  { printf(__VA_ARGS__); printf("\n"); }
+
+int benchmark_fails = 0;
+
+#define BENCHMARK_CHECK(exp) \
+  if (!(exp)) { \
+    BENCHMARK_OUTPUT_LINE("BENCHMARK FAILED: %s:%d, %s", __FILE__, __LINE__, \
+                          #exp); \
+    benchmark_fails++; \
+    return; \
+  }
+
+double PerItem(clock_t elapsed, double scale, double items) {
+  return elapsed * scale / CLOCKS_PER_SEC / items;
+}
+
+double MegabytesPerSecond(size_t bytes, clock_t elapsed) {
+  return bytes * static_cast<double>(CLOCKS_PER_SEC) /
+         (elapsed ? elapsed : 1) / 1e6;
+}
+
+bool LoadMonsterSchema(flatbuffers::Parser *parser) {
+  std::string schemafile;
+  const char *include_directories[] = { "tests", nullptr };
+  return flatbuffers::LoadFile("tests/monster_test.fbs", false, &schemafile) &&
+         parser->Parse(schemafile.c_str(), include_directories,
+                       "tests/monster_test.fbs");
+}
+
+// A vector of many copies of the test data, as one JSON object.
+std::string ManyMonstersJson(const std::string &monster, int num_monsters) {
+  std::string json = "{ name: \"root\", testarrayoftables: [";
+  for (int i = 0; i < num_monsters; i++) {
+    if (i) json += ",";
+    json += monster;
+  }
+  return json + "] }";
+}
+
+// Builds tables that all have a distinct vtable, then the same tables again,
+// which should all share the first set of vtables. The time per table should
+// stay roughly flat as the number of distinct vtables grows.
+void VTableDedupBenchmark() {
+  const flatbuffers::voffset_t num_fields = 17;  // Enough for 100k layouts.
+  for (int num_vtables = 10; num_vtables <= 100000; num_vtables *= 10) {
+    flatbuffers::FlatBufferBuilder builder;
+    auto start_time = clock();
+    for (int pass = 0; pass < 2; pass++) {
+      for (int i = 0; i < num_vtables; i++) {
+        auto mask = static_cast<uint32_t>(i + 1);
+        builder.PreAlign<uint32_t>(0);
+        auto start = builder.StartTable();
+        for (flatbuffers::voffset_t f = 0; f < num_fields; f++) {
+          if (mask & (1 << f)) {
+            builder.AddElement<uint32_t>(flatbuffers::FieldIndexToOffset(f),
+                                         f + 1u, 0);
+          }
+        }
+        builder.EndTable(start, num_fields);
+      }
+    }
+    auto elapsed = clock() - start_time;
+    BENCHMARK_OUTPUT_LINE("vtable dedup: %d distinct vtables: %.3f usec/table",
+                          num_vtables,
+                          PerItem(elapsed, 1e6, 2.0 * num_vtables));
+  }
+}
+
+// Cost per string of CreateSharedString, on many repeats of 1000 strings.
+void SharedStringBenchmark() {
+  const int num_strings = 100000;
+  std::vector<std::string> tags;
+  for (int i = 0; i < 1000; i++) {
+    tags.push_back("tag-" + flatbuffers::NumToString(i * 7919));
+  }
+  flatbuffers::FlatBufferBuilder builder;
+  auto start_time = clock();
+  for (int i = 0; i < num_strings; i++) {
+    builder.CreateSharedString(tags[i % tags.size()]);
+  }
+  auto elapsed = clock() - start_time;
+  BENCHMARK_CHECK(builder.GetSize() < 16 * tags.size());
+  BENCHMARK_OUTPUT_LINE("shared strings: %.3f nsec/string",
+                        PerItem(elapsed, 1e9, num_strings));
+}
+
+// Compares verifying a large vector of strings in one batch with verifying
+// each string individually.
+void VerifyVectorOfStringsBenchmark() {
+  const int num_strings = 100000;
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<std::string> strings;
+  for (int i = 0; i < num_strings; i++) {
+    strings.push_back("string" + flatbuffers::NumToString(i));
+  }
+  auto name = builder.CreateString("MyMonster");
+  auto vec = builder.CreateVectorOfStrings(strings);
+  MonsterBuilder mb(builder);
+  mb.add_name(name);
+  mb.add_testarrayofstring(vec);
+  FinishMonsterBuffer(builder, mb.Finish());
+
+  auto strs = GetMonster(builder.GetBufferPointer())->testarrayofstring();
+  const int iterations = 10;
+  bool ok = true;
+  auto start_time = clock();
+  for (int i = 0; i < iterations; i++) {
+    flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                   builder.GetSize());
+    ok = verifier.VerifyVectorOfStrings(strs) && ok;
+  }
+  auto batched = clock() - start_time;
+  start_time = clock();
+  for (int i = 0; i < iterations; i++) {
+    flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                   builder.GetSize());
+    for (flatbuffers::uoffset_t j = 0; j < strs->size(); j++) {
+      ok = verifier.Verify(strs->Get(j)) && ok;
+    }
+  }
+  auto individual = clock() - start_time;
+  BENCHMARK_CHECK(ok);
+  BENCHMARK_OUTPUT_LINE("verify vector of strings: %.3f nsec/string batched, "
+                        "%.3f nsec/string individually",
+                        PerItem(batched, 1e9, iterations * num_strings),
+                        PerItem(individual, 1e9, iterations * num_strings));
+}
+
+// Wall time of verifying a large vector of tables serially and with a
+// parallel_for that uses a few threads.
+void ParallelVerifierBenchmark() {
+  #if FLATBUFFERS_HAS_THREADS
+  const int num_monsters = 200000;
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < num_monsters; i++) {
+    auto name = builder.CreateString("monster" + flatbuffers::NumToString(i));
+    auto inventory = builder.CreateVector(std::vector<uint8_t>(8, 1));
+    monsters.push_back(CreateMonster(builder, nullptr, 0, 0, name, inventory));
+  }
+  auto tables = builder.CreateVector(monsters);
+  auto name = builder.CreateString("root");
+  MonsterBuilder mb(builder);
+  mb.add_name(name);
+  mb.add_testarrayoftables(tables);
+  FinishMonsterBuffer(builder, mb.Finish());
+
+  flatbuffers::parallel_for_function_t parallel_for =
+      [](size_t count, const std::function<void (size_t)> &task) {
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+      threads.push_back(std::thread([&]() {
+        for (size_t i; (i = next++) < count; ) task(i);
+      }));
+    }
+    for (auto it = threads.begin(); it != threads.end(); ++it) it->join();
+  };
+
+  const size_t max_tables = num_monsters + 1;
+  typedef std::chrono::steady_clock steady_clock;
+  auto start_time = steady_clock::now();
+  flatbuffers::Verifier serial(builder.GetBufferPointer(), builder.GetSize(),
+                               64, max_tables);
+  BENCHMARK_CHECK(VerifyMonsterBuffer(serial));
+  auto serial_time = steady_clock::now() - start_time;
+  start_time = steady_clock::now();
+  flatbuffers::Verifier parallel(builder.GetBufferPointer(),
+                                 builder.GetSize(), 64, max_tables);
+  BENCHMARK_CHECK(parallel.VerifyBuffer<Monster>(MonsterIdentifier(),
+                                                 parallel_for, 1000));
+  auto parallel_time = steady_clock::now() - start_time;
+  typedef std::chrono::duration<double, std::milli> msec;
+  BENCHMARK_OUTPUT_LINE("parallel verifier: %.3f msec serial, %.3f msec with "
+                        "4 threads", msec(serial_time).count(),
+                        msec(parallel_time).count());
+  #endif
+}
+
+// Cost of a lookup in a large sorted vector of tables, by binary search,
+// through the hash index, and batched.
+void LookupByKeyBenchmark() {
+  using namespace HashIndexTest;
+  const int num_items = 100000;
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Item>> items;
+  std::vector<std::string> names;
+  for (int i = 0; i < num_items; i++) {
+    auto num = flatbuffers::NumToString(i * 2 + 1000000);
+    names.push_back("item" + num);
+    items.push_back(CreateItem(builder, builder.CreateString(names.back())));
+  }
+  auto tables = builder.CreateVectorOfSortedTables(&items);
+  auto index = builder.CreateKeyHashIndex(items);
+  FinishInventoryBuffer(builder, CreateInventory(builder, tables, index));
+  auto root = GetInventory(builder.GetBufferPointer());
+  auto vec = root->items();
+
+  int found = 0;
+  auto start_time = clock();
+  for (int i = 0; i < num_items; i++) {
+    found += vec->LookupByKey(names[i].c_str()) != nullptr;
+  }
+  auto searched = clock() - start_time;
+  start_time = clock();
+  for (int i = 0; i < num_items; i++) {
+    found += root->items_by_key(names[i].c_str()) != nullptr;
+  }
+  auto hashed = clock() - start_time;
+  BENCHMARK_CHECK(found == 2 * num_items);
+  BENCHMARK_OUTPUT_LINE("lookup by key: %.3f nsec/lookup by binary search, "
+                        "%.3f nsec/lookup hashed, in %d tables",
+                        PerItem(searched, 1e9, num_items),
+                        PerItem(hashed, 1e9, num_items), num_items);
+
+  // Keys in between existing ones, and every other existing key.
+  std::vector<std::string> batch_names;
+  std::vector<const char *> batch;
+  for (int i = 0; i < num_items; i++) {
+    batch_names.push_back("item" +
+                          flatbuffers::NumToString(i * 4 + 1000001));
+    batch_names.push_back("item" +
+                          flatbuffers::NumToString(i * 4 + 1000002));
+  }
+  for (size_t i = 0; i < batch_names.size(); i++) {
+    batch.push_back(batch_names[i].c_str());
+  }
+  start_time = clock();
+  auto results = vec->LookupByKeys(batch);
+  auto batched = clock() - start_time;
+  BENCHMARK_CHECK(results.size() == batch.size());
+  BENCHMARK_OUTPUT_LINE("lookup by keys: %.3f nsec/key batched",
+                        PerItem(batched, 1e9,
+                                static_cast<double>(batch.size())));
+}
+
+// Cost of a VerifiedBufferCache hit compared to a full verification.
+void VerifiedBufferCacheBenchmark() {
+  #ifndef FLATBUFFERS_CPP98_STL
+  std::string rawbuf;
+  BENCHMARK_CHECK(flatbuffers::LoadFile("tests/monsterdata_test.mon", true,
+                                        &rawbuf));
+  auto flatbuf = reinterpret_cast<const uint8_t *>(rawbuf.c_str());
+  flatbuffers::VerifiedBufferCache cache(2);
+  const int iterations = 10000;
+  bool ok = true;
+  auto start_time = clock();
+  for (int i = 0; i < iterations; i++) {
+    flatbuffers::Verifier verifier(flatbuf, rawbuf.length());
+    ok = VerifyMonsterBuffer(verifier) && ok;
+  }
+  auto uncached = clock() - start_time;
+  start_time = clock();
+  for (int i = 0; i < iterations; i++) {
+    ok = cache.VerifyBuffer<Monster>(flatbuf, rawbuf.length(),
+                                     MonsterIdentifier()) && ok;
+  }
+  auto cached = clock() - start_time;
+  BENCHMARK_CHECK(ok);
+  BENCHMARK_OUTPUT_LINE("verified buffer cache: %.3f usec/buffer verified, "
+                        "%.3f usec/buffer cached",
+                        PerItem(uncached, 1e6, iterations),
+                        PerItem(cached, 1e6, iterations));
+  #endif
+}
+
+// Throughput of Parser and of the generated JSON parser on many copies of the
+// test data.
+void ParseJsonBenchmark() {
+  std::string jsonfile;
+  BENCHMARK_CHECK(flatbuffers::LoadFile("tests/monsterdata_test.json", false,
+                                        &jsonfile));
+  flatbuffers::Parser parser;
+  BENCHMARK_CHECK(LoadMonsterSchema(&parser));
+  auto json = ManyMonstersJson(jsonfile, 1000);
+  auto start_time = clock();
+  BENCHMARK_CHECK(parser.Parse(json.c_str()));
+  auto parser_time = clock() - start_time;
+  flatbuffers::FlatBufferBuilder fbb;
+  start_time = clock();
+  BENCHMARK_CHECK(ParseMonsterFromJson(json.c_str(), json.size(), fbb));
+  auto generated_time = clock() - start_time;
+  BENCHMARK_OUTPUT_LINE("parse json: Parser %.1f MB/s, generated %.1f MB/s",
+                        MegabytesPerSecond(json.length(), parser_time),
+                        MegabytesPerSecond(json.length(), generated_time));
+}
+
+// Throughput of Parser on a schema with many types and enum values, and on
+// JSON for tables with many fields, where most of the time goes into looking
+// names up in SymbolTables.
+void SymbolTableBenchmark() {
+  const int num_enums = 50;
+  const int num_values = 200;
+  const int num_tables = 20;
+  const int num_fields = 400;
+  std::string schema;
+  for (int e = 0; e < num_enums; e++) {
+    schema += "enum Enum" + flatbuffers::NumToString(e) + " : short { ";
+    for (int v = 0; v < num_values; v++) {
+      schema += "value" + flatbuffers::NumToString(v) + ", ";
+    }
+    schema += "}\n";
+  }
+  for (int t = 0; t < num_tables; t++) {
+    schema += "table Table" + flatbuffers::NumToString(t) + " { ";
+    for (int f = 0; f < num_fields; f++) {
+      auto n = flatbuffers::NumToString(f);
+      schema += f % 2 ? "field" + n + ":int; "
+                      : "field" + n + ":Enum" +
+                        flatbuffers::NumToString(f % num_enums) + "; ";
+    }
+    schema += "}\n";
+  }
+  schema += "table Rows { rows:[Table0]; }\nroot_type Rows;\n";
+
+  const int iterations = 10;
+  auto start_time = clock();
+  for (int i = 0; i < iterations; i++) {
+    flatbuffers::Parser parser;
+    BENCHMARK_CHECK(parser.Parse(schema.c_str()));
+  }
+  auto schema_time = clock() - start_time;
+  BENCHMARK_OUTPUT_LINE("parse schema: %.1f MB/s, %.3f msec/schema with %d "
+                        "enums and %d tables",
+                        MegabytesPerSecond(schema.length() * iterations,
+                                           schema_time),
+                        PerItem(schema_time, 1e3, iterations),
+                        num_enums, num_tables);
+
+  const int num_rows = 500;
+  std::string json = "{ rows: [";
+  for (int r = 0; r < num_rows; r++) {
+    json += r ? ", {" : "{";
+    for (int f = 0; f < num_fields; f++) {
+      auto n = flatbuffers::NumToString(f);
+      json += "field" + n + ": " +
+              (f % 2 ? flatbuffers::NumToString(r + f)
+                     : "value" + flatbuffers::NumToString((r + f) %
+                                                          num_values)) +
+              ", ";
+    }
+    json += "}";
+  }
+  json += "] }";
+  flatbuffers::Parser parser;
+  BENCHMARK_CHECK(parser.Parse(schema.c_str()));
+  start_time = clock();
+  BENCHMARK_CHECK(parser.Parse(json.c_str()));
+  auto json_time = clock() - start_time;
+  BENCHMARK_OUTPUT_LINE("parse json: Parser %.1f MB/s on tables with %d "
+                        "fields",
+                        MegabytesPerSecond(json.length(), json_time),
+                        num_fields);
+}
+
+// Throughput of one-shot GenerateText() calls, which set up a generator and
+// a string every time, and of a TextGenerator that is reused between buffers,
+// on the same buffer with strings that need escaping.
+void GenerateTextBenchmark() {
+  flatbuffers::Parser parser;
+  BENCHMARK_CHECK(LoadMonsterSchema(&parser));
+  const int num_monsters = 1000;
+  std::string json = "{ name: \"root\", testarrayoftables: [";
+  for (int i = 0; i < num_monsters; i++) {
+    if (i) json += ",";
+    json += "{ name: \"monster " + flatbuffers::NumToString(i) +
+            " has a fairly long name\\twith \\\"escapes\\\" \\u00e9\\n\", " +
+            "hp: " + flatbuffers::NumToString(i) + " }";
+  }
+  json += "] }";
+  BENCHMARK_CHECK(parser.Parse(json.c_str()));
+  auto buf = parser.builder_.GetBufferPointer();
+
+  const int iterations = 10;
+  bool ok = true;
+  size_t one_shot_bytes = 0;
+  auto start_time = clock();
+  for (int i = 0; i < iterations; i++) {
+    std::string text;
+    ok = GenerateText(parser, buf, &text) && ok;
+    one_shot_bytes += text.length();
+  }
+  auto one_shot = clock() - start_time;
+  flatbuffers::TextGenerator generator(parser);
+  std::string text;
+  start_time = clock();
+  for (int i = 0; i < iterations; i++) {
+    text.clear();
+    ok = generator.Generate(buf, &text) && ok;
+  }
+  auto reused = clock() - start_time;
+  BENCHMARK_CHECK(ok);
+  BENCHMARK_CHECK(one_shot_bytes == text.length() * iterations);
+  BENCHMARK_OUTPUT_LINE("generate json: GenerateText %.1f MB/s, reused "
+                        "TextGenerator %.1f MB/s",
+                        MegabytesPerSecond(one_shot_bytes, one_shot),
+                        MegabytesPerSecond(text.length() * iterations,
+                                           reused));
+}
+
+// How number conversions scale with threads (unlike std::stringstream, which
+// allocates and shares the global locale).
+void NumberConversionBenchmark() {
+  #if FLATBUFFERS_HAS_THREADS
+  const int iterations = 200000;
+  auto convert = [&]() {
+    char buf[flatbuffers::kMaxNumToCharsLength + 1];
+    double sum = 0;
+    for (int i = 0; i < iterations; i++) {
+      *flatbuffers::NumToChars(i * 0.37, buf) = 0;
+      sum += flatbuffers::StringToDouble(buf);
+    }
+    return sum;
+  };
+  typedef std::chrono::steady_clock steady_clock;
+  typedef std::chrono::duration<double, std::nano> nsec;
+  for (int num_threads = 1; num_threads <= 4; num_threads *= 4) {
+    auto start_time = steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+      threads.push_back(std::thread([&]() { convert(); }));
+    }
+    for (auto it = threads.begin(); it != threads.end(); ++it) it->join();
+    auto elapsed = steady_clock::now() - start_time;
+    BENCHMARK_OUTPUT_LINE("number conversion: %.1f nsec/number with %d "
+                          "thread(s)",
+                          nsec(elapsed).count() / (iterations * num_threads),
+                          num_threads);
+  }
+  #endif
+}
+
+int main(int /*argc*/, const char * /*argv*/[]) {
+  VTableDedupBenchmark();
+  SharedStringBenchmark();
+  VerifyVectorOfStringsBenchmark();
+  ParallelVerifierBenchmark();
+  LookupByKeyBenchmark();
+  VerifiedBufferCacheBenchmark();
+  ParseJsonBenchmark();
+  SymbolTableBenchmark();
+  GenerateTextBenchmark();
+  NumberConversionBenchmark();
+
+  if (benchmark_fails) {
+    BENCHMARK_OUTPUT_LINE("%d FAILED BENCHMARKS", benchmark_fails);
+    return 1;
+  }
+  return 0;
+}
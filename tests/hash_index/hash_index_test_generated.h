@@ -0,0 +1,183 @@
+// automatically generated by the FlatBuffers compiler, do not modify
+
+
+#ifndef FLATBUFFERS_GENERATED_HASHINDEXTEST_HASHINDEXTEST_H_
+#define FLATBUFFERS_GENERATED_HASHINDEXTEST_HASHINDEXTEST_H_
+
+#include "flatbuffers/flatbuffers.h"
+
+namespace HashIndexTest {
+
+struct Item;
+
+struct Inventory;
+
+struct Item FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  enum {
+    VT_NAME = 4,
+    VT_VALUE = 6
+  };
+  const flatbuffers::String *name() const {
+    return GetPointer<const flatbuffers::String *>(VT_NAME);
+  }
+  bool KeyCompareLessThan(const Item *o) const {
+    return *name() < *o->name();
+  }
+  int KeyCompareWithValue(const char *val) const {
+    return strcmp(name()->c_str(), val);
+  }
+  uint32_t KeyHash() const {
+    return KeyHash(name()->c_str());
+  }
+  static uint32_t KeyHash(const char *val) {
+    return flatbuffers::HashKey(val);
+  }
+  int32_t value() const {
+    return GetField<int32_t>(VT_VALUE, 0);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyFieldRequired<flatbuffers::uoffset_t>(verifier, VT_NAME) &&
+           verifier.Verify(name()) &&
+           VerifyField<int32_t>(verifier, VT_VALUE) &&
+           verifier.EndTable();
+  }
+};
+
+struct ItemBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_name(flatbuffers::Offset<flatbuffers::String> name) {
+    fbb_.AddOffset(Item::VT_NAME, name);
+  }
+  void add_value(int32_t value) {
+    fbb_.AddElement<int32_t>(Item::VT_VALUE, value, 0);
+  }
+  ItemBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ItemBuilder &operator=(const ItemBuilder &);
+  flatbuffers::Offset<Item> Finish() {
+    const auto end = fbb_.EndTable(start_, 2);
+    auto o = flatbuffers::Offset<Item>(end);
+    fbb_.Required(o, Item::VT_NAME);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<Item> CreateItem(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    flatbuffers::Offset<flatbuffers::String> name = 0,
+    int32_t value = 0) {
+  ItemBuilder builder_(_fbb);
+  builder_.add_value(value);
+  builder_.add_name(name);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<Item> CreateItemDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    const char *name = nullptr,
+    int32_t value = 0) {
+  return HashIndexTest::CreateItem(
+      _fbb,
+      name ? _fbb.CreateString(name) : 0,
+      value);
+}
+
+struct Inventory FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  enum {
+    VT_ITEMS = 4,
+    VT_ITEMS_INDEX = 6
+  };
+  const flatbuffers::Vector<flatbuffers::Offset<Item>> *items() const {
+    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<Item>> *>(VT_ITEMS);
+  }
+  const Item *items_by_key(const char *key) const {
+    auto vec = items();
+    return vec ? vec->LookupByKeyHashed(key, items_index()) : nullptr;
+  }
+  const flatbuffers::Vector<uint32_t> *items_index() const {
+    return GetPointer<const flatbuffers::Vector<uint32_t> *>(VT_ITEMS_INDEX);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, VT_ITEMS) &&
+           verifier.Verify(items()) &&
+           verifier.VerifyVectorOfTables(items()) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, VT_ITEMS_INDEX) &&
+           verifier.Verify(items_index()) &&
+           verifier.VerifyKeyHashIndex(items(), items_index()) &&
+           verifier.EndTable();
+  }
+};
+
+struct InventoryBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_items(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Item>>> items) {
+    fbb_.AddOffset(Inventory::VT_ITEMS, items);
+  }
+  void add_items_index(flatbuffers::Offset<flatbuffers::Vector<uint32_t>> items_index) {
+    fbb_.AddOffset(Inventory::VT_ITEMS_INDEX, items_index);
+  }
+  InventoryBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  InventoryBuilder &operator=(const InventoryBuilder &);
+  flatbuffers::Offset<Inventory> Finish() {
+    const auto end = fbb_.EndTable(start_, 2);
+    auto o = flatbuffers::Offset<Inventory>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<Inventory> CreateInventory(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Item>>> items = 0,
+    flatbuffers::Offset<flatbuffers::Vector<uint32_t>> items_index = 0) {
+  InventoryBuilder builder_(_fbb);
+  builder_.add_items_index(items_index);
+  builder_.add_items(items);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<Inventory> CreateInventoryDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    const std::vector<flatbuffers::Offset<Item>> *items = nullptr,
+    const std::vector<uint32_t> *items_index = nullptr) {
+  return HashIndexTest::CreateInventory(
+      _fbb,
+      items ? _fbb.CreateVector<flatbuffers::Offset<Item>>(*items) : 0,
+      items_index ? _fbb.CreateVector<uint32_t>(*items_index) : 0);
+}
+
+inline const HashIndexTest::Inventory *GetInventory(const void *buf) {
+  return flatbuffers::GetRoot<HashIndexTest::Inventory>(buf);
+}
+
+inline const char *InventoryIdentifier() {
+  return "HIDX";
+}
+
+inline bool InventoryBufferHasIdentifier(const void *buf) {
+  return flatbuffers::BufferHasIdentifier(
+      buf, InventoryIdentifier());
+}
+
+inline bool VerifyInventoryBuffer(
+    flatbuffers::Verifier &verifier) {
+  return verifier.VerifyBuffer<HashIndexTest::Inventory>(InventoryIdentifier());
+}
+
+inline void FinishInventoryBuffer(
+    flatbuffers::FlatBufferBuilder &fbb,
+    flatbuffers::Offset<HashIndexTest::Inventory> root) {
+  fbb.Finish(root, InventoryIdentifier());
+}
+
+}  // namespace HashIndexTest
+
+#endif  // FLATBUFFERS_GENERATED_HASHINDEXTEST_HASHINDEXTEST_H_
@@ -5,6 +5,7 @@
 #define FLATBUFFERS_GENERATED_MONSTERTEST_MYGAME_EXAMPLE_H_
 
 #include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/json_reader.h"
 
 namespace MyGame {
 namespace Example2 {
@@ -122,6 +123,7 @@ struct AnyUnion {
 
   static flatbuffers::NativeTable *UnPack(const void *obj, Any type, const flatbuffers::resolver_function_t *resolver);
   flatbuffers::Offset<void> Pack(flatbuffers::FlatBufferBuilder &_fbb, const flatbuffers::rehasher_function_t *_rehasher = nullptr) const;
+  size_t SizeHint() const;
 
   MonsterT *AsMonster() {
     return type == Any_Monster ?
@@ -254,6 +256,7 @@ struct MonsterT : public flatbuffers::NativeTable {
   typedef Monster TableType;
   MonsterT() {
   }
+  size_t SizeHint() const;
 };
 
 struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
@@ -300,6 +303,7 @@ struct TestSimpleTableWithEnumT : public flatbuffers::NativeTable {
   TestSimpleTableWithEnumT()
       : color(Color_Green) {
   }
+  size_t SizeHint() const;
 };
 
 struct TestSimpleTableWithEnum FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
@@ -313,6 +317,10 @@ struct TestSimpleTableWithEnum FLATBUFFERS_FINAL_CLASS : private flatbuffers::Ta
   bool mutate_color(Color _color) {
     return SetField(VT_COLOR, static_cast<int8_t>(_color));
   }
+  Color color(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<int8_t>(_checker, VT_COLOR)
+           ? color() : Color_Green;
+  }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<int8_t>(verifier, VT_COLOR) &&
@@ -360,6 +368,7 @@ struct StatT : public flatbuffers::NativeTable {
       : val(0),
         count(0) {
   }
+  size_t SizeHint() const;
 };
 
 struct Stat FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
@@ -375,18 +384,30 @@ struct Stat FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   flatbuffers::String *mutable_id() {
     return GetPointer<flatbuffers::String *>(VT_ID);
   }
+  const flatbuffers::String *id(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<flatbuffers::uoffset_t>(_checker, VT_ID)
+           ? _checker.Checked(id()) : nullptr;
+  }
   int64_t val() const {
     return GetField<int64_t>(VT_VAL, 0);
   }
   bool mutate_val(int64_t _val) {
     return SetField(VT_VAL, _val);
   }
+  int64_t val(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<int64_t>(_checker, VT_VAL)
+           ? val() : 0;
+  }
   uint16_t count() const {
     return GetField<uint16_t>(VT_COUNT, 0);
   }
   bool mutate_count(uint16_t _count) {
     return SetField(VT_COUNT, _count);
   }
+  uint16_t count(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<uint16_t>(_checker, VT_COUNT)
+           ? count() : 0;
+  }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<flatbuffers::uoffset_t>(verifier, VT_ID) &&
@@ -496,6 +517,7 @@ struct MonsterT : public flatbuffers::NativeTable {
         testf2(3.0f),
         testf3(0.0f) {
   }
+  size_t SizeHint() const;
 };
 
 /// an example documentation comment: monster object
@@ -537,66 +559,112 @@ struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   Vec3 *mutable_pos() {
     return GetStruct<Vec3 *>(VT_POS);
   }
+  const Vec3 *pos(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<Vec3>(_checker, VT_POS)
+           ? pos() : nullptr;
+  }
   int16_t mana() const {
     return GetField<int16_t>(VT_MANA, 150);
   }
   bool mutate_mana(int16_t _mana) {
     return SetField(VT_MANA, _mana);
   }
+  int16_t mana(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<int16_t>(_checker, VT_MANA)
+           ? mana() : 150;
+  }
   int16_t hp() const {
     return GetField<int16_t>(VT_HP, 100);
   }
   bool mutate_hp(int16_t _hp) {
     return SetField(VT_HP, _hp);
   }
+  int16_t hp(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<int16_t>(_checker, VT_HP)
+           ? hp() : 100;
+  }
   const flatbuffers::String *name() const {
     return GetPointer<const flatbuffers::String *>(VT_NAME);
   }
   flatbuffers::String *mutable_name() {
     return GetPointer<flatbuffers::String *>(VT_NAME);
   }
+  const flatbuffers::String *name(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<flatbuffers::uoffset_t>(_checker, VT_NAME)
+           ? _checker.Checked(name()) : nullptr;
+  }
   bool KeyCompareLessThan(const Monster *o) const {
     return *name() < *o->name();
   }
   int KeyCompareWithValue(const char *val) const {
     return strcmp(name()->c_str(), val);
   }
+  uint32_t KeyHash() const {
+    return KeyHash(name()->c_str());
+  }
+  static uint32_t KeyHash(const char *val) {
+    return flatbuffers::HashKey(val);
+  }
   const flatbuffers::Vector<uint8_t> *inventory() const {
     return GetPointer<const flatbuffers::Vector<uint8_t> *>(VT_INVENTORY);
   }
   flatbuffers::Vector<uint8_t> *mutable_inventory() {
     return GetPointer<flatbuffers::Vector<uint8_t> *>(VT_INVENTORY);
   }
+  const flatbuffers::Vector<uint8_t> *inventory(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<flatbuffers::uoffset_t>(_checker, VT_INVENTORY)
+           ? _checker.Checked(inventory()) : nullptr;
+  }
   Color color() const {
     return static_cast<Color>(GetField<int8_t>(VT_COLOR, 8));
   }
   bool mutate_color(Color _color) {
     return SetField(VT_COLOR, static_cast<int8_t>(_color));
   }
+  Color color(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<int8_t>(_checker, VT_COLOR)
+           ? color() : Color_Blue;
+  }
   Any test_type() const {
     return static_cast<Any>(GetField<uint8_t>(VT_TEST_TYPE, 0));
   }
   bool mutate_test_type(Any _test_type) {
     return SetField(VT_TEST_TYPE, static_cast<uint8_t>(_test_type));
   }
+  Any test_type(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<uint8_t>(_checker, VT_TEST_TYPE)
+           ? test_type() : Any_NONE;
+  }
   const void *test() const {
     return GetPointer<const void *>(VT_TEST);
   }
   void *mutable_test() {
     return GetPointer<void *>(VT_TEST);
   }
+  const void *test(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<flatbuffers::uoffset_t>(_checker, VT_TEST)
+           ? _checker.Checked(test()) : nullptr;
+  }
   const flatbuffers::Vector<const Test *> *test4() const {
     return GetPointer<const flatbuffers::Vector<const Test *> *>(VT_TEST4);
   }
   flatbuffers::Vector<const Test *> *mutable_test4() {
     return GetPointer<flatbuffers::Vector<const Test *> *>(VT_TEST4);
   }
+  const flatbuffers::Vector<const Test *> *test4(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<flatbuffers::uoffset_t>(_checker, VT_TEST4)
+           ? _checker.Checked(test4()) : nullptr;
+  }
   const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *testarrayofstring() const {
     return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(VT_TESTARRAYOFSTRING);
   }
   flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *mutable_testarrayofstring() {
     return GetPointer<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(VT_TESTARRAYOFSTRING);
   }
+  const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *testarrayofstring(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<flatbuffers::uoffset_t>(_checker, VT_TESTARRAYOFSTRING)
+           ? _checker.Checked(testarrayofstring()) : nullptr;
+  }
   /// an example documentation comment: this will end up in the generated code
   /// multiline too
   const flatbuffers::Vector<flatbuffers::Offset<Monster>> *testarrayoftables() const {
@@ -605,18 +673,30 @@ struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   flatbuffers::Vector<flatbuffers::Offset<Monster>> *mutable_testarrayoftables() {
     return GetPointer<flatbuffers::Vector<flatbuffers::Offset<Monster>> *>(VT_TESTARRAYOFTABLES);
   }
+  const flatbuffers::Vector<flatbuffers::Offset<Monster>> *testarrayoftables(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<flatbuffers::uoffset_t>(_checker, VT_TESTARRAYOFTABLES)
+           ? _checker.Checked(testarrayoftables()) : nullptr;
+  }
   const Monster *enemy() const {
     return GetPointer<const Monster *>(VT_ENEMY);
   }
   Monster *mutable_enemy() {
     return GetPointer<Monster *>(VT_ENEMY);
   }
+  const Monster *enemy(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<flatbuffers::uoffset_t>(_checker, VT_ENEMY)
+           ? _checker.Checked(enemy()) : nullptr;
+  }
   const flatbuffers::Vector<uint8_t> *testnestedflatbuffer() const {
     return GetPointer<const flatbuffers::Vector<uint8_t> *>(VT_TESTNESTEDFLATBUFFER);
   }
   flatbuffers::Vector<uint8_t> *mutable_testnestedflatbuffer() {
     return GetPointer<flatbuffers::Vector<uint8_t> *>(VT_TESTNESTEDFLATBUFFER);
   }
+  const flatbuffers::Vector<uint8_t> *testnestedflatbuffer(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<flatbuffers::uoffset_t>(_checker, VT_TESTNESTEDFLATBUFFER)
+           ? _checker.Checked(testnestedflatbuffer()) : nullptr;
+  }
   const MyGame::Example::Monster *testnestedflatbuffer_nested_root() const {
     const uint8_t* data = testnestedflatbuffer()->Data();
     return flatbuffers::GetRoot<MyGame::Example::Monster>(data);
@@ -627,90 +707,150 @@ struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   Stat *mutable_testempty() {
     return GetPointer<Stat *>(VT_TESTEMPTY);
   }
+  const Stat *testempty(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<flatbuffers::uoffset_t>(_checker, VT_TESTEMPTY)
+           ? _checker.Checked(testempty()) : nullptr;
+  }
   bool testbool() const {
     return GetField<uint8_t>(VT_TESTBOOL, 0) != 0;
   }
   bool mutate_testbool(bool _testbool) {
     return SetField(VT_TESTBOOL, static_cast<uint8_t>(_testbool));
   }
+  bool testbool(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<uint8_t>(_checker, VT_TESTBOOL)
+           ? testbool() : false;
+  }
   int32_t testhashs32_fnv1() const {
     return GetField<int32_t>(VT_TESTHASHS32_FNV1, 0);
   }
   bool mutate_testhashs32_fnv1(int32_t _testhashs32_fnv1) {
     return SetField(VT_TESTHASHS32_FNV1, _testhashs32_fnv1);
   }
+  int32_t testhashs32_fnv1(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<int32_t>(_checker, VT_TESTHASHS32_FNV1)
+           ? testhashs32_fnv1() : 0;
+  }
   uint32_t testhashu32_fnv1() const {
     return GetField<uint32_t>(VT_TESTHASHU32_FNV1, 0);
   }
   bool mutate_testhashu32_fnv1(uint32_t _testhashu32_fnv1) {
     return SetField(VT_TESTHASHU32_FNV1, _testhashu32_fnv1);
   }
+  uint32_t testhashu32_fnv1(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<uint32_t>(_checker, VT_TESTHASHU32_FNV1)
+           ? testhashu32_fnv1() : 0;
+  }
   int64_t testhashs64_fnv1() const {
     return GetField<int64_t>(VT_TESTHASHS64_FNV1, 0);
   }
   bool mutate_testhashs64_fnv1(int64_t _testhashs64_fnv1) {
     return SetField(VT_TESTHASHS64_FNV1, _testhashs64_fnv1);
   }
+  int64_t testhashs64_fnv1(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<int64_t>(_checker, VT_TESTHASHS64_FNV1)
+           ? testhashs64_fnv1() : 0;
+  }
   uint64_t testhashu64_fnv1() const {
     return GetField<uint64_t>(VT_TESTHASHU64_FNV1, 0);
   }
   bool mutate_testhashu64_fnv1(uint64_t _testhashu64_fnv1) {
     return SetField(VT_TESTHASHU64_FNV1, _testhashu64_fnv1);
   }
+  uint64_t testhashu64_fnv1(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<uint64_t>(_checker, VT_TESTHASHU64_FNV1)
+           ? testhashu64_fnv1() : 0;
+  }
   int32_t testhashs32_fnv1a() const {
     return GetField<int32_t>(VT_TESTHASHS32_FNV1A, 0);
   }
   bool mutate_testhashs32_fnv1a(int32_t _testhashs32_fnv1a) {
     return SetField(VT_TESTHASHS32_FNV1A, _testhashs32_fnv1a);
   }
+  int32_t testhashs32_fnv1a(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<int32_t>(_checker, VT_TESTHASHS32_FNV1A)
+           ? testhashs32_fnv1a() : 0;
+  }
   uint32_t testhashu32_fnv1a() const {
     return GetField<uint32_t>(VT_TESTHASHU32_FNV1A, 0);
   }
   bool mutate_testhashu32_fnv1a(uint32_t _testhashu32_fnv1a) {
     return SetField(VT_TESTHASHU32_FNV1A, _testhashu32_fnv1a);
   }
+  uint32_t testhashu32_fnv1a(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<uint32_t>(_checker, VT_TESTHASHU32_FNV1A)
+           ? testhashu32_fnv1a() : 0;
+  }
   int64_t testhashs64_fnv1a() const {
     return GetField<int64_t>(VT_TESTHASHS64_FNV1A, 0);
   }
   bool mutate_testhashs64_fnv1a(int64_t _testhashs64_fnv1a) {
     return SetField(VT_TESTHASHS64_FNV1A, _testhashs64_fnv1a);
   }
+  int64_t testhashs64_fnv1a(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<int64_t>(_checker, VT_TESTHASHS64_FNV1A)
+           ? testhashs64_fnv1a() : 0;
+  }
   uint64_t testhashu64_fnv1a() const {
     return GetField<uint64_t>(VT_TESTHASHU64_FNV1A, 0);
   }
   bool mutate_testhashu64_fnv1a(uint64_t _testhashu64_fnv1a) {
     return SetField(VT_TESTHASHU64_FNV1A, _testhashu64_fnv1a);
   }
+  uint64_t testhashu64_fnv1a(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<uint64_t>(_checker, VT_TESTHASHU64_FNV1A)
+           ? testhashu64_fnv1a() : 0;
+  }
   const flatbuffers::Vector<uint8_t> *testarrayofbools() const {
     return GetPointer<const flatbuffers::Vector<uint8_t> *>(VT_TESTARRAYOFBOOLS);
   }
   flatbuffers::Vector<uint8_t> *mutable_testarrayofbools() {
     return GetPointer<flatbuffers::Vector<uint8_t> *>(VT_TESTARRAYOFBOOLS);
   }
+  const flatbuffers::Vector<uint8_t> *testarrayofbools(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<flatbuffers::uoffset_t>(_checker, VT_TESTARRAYOFBOOLS)
+           ? _checker.Checked(testarrayofbools()) : nullptr;
+  }
   float testf() const {
     return GetField<float>(VT_TESTF, 3.14159f);
   }
   bool mutate_testf(float _testf) {
     return SetField(VT_TESTF, _testf);
   }
+  float testf(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<float>(_checker, VT_TESTF)
+           ? testf() : 3.14159f;
+  }
   float testf2() const {
     return GetField<float>(VT_TESTF2, 3.0f);
   }
   bool mutate_testf2(float _testf2) {
     return SetField(VT_TESTF2, _testf2);
   }
+  float testf2(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<float>(_checker, VT_TESTF2)
+           ? testf2() : 3.0f;
+  }
   float testf3() const {
     return GetField<float>(VT_TESTF3, 0.0f);
   }
   bool mutate_testf3(float _testf3) {
     return SetField(VT_TESTF3, _testf3);
   }
+  float testf3(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<float>(_checker, VT_TESTF3)
+           ? testf3() : 0.0f;
+  }
   const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *testarrayofstring2() const {
     return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(VT_TESTARRAYOFSTRING2);
   }
   flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *mutable_testarrayofstring2() {
     return GetPointer<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(VT_TESTARRAYOFSTRING2);
   }
+  const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *testarrayofstring2(flatbuffers::AccessChecker &_checker) const {
+    return CheckedField<flatbuffers::uoffset_t>(_checker, VT_TESTARRAYOFSTRING2)
+           ? _checker.Checked(testarrayofstring2()) : nullptr;
+  }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<Vec3>(verifier, VT_POS) &&
@@ -1003,7 +1143,13 @@ inline void Monster::UnPackTo(MonsterT *_o, const flatbuffers::resolver_function
   (void)_resolver;
 }
 
+inline size_t MonsterT::SizeHint() const {
+  size_t _s = 11;
+  return _s;
+}
+
 inline flatbuffers::Offset<Monster> Monster::Pack(flatbuffers::FlatBufferBuilder &_fbb, const MonsterT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  _fbb.Reserve(_o->SizeHint());
   return CreateMonster(_fbb, _o, _rehasher);
 }
 
@@ -1030,7 +1176,13 @@ inline void TestSimpleTableWithEnum::UnPackTo(TestSimpleTableWithEnumT *_o, cons
   { auto _e = color(); _o->color = _e; };
 }
 
+inline size_t TestSimpleTableWithEnumT::SizeHint() const {
+  size_t _s = 14;
+  return _s;
+}
+
 inline flatbuffers::Offset<TestSimpleTableWithEnum> TestSimpleTableWithEnum::Pack(flatbuffers::FlatBufferBuilder &_fbb, const TestSimpleTableWithEnumT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  _fbb.Reserve(_o->SizeHint());
   return CreateTestSimpleTableWithEnum(_fbb, _o, _rehasher);
 }
 
@@ -1043,6 +1195,25 @@ inline flatbuffers::Offset<TestSimpleTableWithEnum> CreateTestSimpleTableWithEnu
       _color);
 }
 
+inline flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<TestSimpleTableWithEnum>>> CreateVectorOfTestSimpleTableWithEnum(
+    flatbuffers::FlatBufferBuilder &_fbb, const TestSimpleTableWithEnumT *_o, size_t _len) {
+  std::vector<flatbuffers::Offset<TestSimpleTableWithEnum>> _tables(_len);
+  _fbb.StartTableBatch(1);
+  for (size_t _i = 0; _i < _len; _i++) {
+    const auto &_e = _o[_i];
+    const auto _start = _fbb.StartBatchedTable();
+    _fbb.AddBatchedElement<int8_t>(TestSimpleTableWithEnum::VT_COLOR, static_cast<int8_t>(_e.color));
+    _tables[_i] = flatbuffers::Offset<TestSimpleTableWithEnum>(
+        _fbb.EndBatchedTable(_start, 1));
+  }
+  return _fbb.CreateVector(_tables);
+}
+
+inline flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<TestSimpleTableWithEnum>>> CreateVectorOfTestSimpleTableWithEnum(
+    flatbuffers::FlatBufferBuilder &_fbb, const std::vector<TestSimpleTableWithEnumT> &_o) {
+  return CreateVectorOfTestSimpleTableWithEnum(_fbb, _o.data(), _o.size());
+}
+
 inline StatT *Stat::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
   auto _o = new StatT();
   UnPackTo(_o, _resolver);
@@ -1057,7 +1228,14 @@ inline void Stat::UnPackTo(StatT *_o, const flatbuffers::resolver_function_t *_r
   { auto _e = count(); _o->count = _e; };
 }
 
+inline size_t StatT::SizeHint() const {
+  size_t _s = 42;
+  _s += id.size() + 8;
+  return _s;
+}
+
 inline flatbuffers::Offset<Stat> Stat::Pack(flatbuffers::FlatBufferBuilder &_fbb, const StatT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  _fbb.Reserve(_o->SizeHint());
   return CreateStat(_fbb, _o, _rehasher);
 }
 
@@ -1074,6 +1252,28 @@ inline flatbuffers::Offset<Stat> CreateStat(flatbuffers::FlatBufferBuilder &_fbb
       _count);
 }
 
+inline flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Stat>>> CreateVectorOfStat(
+    flatbuffers::FlatBufferBuilder &_fbb, const StatT *_o, size_t _len) {
+  std::vector<flatbuffers::Offset<Stat>> _tables(_len);
+  _fbb.StartTableBatch(8);
+  for (size_t _i = 0; _i < _len; _i++) {
+    const auto &_e = _o[_i];
+    auto _id = _fbb.CreateString(_e.id);
+    const auto _start = _fbb.StartBatchedTable();
+    _fbb.AddBatchedElement<int64_t>(Stat::VT_VAL, _e.val);
+    _fbb.AddBatchedOffset(Stat::VT_ID, _id);
+    _fbb.AddBatchedElement<uint16_t>(Stat::VT_COUNT, _e.count);
+    _tables[_i] = flatbuffers::Offset<Stat>(
+        _fbb.EndBatchedTable(_start, 3));
+  }
+  return _fbb.CreateVector(_tables);
+}
+
+inline flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Stat>>> CreateVectorOfStat(
+    flatbuffers::FlatBufferBuilder &_fbb, const std::vector<StatT> &_o) {
+  return CreateVectorOfStat(_fbb, _o.data(), _o.size());
+}
+
 inline MonsterT *Monster::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
   auto _o = new MonsterT();
   UnPackTo(_o, _resolver);
@@ -1113,7 +1313,24 @@ inline void Monster::UnPackTo(MonsterT *_o, const flatbuffers::resolver_function
   { auto _e = testarrayofstring2(); if (_e) for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->testarrayofstring2.push_back(_e->Get(_i)->str()); } };
 }
 
+inline size_t MonsterT::SizeHint() const {
+  size_t _s = 312;
+  _s += name.size() + 8;
+  _s += inventory.size() * 1 + 7;
+  _s += test.SizeHint();
+  _s += test4.size() * 4 + 8;
+  _s += testarrayofstring.size() * 4 + 10; for (size_t _i = 0; _i < testarrayofstring.size(); _i++) { _s += testarrayofstring[_i].size() + 8; }
+  _s += testarrayoftables.size() * 4 + 10; for (size_t _i = 0; _i < testarrayoftables.size(); _i++) { _s += testarrayoftables[_i]->SizeHint(); }
+  if (enemy) _s += enemy->SizeHint();
+  _s += testnestedflatbuffer.size() * 1 + 7;
+  if (testempty) _s += testempty->SizeHint();
+  _s += testarrayofbools.size() * 1 + 7;
+  _s += testarrayofstring2.size() * 4 + 10; for (size_t _i = 0; _i < testarrayofstring2.size(); _i++) { _s += testarrayofstring2[_i].size() + 8; }
+  return _s;
+}
+
 inline flatbuffers::Offset<Monster> Monster::Pack(flatbuffers::FlatBufferBuilder &_fbb, const MonsterT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  _fbb.Reserve(_o->SizeHint());
   return CreateMonster(_fbb, _o, _rehasher);
 }
 
@@ -1248,6 +1465,24 @@ inline flatbuffers::Offset<void> AnyUnion::Pack(flatbuffers::FlatBufferBuilder &
   }
 }
 
+inline size_t AnyUnion::SizeHint() const {
+  switch (type) {
+    case Any_Monster: {
+      auto ptr = reinterpret_cast<const MonsterT *>(table);
+      return ptr->SizeHint();
+    }
+    case Any_TestSimpleTableWithEnum: {
+      auto ptr = reinterpret_cast<const TestSimpleTableWithEnumT *>(table);
+      return ptr->SizeHint();
+    }
+    case Any_MyGame_Example2_Monster: {
+      auto ptr = reinterpret_cast<const MyGame::Example2::MonsterT *>(table);
+      return ptr->SizeHint();
+    }
+    default: return 0;
+  }
+}
+
 inline void AnyUnion::Reset() {
   switch (type) {
     case Any_Monster: {
@@ -1271,6 +1506,725 @@ inline void AnyUnion::Reset() {
   type = Any_NONE;
 }
 
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, Color *_o);
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, Any *_o);
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, flatbuffers::FlatBufferBuilder &_fbb, Any _type, flatbuffers::Offset<void> *_o);
+}  // namespace Example
+
+namespace Example2 {
+
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<Monster> *_o);
+}  // namespace Example2
+
+namespace Example {
+
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, Test *_o);
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<TestSimpleTableWithEnum> *_o);
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, Vec3 *_o);
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<Stat> *_o);
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<Monster> *_o);
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, Color *_o) {
+  static const flatbuffers::JsonReader::EnumValue kValues[] = {
+    { "Red", 1 },
+    { "Green", 2 },
+    { "Blue", 8 },
+  };
+  int64_t _v;
+  if (!_r.ParseEnum(kValues, sizeof(kValues) / sizeof(kValues[0]), &_v)) {
+    return false;
+  }
+  *_o = static_cast<Color>(_v);
+  return true;
+}
+
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, Any *_o) {
+  static const flatbuffers::JsonReader::EnumValue kValues[] = {
+    { "NONE", 0 },
+    { "Monster", 1 },
+    { "TestSimpleTableWithEnum", 2 },
+    { "MyGame_Example2_Monster", 3 },
+  };
+  int64_t _v;
+  if (!_r.ParseEnum(kValues, sizeof(kValues) / sizeof(kValues[0]), &_v)) {
+    return false;
+  }
+  *_o = static_cast<Any>(_v);
+  return true;
+}
+
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, flatbuffers::FlatBufferBuilder &_fbb, Any _type, flatbuffers::Offset<void> *_o) {
+  switch (_type) {
+    case Any_Monster: {
+      flatbuffers::Offset<Monster> _p;
+      if (!ParseFromJson(_r, _fbb, &_p)) return false;
+      *_o = _p.Union();
+      return true;
+    }
+    case Any_TestSimpleTableWithEnum: {
+      flatbuffers::Offset<TestSimpleTableWithEnum> _p;
+      if (!ParseFromJson(_r, _fbb, &_p)) return false;
+      *_o = _p.Union();
+      return true;
+    }
+    case Any_MyGame_Example2_Monster: {
+      flatbuffers::Offset<MyGame::Example2::Monster> _p;
+      if (!ParseFromJson(_r, _fbb, &_p)) return false;
+      *_o = _p.Union();
+      return true;
+    }
+    default:
+      return _r.Error("missing type field for this union value");
+  }
+}
+
+}  // namespace Example
+
+namespace Example2 {
+
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<Monster> *_o) {
+  if (!_r.ParseObject([&](const char *_name, size_t _len) -> bool {
+    return _r.UnknownField(_name, _len);
+  })) {
+    return false;
+  }
+  *_o = CreateMonster(_fbb);
+  return true;
+}
+
+}  // namespace Example2
+
+namespace Example {
+
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, Test *_o) {
+  int16_t a = 0;
+  bool _has_a = false;
+  int8_t b = 0;
+  bool _has_b = false;
+  if (!_r.ParseObject([&](const char *_name, size_t _len) -> bool {
+    switch (flatbuffers::JsonReader::HashName(_name, _len, 0)) {
+      case 0xE40C292Cu:
+        if (_len == 1 && !memcmp(_name, "a", 1)) {
+          if (_has_a) {
+            return _r.Error("field set more than once: a");
+          }
+          _has_a = true;
+          return _r.Parse(&a);
+        }
+        break;
+      case 0xE70C2DE5u:
+        if (_len == 1 && !memcmp(_name, "b", 1)) {
+          if (_has_b) {
+            return _r.Error("field set more than once: b");
+          }
+          _has_b = true;
+          return _r.Parse(&b);
+        }
+        break;
+    }
+    return _r.UnknownField(_name, _len);
+  })) {
+    return false;
+  }
+  if (!_has_a || !_has_b) {
+    return _r.Error("struct: wrong number of initializers: Test");
+  }
+  new (_o) Test(a, b);
+  return true;
+}
+
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<TestSimpleTableWithEnum> *_o) {
+  Color color = Color_Green;
+  bool _has_color = false;
+  if (!_r.ParseObject([&](const char *_name, size_t _len) -> bool {
+    switch (flatbuffers::JsonReader::HashName(_name, _len, 0)) {
+      case 0x3D7E6258u:
+        if (_len == 5 && !memcmp(_name, "color", 5)) {
+          if (_has_color) {
+            return _r.Error("field set more than once: color");
+          }
+          _has_color = true;
+          return ParseFromJson(_r, &color);
+        }
+        break;
+    }
+    return _r.UnknownField(_name, _len);
+  })) {
+    return false;
+  }
+  *_o = CreateTestSimpleTableWithEnum(_fbb,
+      color);
+  return true;
+}
+
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, Vec3 *_o) {
+  float x = 0;
+  bool _has_x = false;
+  float y = 0;
+  bool _has_y = false;
+  float z = 0;
+  bool _has_z = false;
+  double test1 = 0;
+  bool _has_test1 = false;
+  Color test2 = static_cast<Color>(0);
+  bool _has_test2 = false;
+  Test test3;
+  bool _has_test3 = false;
+  if (!_r.ParseObject([&](const char *_name, size_t _len) -> bool {
+    switch (flatbuffers::JsonReader::HashName(_name, _len, 0)) {
+      case 0xFD0C5087u:
+        if (_len == 1 && !memcmp(_name, "x", 1)) {
+          if (_has_x) {
+            return _r.Error("field set more than once: x");
+          }
+          _has_x = true;
+          return _r.Parse(&x);
+        }
+        break;
+      case 0xFC0C4EF4u:
+        if (_len == 1 && !memcmp(_name, "y", 1)) {
+          if (_has_y) {
+            return _r.Error("field set more than once: y");
+          }
+          _has_y = true;
+          return _r.Parse(&y);
+        }
+        break;
+      case 0xFF0C53ADu:
+        if (_len == 1 && !memcmp(_name, "z", 1)) {
+          if (_has_z) {
+            return _r.Error("field set more than once: z");
+          }
+          _has_z = true;
+          return _r.Parse(&z);
+        }
+        break;
+      case 0x992330BCu:
+        if (_len == 5 && !memcmp(_name, "test1", 5)) {
+          if (_has_test1) {
+            return _r.Error("field set more than once: test1");
+          }
+          _has_test1 = true;
+          return _r.Parse(&test1);
+        }
+        break;
+      case 0x9C233575u:
+        if (_len == 5 && !memcmp(_name, "test2", 5)) {
+          if (_has_test2) {
+            return _r.Error("field set more than once: test2");
+          }
+          _has_test2 = true;
+          return ParseFromJson(_r, &test2);
+        }
+        break;
+      case 0x9B2333E2u:
+        if (_len == 5 && !memcmp(_name, "test3", 5)) {
+          if (_has_test3) {
+            return _r.Error("field set more than once: test3");
+          }
+          _has_test3 = true;
+          return ParseFromJson(_r, &test3);
+        }
+        break;
+    }
+    return _r.UnknownField(_name, _len);
+  })) {
+    return false;
+  }
+  if (!_has_x || !_has_y || !_has_z || !_has_test1 || !_has_test2 || !_has_test3) {
+    return _r.Error("struct: wrong number of initializers: Vec3");
+  }
+  new (_o) Vec3(x, y, z, test1, test2, test3);
+  return true;
+}
+
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<Stat> *_o) {
+  flatbuffers::Offset<flatbuffers::String> id;
+  bool _has_id = false;
+  int64_t val = 0;
+  bool _has_val = false;
+  uint16_t count = 0;
+  bool _has_count = false;
+  std::string _str;
+  if (!_r.ParseObject([&](const char *_name, size_t _len) -> bool {
+    switch (flatbuffers::JsonReader::HashName(_name, _len, 0)) {
+      case 0x37386AE0u:
+        if (_len == 2 && !memcmp(_name, "id", 2)) {
+          if (_has_id) {
+            return _r.Error("field set more than once: id");
+          }
+          _has_id = true;
+          if (!_r.Parse(&_str)) return false;
+          id = _fbb.CreateString(_str);
+          return true;
+        }
+        break;
+      case 0x9425F77Cu:
+        if (_len == 3 && !memcmp(_name, "val", 3)) {
+          if (_has_val) {
+            return _r.Error("field set more than once: val");
+          }
+          _has_val = true;
+          return _r.Parse(&val);
+        }
+        break;
+      case 0x39B1DDF4u:
+        if (_len == 5 && !memcmp(_name, "count", 5)) {
+          if (_has_count) {
+            return _r.Error("field set more than once: count");
+          }
+          _has_count = true;
+          return _r.Parse(&count);
+        }
+        break;
+    }
+    return _r.UnknownField(_name, _len);
+  })) {
+    return false;
+  }
+  *_o = CreateStat(_fbb,
+      id,
+      val,
+      count);
+  return true;
+}
+
+inline bool ParseFromJson(flatbuffers::JsonReader &_r, flatbuffers::FlatBufferBuilder &_fbb, flatbuffers::Offset<Monster> *_o) {
+  Vec3 pos;
+  bool _has_pos = false;
+  int16_t mana = 150;
+  bool _has_mana = false;
+  int16_t hp = 100;
+  bool _has_hp = false;
+  flatbuffers::Offset<flatbuffers::String> name;
+  bool _has_name = false;
+  bool _has_friendly = false;
+  flatbuffers::Offset<flatbuffers::Vector<uint8_t>> inventory;
+  bool _has_inventory = false;
+  Color color = Color_Blue;
+  bool _has_color = false;
+  Any test_type = Any_NONE;
+  bool _has_test_type = false;
+  flatbuffers::Offset<void> test;
+  bool _has_test = false;
+  flatbuffers::Offset<flatbuffers::Vector<const Test *>> test4;
+  bool _has_test4 = false;
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> testarrayofstring;
+  bool _has_testarrayofstring = false;
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Monster>>> testarrayoftables;
+  bool _has_testarrayoftables = false;
+  flatbuffers::Offset<Monster> enemy;
+  bool _has_enemy = false;
+  flatbuffers::Offset<flatbuffers::Vector<uint8_t>> testnestedflatbuffer;
+  bool _has_testnestedflatbuffer = false;
+  flatbuffers::Offset<Stat> testempty;
+  bool _has_testempty = false;
+  bool testbool = false;
+  bool _has_testbool = false;
+  int32_t testhashs32_fnv1 = 0;
+  bool _has_testhashs32_fnv1 = false;
+  uint32_t testhashu32_fnv1 = 0;
+  bool _has_testhashu32_fnv1 = false;
+  int64_t testhashs64_fnv1 = 0;
+  bool _has_testhashs64_fnv1 = false;
+  uint64_t testhashu64_fnv1 = 0;
+  bool _has_testhashu64_fnv1 = false;
+  int32_t testhashs32_fnv1a = 0;
+  bool _has_testhashs32_fnv1a = false;
+  uint32_t testhashu32_fnv1a = 0;
+  bool _has_testhashu32_fnv1a = false;
+  int64_t testhashs64_fnv1a = 0;
+  bool _has_testhashs64_fnv1a = false;
+  uint64_t testhashu64_fnv1a = 0;
+  bool _has_testhashu64_fnv1a = false;
+  flatbuffers::Offset<flatbuffers::Vector<uint8_t>> testarrayofbools;
+  bool _has_testarrayofbools = false;
+  float testf = 3.14159f;
+  bool _has_testf = false;
+  float testf2 = 3.0f;
+  bool _has_testf2 = false;
+  float testf3 = 0.0f;
+  bool _has_testf3 = false;
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> testarrayofstring2;
+  bool _has_testarrayofstring2 = false;
+  std::string _str;
+  if (!_r.ParseObject([&](const char *_name, size_t _len) -> bool {
+    switch (flatbuffers::JsonReader::HashName(_name, _len, 0)) {
+      case 0x54336489u:
+        if (_len == 3 && !memcmp(_name, "pos", 3)) {
+          if (_has_pos) {
+            return _r.Error("field set more than once: pos");
+          }
+          _has_pos = true;
+          return ParseFromJson(_r, &pos);
+        }
+        break;
+      case 0xD997830Au:
+        if (_len == 4 && !memcmp(_name, "mana", 4)) {
+          if (_has_mana) {
+            return _r.Error("field set more than once: mana");
+          }
+          _has_mana = true;
+          return _r.Parse(&mana);
+        }
+        break;
+      case 0x513AD265u:
+        if (_len == 2 && !memcmp(_name, "hp", 2)) {
+          if (_has_hp) {
+            return _r.Error("field set more than once: hp");
+          }
+          _has_hp = true;
+          return _r.Parse(&hp);
+        }
+        break;
+      case 0x8D39BDE6u:
+        if (_len == 4 && !memcmp(_name, "name", 4)) {
+          if (_has_name) {
+            return _r.Error("field set more than once: name");
+          }
+          _has_name = true;
+          if (!_r.Parse(&_str)) return false;
+          name = _fbb.CreateString(_str);
+          return true;
+        }
+        break;
+      case 0xCDD4F17Eu:
+        if (_len == 8 && !memcmp(_name, "friendly", 8)) {
+          if (_has_friendly) {
+            return _r.Error("field set more than once: friendly");
+          }
+          _has_friendly = true;
+          return _r.SkipValue();
+        }
+        break;
+      case 0xFCFDC43Fu:
+        if (_len == 9 && !memcmp(_name, "inventory", 9)) {
+          if (_has_inventory) {
+            return _r.Error("field set more than once: inventory");
+          }
+          _has_inventory = true;
+          std::vector<uint8_t> _values;
+          if (!_r.ParseArray([&]() -> bool {
+            uint8_t _e = 0;
+            if (!_r.Parse(&_e)) return false;
+            _values.push_back(_e);
+            return true;
+          })) {
+            return false;
+          }
+          inventory = _fbb.CreateVector(_values);
+          return true;
+        }
+        break;
+      case 0x3D7E6258u:
+        if (_len == 5 && !memcmp(_name, "color", 5)) {
+          if (_has_color) {
+            return _r.Error("field set more than once: color");
+          }
+          _has_color = true;
+          return ParseFromJson(_r, &color);
+        }
+        break;
+      case 0x593DCF6Eu:
+        if (_len == 9 && !memcmp(_name, "test_type", 9)) {
+          if (_has_test_type) {
+            return _r.Error("field set more than once: test_type");
+          }
+          _has_test_type = true;
+          return ParseFromJson(_r, &test_type);
+        }
+        break;
+      case 0xAFD071E5u:
+        if (_len == 4 && !memcmp(_name, "test", 4)) {
+          if (_has_test) {
+            return _r.Error("field set more than once: test");
+          }
+          _has_test = true;
+          if (!_has_test_type && !_r.PeekNextField("test_type", [&]() {
+                return ParseFromJson(_r, &test_type);
+              })) {
+            return false;
+          }
+          return ParseFromJson(_r, _fbb, test_type, &test);
+        }
+        break;
+      case 0x96232C03u:
+        if (_len == 5 && !memcmp(_name, "test4", 5)) {
+          if (_has_test4) {
+            return _r.Error("field set more than once: test4");
+          }
+          _has_test4 = true;
+          std::vector<Test> _values;
+          if (!_r.ParseArray([&]() -> bool {
+            Test _e;
+            if (!ParseFromJson(_r, &_e)) return false;
+            _values.push_back(_e);
+            return true;
+          })) {
+            return false;
+          }
+          test4 = _fbb.CreateVectorOfStructs(_values);
+          return true;
+        }
+        break;
+      case 0x3283F002u:
+        if (_len == 17 && !memcmp(_name, "testarrayofstring", 17)) {
+          if (_has_testarrayofstring) {
+            return _r.Error("field set more than once: testarrayofstring");
+          }
+          _has_testarrayofstring = true;
+          std::vector<flatbuffers::Offset<flatbuffers::String>> _values;
+          if (!_r.ParseArray([&]() -> bool {
+            if (!_r.Parse(&_str)) return false;
+            _values.push_back(_fbb.CreateString(_str));
+            return true;
+          })) {
+            return false;
+          }
+          testarrayofstring = _fbb.CreateVector(_values);
+          return true;
+        }
+        break;
+      case 0x9427234Eu:
+        if (_len == 17 && !memcmp(_name, "testarrayoftables", 17)) {
+          if (_has_testarrayoftables) {
+            return _r.Error("field set more than once: testarrayoftables");
+          }
+          _has_testarrayoftables = true;
+          std::vector<flatbuffers::Offset<Monster>> _values;
+          if (!_r.ParseArray([&]() -> bool {
+            flatbuffers::Offset<Monster> _e;
+            if (!ParseFromJson(_r, _fbb, &_e)) return false;
+            _values.push_back(_e);
+            return true;
+          })) {
+            return false;
+          }
+          testarrayoftables = _fbb.CreateVector(_values);
+          return true;
+        }
+        break;
+      case 0x69EA6DABu:
+        if (_len == 5 && !memcmp(_name, "enemy", 5)) {
+          if (_has_enemy) {
+            return _r.Error("field set more than once: enemy");
+          }
+          _has_enemy = true;
+          return ParseFromJson(_r, _fbb, &enemy);
+        }
+        break;
+      case 0xCC855133u:
+        if (_len == 20 && !memcmp(_name, "testnestedflatbuffer", 20)) {
+          if (_has_testnestedflatbuffer) {
+            return _r.Error("field set more than once: testnestedflatbuffer");
+          }
+          _has_testnestedflatbuffer = true;
+          std::vector<uint8_t> _values;
+          if (!_r.ParseArray([&]() -> bool {
+            uint8_t _e = 0;
+            if (!_r.Parse(&_e)) return false;
+            _values.push_back(_e);
+            return true;
+          })) {
+            return false;
+          }
+          testnestedflatbuffer = _fbb.CreateVector(_values);
+          return true;
+        }
+        break;
+      case 0x901D9B8Eu:
+        if (_len == 9 && !memcmp(_name, "testempty", 9)) {
+          if (_has_testempty) {
+            return _r.Error("field set more than once: testempty");
+          }
+          _has_testempty = true;
+          return ParseFromJson(_r, _fbb, &testempty);
+        }
+        break;
+      case 0xFA91405Du:
+        if (_len == 8 && !memcmp(_name, "testbool", 8)) {
+          if (_has_testbool) {
+            return _r.Error("field set more than once: testbool");
+          }
+          _has_testbool = true;
+          return _r.Parse(&testbool);
+        }
+        break;
+      case 0x1CBB4C2Du:
+        if (_len == 16 && !memcmp(_name, "testhashs32_fnv1", 16)) {
+          if (_has_testhashs32_fnv1) {
+            return _r.Error("field set more than once: testhashs32_fnv1");
+          }
+          _has_testhashs32_fnv1 = true;
+          return _r.ParseHashed(&testhashs32_fnv1, flatbuffers::HashFnv1<uint32_t>);
+        }
+        break;
+      case 0x902E186Fu:
+        if (_len == 16 && !memcmp(_name, "testhashu32_fnv1", 16)) {
+          if (_has_testhashu32_fnv1) {
+            return _r.Error("field set more than once: testhashu32_fnv1");
+          }
+          _has_testhashu32_fnv1 = true;
+          return _r.ParseHashed(&testhashu32_fnv1, flatbuffers::HashFnv1<uint32_t>);
+        }
+        break;
+      case 0xD5A0C2D4u:
+        if (_len == 16 && !memcmp(_name, "testhashs64_fnv1", 16)) {
+          if (_has_testhashs64_fnv1) {
+            return _r.Error("field set more than once: testhashs64_fnv1");
+          }
+          _has_testhashs64_fnv1 = true;
+          return _r.ParseHashed(&testhashs64_fnv1, flatbuffers::HashFnv1<uint64_t>);
+        }
+        break;
+      case 0x970D90BAu:
+        if (_len == 16 && !memcmp(_name, "testhashu64_fnv1", 16)) {
+          if (_has_testhashu64_fnv1) {
+            return _r.Error("field set more than once: testhashu64_fnv1");
+          }
+          _has_testhashu64_fnv1 = true;
+          return _r.ParseHashed(&testhashu64_fnv1, flatbuffers::HashFnv1<uint64_t>);
+        }
+        break;
+      case 0x86D91BA4u:
+        if (_len == 17 && !memcmp(_name, "testhashs32_fnv1a", 17)) {
+          if (_has_testhashs32_fnv1a) {
+            return _r.Error("field set more than once: testhashs32_fnv1a");
+          }
+          _has_testhashs32_fnv1a = true;
+          return _r.ParseHashed(&testhashs32_fnv1a, flatbuffers::HashFnv1a<uint32_t>);
+        }
+        break;
+      case 0x068FDE0Au:
+        if (_len == 17 && !memcmp(_name, "testhashu32_fnv1a", 17)) {
+          if (_has_testhashu32_fnv1a) {
+            return _r.Error("field set more than once: testhashu32_fnv1a");
+          }
+          _has_testhashu32_fnv1a = true;
+          return _r.ParseHashed(&testhashu32_fnv1a, flatbuffers::HashFnv1a<uint32_t>);
+        }
+        break;
+      case 0x011282EFu:
+        if (_len == 17 && !memcmp(_name, "testhashs64_fnv1a", 17)) {
+          if (_has_testhashs64_fnv1a) {
+            return _r.Error("field set more than once: testhashs64_fnv1a");
+          }
+          _has_testhashs64_fnv1a = true;
+          return _r.ParseHashed(&testhashs64_fnv1a, flatbuffers::HashFnv1a<uint64_t>);
+        }
+        break;
+      case 0xA55B08C1u:
+        if (_len == 17 && !memcmp(_name, "testhashu64_fnv1a", 17)) {
+          if (_has_testhashu64_fnv1a) {
+            return _r.Error("field set more than once: testhashu64_fnv1a");
+          }
+          _has_testhashu64_fnv1a = true;
+          return _r.ParseHashed(&testhashu64_fnv1a, flatbuffers::HashFnv1a<uint64_t>);
+        }
+        break;
+      case 0xEB0CD690u:
+        if (_len == 16 && !memcmp(_name, "testarrayofbools", 16)) {
+          if (_has_testarrayofbools) {
+            return _r.Error("field set more than once: testarrayofbools");
+          }
+          _has_testarrayofbools = true;
+          std::vector<uint8_t> _values;
+          if (!_r.ParseArray([&]() -> bool {
+            bool _e = false;
+            if (!_r.Parse(&_e)) return false;
+            _values.push_back(static_cast<uint8_t>(_e));
+            return true;
+          })) {
+            return false;
+          }
+          testarrayofbools = _fbb.CreateVector(_values);
+          return true;
+        }
+        break;
+      case 0x4822B139u:
+        if (_len == 5 && !memcmp(_name, "testf", 5)) {
+          if (_has_testf) {
+            return _r.Error("field set more than once: testf");
+          }
+          _has_testf = true;
+          return _r.Parse(&testf);
+        }
+        break;
+      case 0x999CB451u:
+        if (_len == 6 && !memcmp(_name, "testf2", 6)) {
+          if (_has_testf2) {
+            return _r.Error("field set more than once: testf2");
+          }
+          _has_testf2 = true;
+          return _r.Parse(&testf2);
+        }
+        break;
+      case 0x989CB2BEu:
+        if (_len == 6 && !memcmp(_name, "testf3", 6)) {
+          if (_has_testf3) {
+            return _r.Error("field set more than once: testf3");
+          }
+          _has_testf3 = true;
+          return _r.Parse(&testf3);
+        }
+        break;
+      case 0xB5B31B90u:
+        if (_len == 18 && !memcmp(_name, "testarrayofstring2", 18)) {
+          if (_has_testarrayofstring2) {
+            return _r.Error("field set more than once: testarrayofstring2");
+          }
+          _has_testarrayofstring2 = true;
+          std::vector<flatbuffers::Offset<flatbuffers::String>> _values;
+          if (!_r.ParseArray([&]() -> bool {
+            if (!_r.Parse(&_str)) return false;
+            _values.push_back(_fbb.CreateString(_str));
+            return true;
+          })) {
+            return false;
+          }
+          testarrayofstring2 = _fbb.CreateVector(_values);
+          return true;
+        }
+        break;
+    }
+    return _r.UnknownField(_name, _len);
+  })) {
+    return false;
+  }
+  if (!_has_name) {
+    return _r.Error("required field is missing: name");
+  }
+  *_o = CreateMonster(_fbb,
+      _has_pos ? &pos : nullptr,
+      mana,
+      hp,
+      name,
+      inventory,
+      color,
+      test_type,
+      test,
+      test4,
+      testarrayofstring,
+      testarrayoftables,
+      enemy,
+      testnestedflatbuffer,
+      testempty,
+      testbool,
+      testhashs32_fnv1,
+      testhashu32_fnv1,
+      testhashs64_fnv1,
+      testhashu64_fnv1,
+      testhashs32_fnv1a,
+      testhashu32_fnv1a,
+      testhashs64_fnv1a,
+      testhashu64_fnv1a,
+      testarrayofbools,
+      testf,
+      testf2,
+      testf3,
+      testarrayofstring2);
+  return true;
+}
+
 inline const MyGame::Example::Monster *GetMonster(const void *buf) {
   return flatbuffers::GetRoot<MyGame::Example::Monster>(buf);
 }
@@ -1293,6 +2247,11 @@ inline bool VerifyMonsterBuffer(
   return verifier.VerifyBuffer<MyGame::Example::Monster>(MonsterIdentifier());
 }
 
+inline const MyGame::Example::Monster *GetMonster(
+    flatbuffers::AccessChecker &_checker) {
+  return _checker.GetRoot<MyGame::Example::Monster>(MonsterIdentifier());
+}
+
 inline const char *MonsterExtension() {
   return "mon";
 }
@@ -1309,6 +2268,20 @@ inline std::unique_ptr<MonsterT> UnPackMonster(
   return std::unique_ptr<MonsterT>(GetMonster(buf)->UnPack(res));
 }
 
+inline bool ParseMonsterFromJson(
+    const char *json, size_t len,
+    flatbuffers::FlatBufferBuilder &fbb,
+    std::string *error = nullptr) {
+  flatbuffers::JsonReader reader(json, len);
+  flatbuffers::Offset<MyGame::Example::Monster> root;
+  if (!ParseFromJson(reader, fbb, &root) || !reader.AtEnd()) {
+    if (error) *error = reader.error();
+    return false;
+  }
+  FinishMonsterBuffer(fbb, root);
+  return true;
+}
+
 }  // namespace Example
 }  // namespace MyGame
 
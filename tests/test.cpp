@@ -22,11 +22,21 @@
 #include "namespace_test/namespace_test1_generated.h"
 #include "namespace_test/namespace_test2_generated.h"
 #include "union_vector/union_vector_generated.h"
+#include "hash_index/hash_index_test_generated.h"
 
 #ifndef FLATBUFFERS_CPP98_STL
   #include <random>
+
+  #include "flatbuffers/schema_cache.h"
+  #include "flatbuffers/verified_buffer_cache.h"
+#endif
+#if FLATBUFFERS_HAS_THREADS
+  #include <atomic>
+  #include <thread>
 #endif
 
+#include <ctime>
+
 #include "flatbuffers/flexbuffers.h"
 
 using namespace MyGame::Example;
@@ -422,6 +432,106 @@ void SizePrefixedTest() {
   TEST_EQ_STR(m->name()->c_str(), "bob");
 }
 
+// Build a buffer much larger than the initial size in segmented mode, and
+// check it reads back correctly once the segments are concatenated.
+void SegmentedBufferTest() {
+  const int num_monsters = 1000;
+  flatbuffers::FlatBufferBuilder fbb(64);
+  fbb.SegmentedBuffer(true);
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  std::vector<std::string> names;
+  for (int i = 0; i < num_monsters; i++) {
+    names.push_back("monster" + flatbuffers::NumToString(i));
+  }
+  // Can't use CreateVectorOfSortedTables, since tables are not contiguous
+  // with their string keys in this mode, so sort up front.
+  std::sort(names.begin(), names.end());
+  for (int i = 0; i < num_monsters; i++) {
+    auto name = fbb.CreateSharedString(names[i]);
+    auto inventory = fbb.CreateVector(std::vector<uint8_t>(i % 50, 7));
+    monsters.push_back(CreateMonster(fbb, nullptr, 150,
+                                     static_cast<int16_t>(i), name,
+                                     inventory));
+  }
+  auto tables = fbb.CreateVector(monsters);
+  auto strings = fbb.CreateVectorOfStrings(names);
+  FinishMonsterBuffer(fbb, CreateMonster(fbb, nullptr, 150, 100,
+                                         fbb.CreateString("root"), 0,
+                                         Color_Blue, Any_NONE, 0, 0, strings,
+                                         tables));
+
+  auto segments = fbb.GetBufferSegments();
+  TEST_EQ(segments.size() > 1, true);
+  std::string flat;
+  for (auto it = segments.begin(); it != segments.end(); ++it) {
+    flat.append(reinterpret_cast<const char *>(it->data), it->size);
+  }
+  TEST_EQ(flat.size(), fbb.GetSize());
+
+  auto buf = reinterpret_cast<const uint8_t *>(flat.c_str());
+  flatbuffers::Verifier verifier(buf, flat.size());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  auto root = GetMonster(buf);
+  TEST_EQ_STR(root->name()->c_str(), "root");
+  TEST_EQ(root->testarrayofstring()->size(),
+          static_cast<flatbuffers::uoffset_t>(num_monsters));
+  TEST_EQ(root->testarrayoftables()->size(),
+          static_cast<flatbuffers::uoffset_t>(num_monsters));
+  for (int i = 0; i < num_monsters; i++) {
+    TEST_EQ_STR(root->testarrayofstring()->Get(i)->c_str(), names[i].c_str());
+    auto m = root->testarrayoftables()->LookupByKey(names[i].c_str());
+    TEST_NOTNULL(m);
+    TEST_EQ(m->hp(), i);
+    TEST_EQ(m->inventory()->size(),
+            static_cast<flatbuffers::uoffset_t>(i % 50));
+  }
+
+  // A cleared builder can be reused, and ends up in a single segment if it
+  // fits.
+  fbb.Clear();
+  fbb.Finish(CreateMonster(fbb, nullptr, 150, 100, fbb.CreateString("bob")));
+  TEST_EQ(fbb.GetBufferSegments().size(), 1);
+  TEST_EQ_STR(GetMonster(fbb.GetBufferPointer())->name()->c_str(), "bob");
+}
+
+// Shares strings with CreateSharedString, with and without a limit on the
+// number of strings remembered.
+void SharedStringTest() {
+  flatbuffers::FlatBufferBuilder fbb;
+  auto a = fbb.CreateSharedString("host-a");
+  auto b = fbb.CreateSharedString("host-b");
+  auto size = fbb.GetSize();
+  TEST_EQ(fbb.CreateSharedString("host-a").o, a.o);
+  TEST_EQ(fbb.CreateSharedString(std::string("host-b")).o, b.o);
+  TEST_EQ(fbb.GetSize(), size);  // Nothing was written.
+  // Binary strings with the same prefix are distinct.
+  auto z1 = fbb.CreateSharedString("a\0b", 3);
+  auto z2 = fbb.CreateSharedString("a\0c", 3);
+  TEST_EQ(z1.o != z2.o, true);
+  TEST_EQ(fbb.CreateSharedString("a\0c", 3).o, z2.o);
+  TEST_EQ(fbb.CreateSharedString("a", 1).o != z1.o, true);
+
+  // With a limit, the pool starts over when it is full.
+  fbb.Clear();
+  fbb.SetMaxSharedStrings(2);
+  a = fbb.CreateSharedString("host-a");
+  fbb.CreateSharedString("host-b");
+  TEST_EQ(fbb.CreateSharedString("host-a").o, a.o);
+  fbb.CreateSharedString("host-c");  // Forgets host-a and host-b.
+  TEST_EQ(fbb.CreateSharedString("host-a").o != a.o, true);
+
+  // Many repeats of a few strings take up the space of one copy each.
+  std::vector<std::string> tags;
+  for (int i = 0; i < 1000; i++) {
+    tags.push_back("tag-" + flatbuffers::NumToString(i * 7919));
+  }
+  flatbuffers::FlatBufferBuilder builder;
+  for (int i = 0; i < 10000; i++) {
+    builder.CreateSharedString(tags[i % tags.size()]);
+  }
+  TEST_EQ(builder.GetSize() < 16 * tags.size(), true);
+}
+
 // example of parsing text straight into a buffer, and generating
 // text back from it:
 void ParseAndGenerateTextTest() {
@@ -458,6 +568,396 @@ void ParseAndGenerateTextTest() {
   }
 }
 
+// Generate text from a binary file without copying it out of its mapping.
+void MappedFileTest() {
+  std::string schemafile;
+  std::string binfile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.fbs", false, &schemafile), true);
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monsterdata_test.mon", true, &binfile), true);
+
+  flatbuffers::MappedFile mapped;
+  TEST_EQ(mapped.Open("tests/monsterdata_test.mon"), true);
+  TEST_EQ(mapped.size(), binfile.size());
+  TEST_EQ(memcmp(mapped.data(), binfile.c_str(), binfile.size()), 0);
+
+  flatbuffers::Parser parser;
+  const char *include_directories[] = { "tests", nullptr };
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+  std::string jsongen;
+  TEST_EQ(GenerateText(parser, mapped.data(), &jsongen), true);
+  TEST_EQ(GenerateText(parser, binfile.c_str(), &jsonfile), true);
+  TEST_EQ_STR(jsongen.c_str(), jsonfile.c_str());
+
+  mapped.Close();
+  TEST_EQ(mapped.size(), 0);
+  TEST_EQ(mapped.Open("tests/does_not_exist.mon"), false);
+
+  // An empty file converts to nothing, one too small for a root offset
+  // fails, neither reads past its end (e.g. flatc --raw-binary).
+  TEST_EQ(flatbuffers::SaveFile("tests/empty_test.mon", "", 0, true), true);
+  TEST_EQ(mapped.Open("tests/empty_test.mon"), true);
+  TEST_EQ(mapped.size(), 0);
+  TEST_EQ(GenerateTextFile(parser, "tests/", "empty_test", mapped.data(),
+                           mapped.size()), true);
+  TEST_EQ(flatbuffers::FileExists("tests/empty_test.json"), false);
+  TEST_EQ(GenerateTextFile(parser, "tests/", "empty_test", binfile.c_str(),
+                           sizeof(flatbuffers::uoffset_t) - 1), false);
+  TEST_EQ(flatbuffers::FileExists("tests/empty_test.json"), false);
+  mapped.Close();
+  remove("tests/empty_test.mon");
+}
+
+// Convert NDJSON to a stream of size prefixed buffers and back.
+void StreamTest() {
+  std::string schemafile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.fbs", false, &schemafile), true);
+  flatbuffers::Parser parser;
+  const char *include_directories[] = { "tests", nullptr };
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+
+  const char *ndjson =
+    "{name: \"bob\", hp: 300}\n"
+    "\n"
+    "{name: \"alice\", inventory: [1, 2, 3]}\n";
+  auto in = tmpfile();
+  TEST_NOTNULL(in);
+  fputs(ndjson, in);
+  rewind(in);
+  std::string stream;
+  int records = 0;
+  TEST_EQ(parser.ParseJsonStream(in, [&](const uint8_t *buf, size_t len) {
+    flatbuffers::Verifier verifier(buf, len);
+    TEST_EQ(verifier.VerifySizePrefixedBuffer<Monster>(MonsterIdentifier()),
+            true);
+    stream.append(reinterpret_cast<const char *>(buf), len);
+    records++;
+    return true;
+  }), true);
+  fclose(in);
+  TEST_EQ(records, 2);
+  auto first_len = sizeof(flatbuffers::uoffset_t) +
+                   flatbuffers::ReadScalar<flatbuffers::uoffset_t>(
+                     stream.c_str());
+  auto second = flatbuffers::GetSizePrefixedRoot<Monster>(
+                  stream.c_str() + first_len);
+  TEST_EQ_STR(second->name()->c_str(), "alice");
+  TEST_EQ(second->inventory()->size(), 3U);
+
+  auto convert = [&](const std::string &binary, std::string *text,
+                     std::string *error) {
+    auto bin = tmpfile();
+    TEST_NOTNULL(bin);
+    fwrite(binary.c_str(), 1, binary.size(), bin);
+    rewind(bin);
+    auto ok = flatbuffers::GenerateTextStream(parser, bin, true,
+                                              [&](const char *s, size_t len) {
+      text->append(s, len);
+      return true;
+    }, error);
+    fclose(bin);
+    return ok;
+  };
+  std::string text;
+  std::string error;
+  TEST_EQ(convert(stream, &text, &error), true);
+  TEST_EQ_STR(text.c_str(),
+              "{hp: 300,name: \"bob\"}\n"
+              "{name: \"alice\",inventory: [1,2,3]}\n");
+
+  // Truncated streams and bad lines are reported.
+  text.clear();
+  TEST_EQ(convert(stream.substr(0, stream.size() - 1), &text, &error), false);
+  TEST_EQ(error.empty(), false);
+  // As are buffers that can't be converted, e.g. with invalid UTF-8.
+  flatbuffers::FlatBufferBuilder fbb;
+  fbb.FinishSizePrefixed(CreateMonster(fbb, nullptr, 150, 100,
+                                       fbb.CreateString("\xff")),
+                         MonsterIdentifier());
+  error.clear();
+  TEST_EQ(convert(stream + std::string(reinterpret_cast<const char *>(
+                    fbb.GetBufferPointer()), fbb.GetSize()), &text, &error),
+          false);
+  TEST_EQ_STR(error.c_str(),
+              ("unable to generate text for the buffer at offset " +
+               flatbuffers::NumToString(stream.size())).c_str());
+  in = tmpfile();
+  TEST_NOTNULL(in);
+  fputs("{name: \"bob\"}\n{name: bob}\n", in);
+  rewind(in);
+  TEST_EQ(parser.ParseJsonStream(in, [](const uint8_t *, size_t) {
+    return true;
+  }), false);
+  fclose(in);
+  #ifdef _WIN32
+    TEST_EQ(parser.error_.find("(2): error:") != std::string::npos, true);
+  #else
+    TEST_EQ(parser.error_.find("2:0: error:") != std::string::npos, true);
+  #endif
+  // Lines longer than the read buffer, and NUL characters, which are
+  // reported with the line they're on, even at the start of a line.
+  std::string long_name(10000, 'x');
+  std::string nul_lines = "{name: \"" + long_name + "\"}\n";
+  nul_lines += nul_lines + std::string("\0{name: \"bob\"}\n", 15);
+  in = tmpfile();
+  TEST_NOTNULL(in);
+  fwrite(nul_lines.c_str(), 1, nul_lines.size(), in);
+  rewind(in);
+  records = 0;
+  TEST_EQ(parser.ParseJsonStream(in, [&](const uint8_t *buf, size_t) {
+    auto monster = flatbuffers::GetSizePrefixedRoot<Monster>(buf);
+    TEST_EQ(monster->name()->size(), long_name.size());
+    records++;
+    return true;
+  }), false);
+  fclose(in);
+  TEST_EQ(records, 2);
+  #ifdef _WIN32
+    TEST_EQ(parser.error_.find("(3): error: illegal NUL") !=
+            std::string::npos, true);
+  #else
+    TEST_EQ(parser.error_.find("3:0: error: illegal NUL") !=
+            std::string::npos, true);
+  #endif
+}
+
+// Parse monsterdata_test.json repeated many times as a vector of tables.
+void ParseJsonVectorOfTablesTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.fbs", false, &schemafile), true);
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monsterdata_test.json", false, &jsonfile), true);
+
+  flatbuffers::Parser parser;
+  const char *include_directories[] = { "tests", nullptr };
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+
+  const int num_monsters = 100;
+  std::string json = "{ name: \"root\", testarrayoftables: [";
+  for (int i = 0; i < num_monsters; i++) {
+    if (i) json += ",";
+    json += jsonfile;
+  }
+  json += "] }";
+
+  TEST_EQ(parser.Parse(json.c_str(), include_directories), true);
+
+  flatbuffers::Verifier verifier(parser.builder_.GetBufferPointer(),
+                                 parser.builder_.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  auto monsters = GetMonster(parser.builder_.GetBufferPointer())->
+                    testarrayoftables();
+  TEST_EQ(monsters->size(), static_cast<flatbuffers::uoffset_t>(num_monsters));
+  auto monster = monsters->Get(num_monsters - 1);
+  TEST_EQ(monster->hp(), 80);
+  TEST_EQ(monster->pos()->y(), 2);
+  TEST_EQ(monster->test_type(), Any_Monster);
+  TEST_EQ(monster->inventory()->Get(4), 4);
+  TEST_EQ(monster->testhashu32_fnv1(),
+          flatbuffers::HashFnv1<uint32_t>("This string is being hashed!"));
+  TEST_EQ(monster->testf(), 3.14159f);  // Default.
+}
+
+// A TextGenerator reused between buffers and options, on strings that need
+// escaping.
+void TextGeneratorTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.fbs", false, &schemafile), true);
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monsterdata_test.json", false, &jsonfile), true);
+
+  flatbuffers::Parser parser;
+  const char *include_directories[] = { "tests", nullptr };
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+
+  // Long names with characters on both sides of every 16 byte boundary that
+  // need escaping, so both the fast and the byte by byte paths are used.
+  const int num_monsters = 1000;
+  std::string json = "{ name: \"root\", testarrayoftables: [";
+  for (int i = 0; i < num_monsters; i++) {
+    if (i) json += ",";
+    json += "{ name: \"monster " + flatbuffers::NumToString(i) +
+            " has a fairly long name\\twith \\\"escapes\\\" \\u00e9\\n\", " +
+            "hp: " + flatbuffers::NumToString(i) + " }";
+  }
+  json += "] }";
+  TEST_EQ(parser.Parse(json.c_str(), include_directories), true);
+  auto buf = parser.builder_.GetBufferPointer();
+
+  std::string expected;
+  TEST_EQ(GenerateText(parser, buf, &expected), true);
+  TEST_NOTNULL(strstr(expected.c_str(),
+    "name: \"monster 999 has a fairly long name\\twith \\\"escapes\\\" "
+    "\\u00E9\\n\""));
+
+  // A generator can be kept around and fed a cleared string, so both the
+  // per table field names and the output buffer are reused.
+  flatbuffers::TextGenerator generator(parser);
+  std::string text;
+  for (int i = 0; i < 2; i++) {
+    text.clear();
+    TEST_EQ(generator.Generate(buf, &text), true);
+    TEST_EQ_STR(text.c_str(), expected.c_str());
+  }
+
+  // Switching options between calls is picked up.
+  parser.opts.strict_json = true;
+  text.clear();
+  TEST_EQ(generator.Generate(buf, &text), true);
+  TEST_NOTNULL(strstr(text.c_str(), "\"hp\": 999"));
+  parser.opts.strict_json = false;
+
+  // Streaming produces the same text, in bounded pieces, and stops as soon
+  // as the sink fails.
+  std::string streamed;
+  size_t pieces = 0, largest = 0;
+  TEST_EQ(GenerateText(parser, buf, [&](const char *data, size_t len) {
+    streamed.append(data, len);
+    pieces++;
+    largest = std::max(largest, len);
+    return true;
+  }), true);
+  TEST_EQ_STR(streamed.c_str(), expected.c_str());
+  TEST_EQ(pieces > 1, true);
+  TEST_EQ(largest < 2 * flatbuffers::kTextSinkChunkSize, true);
+  pieces = 0;
+  TEST_EQ(GenerateText(parser, buf, [&](const char *, size_t) {
+    pieces++;
+    return false;
+  }), false);
+  TEST_EQ(pieces, 1U);
+}
+
+void GeneratedJsonParserTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.fbs", false, &schemafile), true);
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monsterdata_test.json", false, &jsonfile), true);
+  flatbuffers::Parser parser;
+  const char *include_directories[] = { "tests", nullptr };
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+  TEST_EQ(parser.Parse(jsonfile.c_str(), include_directories), true);
+
+  flatbuffers::FlatBufferBuilder fbb;
+  std::string error;
+  TEST_EQ(ParseMonsterFromJson(jsonfile.c_str(), jsonfile.size(), fbb,
+                               &error), true);
+  flatbuffers::Verifier verifier(fbb.GetBufferPointer(), fbb.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+
+  // Both buffers hold the same data.
+  std::string expected, text;
+  TEST_EQ(GenerateText(parser, parser.builder_.GetBufferPointer(), &expected),
+          true);
+  TEST_EQ(GenerateText(parser, fbb.GetBufferPointer(), &text), true);
+  TEST_EQ_STR(text.c_str(), expected.c_str());
+
+  // Errors, which report the line they're on.
+  auto parse_error = [&](const char *json) {
+    flatbuffers::FlatBufferBuilder builder;
+    std::string err;
+    TEST_EQ(ParseMonsterFromJson(json, strlen(json), builder, &err), false);
+    return err;
+  };
+  TEST_EQ_STR(parse_error("{ name: \"a\",\n unknown: 1 }").c_str(),
+              "2: error: unknown field: unknown");
+  TEST_EQ_STR(parse_error("{ hp: 1 }").c_str(),
+              "1: error: required field is missing: name");
+  TEST_EQ_STR(parse_error("{ name: \"a\", hp: 40000 }").c_str(),
+              "1: error: integer out of range for its type");
+  TEST_EQ_STR(parse_error("{ name: \"a\", color: Purple }").c_str(),
+              "1: error: unknown enum value: Purple");
+  TEST_EQ_STR(parse_error("{ name: \"a\", test: { name: \"b\" } }").c_str(),
+              "1: error: missing type field after this union value: "
+              "test_type");
+  TEST_EQ_STR(parse_error("{ name: \"a\" } x").c_str(),
+              "1: error: unexpected text after the root object");
+  TEST_EQ_STR(parse_error("{ name: \"a\" ").c_str(),
+              "1: error: expecting: , or }");
+
+  // Both parsers accept or reject the same JSON, with the same error.
+  auto same_as_parser = [&](const char *json) {
+    flatbuffers::FlatBufferBuilder builder;
+    std::string err;
+    auto ok = ParseMonsterFromJson(json, strlen(json), builder, &err);
+    TEST_EQ(parser.Parse(json), ok);
+    if (ok) {
+      std::string parsed, generated;
+      TEST_EQ(GenerateText(parser, parser.builder_.GetBufferPointer(),
+                           &parsed), true);
+      TEST_EQ(GenerateText(parser, builder.GetBufferPointer(), &generated),
+              true);
+      TEST_EQ_STR(generated.c_str(), parsed.c_str());
+    } else {
+      auto msg = parser.error_.substr(parser.error_.find("error: "));
+      TEST_EQ_STR(err.substr(err.find("error: ")).c_str(), msg.c_str());
+    }
+  };
+  // A union value may come right before its type field.
+  same_as_parser("{ name: \"a\", test: { name: \"b\" }, test_type: Monster }");
+  same_as_parser("{ name: \"a\", test: { name: \"b\" }, hp: 1, "
+                 "test_type: Monster }");
+  // Fields may be set only once.
+  same_as_parser("{ name: \"a\", name: \"b\" }");
+  same_as_parser("{ name: \"a\", pos: { x: 1, y: 2, z: 3, x: 4, test1: 0, "
+                 "test2: Red, test3: { a: 1, b: 2 } } }");
+  // Structs must have all their fields.
+  same_as_parser("{ name: \"a\", pos: { x: 1 } }");
+  same_as_parser("{ name: \"a\", pos: { x: 1, y: 2, z: 3, test1: 0, "
+                 "test2: Red, test3: { a: 1, b: 2 } } }");
+
+  // The reader can also skip unknown fields, and accepts the same dialect
+  // as Parser: comments, trailing commas, quoted names, multiple enum flags.
+  const char *json = "{ /* c */ \"name\": 'a\\u00E9', extra: [ { x: 1 } ],\n"
+                     "  color: \"Red Blue\", testf: -1.5e2, hp: 0x10, }";
+  flatbuffers::JsonReader reader(json, strlen(json), true);
+  flatbuffers::Offset<Monster> offset;
+  fbb.Clear();
+  TEST_EQ(ParseFromJson(reader, fbb, &offset), true);
+  TEST_EQ(reader.AtEnd(), true);
+  FinishMonsterBuffer(fbb, offset);
+  auto monster = GetMonster(fbb.GetBufferPointer());
+  TEST_EQ_STR(monster->name()->c_str(), "a\xC3\xA9");
+  TEST_EQ(monster->color(), static_cast<Color>(Color_Red | Color_Blue));
+  TEST_EQ(monster->testf(), -150.0f);
+  TEST_EQ(monster->hp(), 16);
+
+  // Strings must be valid UTF-8, also when escaped, unless allowed otherwise.
+  TEST_EQ_STR(parse_error("{ name: \"\xC3\" }").c_str(),
+              "1: error: illegal UTF-8 sequence");
+  TEST_EQ_STR(parse_error("{ name: \"\\xC3\" }").c_str(),
+              "1: error: illegal UTF-8 sequence");
+  const char *latin1 = "{ name: \"a\\xE9\" }";
+  flatbuffers::JsonReader latin1_reader(latin1, strlen(latin1), false, true);
+  fbb.Clear();
+  TEST_EQ(ParseFromJson(latin1_reader, fbb, &offset), true);
+  FinishMonsterBuffer(fbb, offset);
+  monster = GetMonster(fbb.GetBufferPointer());
+  TEST_EQ_STR(monster->name()->c_str(), "a\xE9");
+
+  // Many copies of the test data, as a vector of tables.
+  const int num_monsters = 100;
+  std::string many = "{ name: \"root\", testarrayoftables: [";
+  for (int i = 0; i < num_monsters; i++) {
+    if (i) many += ",";
+    many += jsonfile;
+  }
+  many += "] }";
+  fbb.Clear();
+  TEST_EQ(ParseMonsterFromJson(many.c_str(), many.size(), fbb), true);
+  TEST_EQ(GetMonster(fbb.GetBufferPointer())->testarrayoftables()->size(),
+          static_cast<flatbuffers::uoffset_t>(num_monsters));
+}
+
 void ReflectionTest(uint8_t *flatbuf, size_t length) {
   // Load a binary schema.
   std::string bfbsfile;
@@ -634,6 +1134,130 @@ void ReflectionTest(uint8_t *flatbuf, size_t length) {
                               fbb.GetBufferPointer(), fbb.GetSize()), true);
 }
 
+// Parse schemas that include others with and without a shared
+// ParsedSchemaCache, which should make no difference to the result.
+void ParsedSchemaCacheTest() {
+  #ifndef FLATBUFFERS_CPP98_STL
+  const char *include_directories[] = {
+    "tests", "tests/namespace_test", nullptr
+  };
+  auto serialize = [&](const char *filename,
+                       flatbuffers::ParsedSchemaCache *cache,
+                       std::string *bfbs) {
+    std::string schemafile;
+    TEST_EQ(flatbuffers::LoadFile(filename, false, &schemafile), true);
+    flatbuffers::Parser parser(flatbuffers::IDLOptions(), cache);
+    TEST_EQ(parser.Parse(schemafile.c_str(), include_directories, filename),
+            true);
+    parser.Serialize();
+    bfbs->assign(reinterpret_cast<const char *>(
+                   parser.builder_.GetBufferPointer()),
+                 parser.builder_.GetSize());
+  };
+  const char *schemas[] = {
+    "tests/monster_test.fbs",
+    "tests/namespace_test/namespace_test2.fbs"
+  };
+  std::string expected[2];
+  for (int i = 0; i < 2; i++) serialize(schemas[i], nullptr, &expected[i]);
+
+  flatbuffers::ParsedSchemaCache cache;
+  for (int pass = 0; pass < 2; pass++) {
+    for (int i = 0; i < 2; i++) {
+      std::string bfbs;
+      serialize(schemas[i], &cache, &bfbs);
+      TEST_EQ(bfbs == expected[i], true);
+    }
+  }
+  // include_test1.fbs, include_test2.fbs and namespace_test1.fbs are each
+  // parsed once (include_test2.fbs by the cache's own parser for
+  // include_test1.fbs), then copied from the cache.
+  TEST_EQ(cache.size(), 3U);
+  TEST_EQ(cache.misses(), 3U);
+  TEST_EQ(cache.hits(), 2U);
+
+  // The parsed definitions work for JSON too.
+  std::string schemafile, jsonfile;
+  TEST_EQ(flatbuffers::LoadFile("tests/monster_test.fbs", false, &schemafile),
+          true);
+  TEST_EQ(flatbuffers::LoadFile("tests/monsterdata_test.golden", false,
+                                &jsonfile), true);
+  flatbuffers::Parser parser(flatbuffers::IDLOptions(), &cache);
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+  TEST_EQ(parser.Parse(jsonfile.c_str(), include_directories), true);
+  std::string jsongen;
+  TEST_EQ(GenerateText(parser, parser.builder_.GetBufferPointer(), &jsongen),
+          true);
+  TEST_EQ_STR(jsongen.c_str(), jsonfile.c_str());
+
+  // So do definitions imported from another Parser, of the files it parsed.
+  flatbuffers::Parser schema;
+  TEST_EQ(schema.Parse(schemafile.c_str(), include_directories,
+                       "tests/monster_test.fbs"), true);
+  flatbuffers::Parser imported;
+  TEST_EQ(imported.ImportDefinitions(schema), true);
+  TEST_EQ(imported.Parse(jsonfile.c_str(), include_directories), true);
+  std::string importedgen;
+  TEST_EQ(GenerateText(imported, imported.builder_.GetBufferPointer(),
+                       &importedgen), true);
+  TEST_EQ_STR(importedgen.c_str(), jsonfile.c_str());
+  TEST_EQ(imported.ImportDefinitions(schema), true);  // Nothing new.
+
+  // Cached files are parsed again when a file they include indirectly
+  // changes, even though they didn't change themselves.
+  const char *a_fbs = "tests/schema_cache_test_a.fbs";
+  const char *b_fbs = "tests/schema_cache_test_b.fbs";
+  const char *c_fbs = "tests/schema_cache_test_c.fbs";
+  TEST_EQ(flatbuffers::SaveFile(a_fbs, std::string(
+            "include \"schema_cache_test_b.fbs\"; table A { b:B; }"), false),
+          true);
+  TEST_EQ(flatbuffers::SaveFile(b_fbs, std::string(
+            "include \"schema_cache_test_c.fbs\"; table B { c:C; }"), false),
+          true);
+  for (int version = 0; version < 2; version++) {
+    TEST_EQ(flatbuffers::SaveFile(c_fbs, std::string(version
+              ? "table C { x:int; } table D {}" : "table C { x:int; }"),
+              false), true);
+    for (int pass = 0; pass < 2; pass++) {
+      flatbuffers::Parser changed(flatbuffers::IDLOptions(), &cache);
+      TEST_EQ(changed.Parse("include \"schema_cache_test_a.fbs\";",
+                            include_directories), true);
+      TEST_EQ(changed.structs_.Lookup("A") != nullptr, true);
+      TEST_EQ(changed.structs_.Lookup("D") != nullptr, version == 1);
+    }
+  }
+  remove(a_fbs);
+  remove(b_fbs);
+  remove(c_fbs);
+
+  // Errors in included files are reported as without a cache.
+  flatbuffers::Parser bad(flatbuffers::IDLOptions(), &cache);
+  TEST_EQ(bad.Parse("include \"monster_test.fbs\"; table Monster {}",
+                    include_directories), true);
+  TEST_EQ(bad.Parse("include \"include_test1.fbs\"; "
+                    "namespace MyGame.OtherNameSpace; table Unused {}",
+                    include_directories), false);
+
+  #if FLATBUFFERS_HAS_THREADS
+  // Parsers on multiple threads may share a cache.
+  flatbuffers::ParsedSchemaCache shared;
+  std::atomic<int> mismatches(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.push_back(std::thread([&, t]() {
+      for (int i = 0; i < 10; i++) {
+        std::string bfbs;
+        serialize(schemas[(t + i) % 2], &shared, &bfbs);
+        if (bfbs != expected[(t + i) % 2]) mismatches++;
+      }
+    }));
+  }
+  for (auto it = threads.begin(); it != threads.end(); ++it) it->join();
+  TEST_EQ(mismatches.load(), 0);
+  #endif  // FLATBUFFERS_HAS_THREADS
+  #endif  // FLATBUFFERS_CPP98_STL
+}
+
 // Parse a .proto schema, output as .fbs
 void ParseProtoTest() {
   // load the .proto and the golden file from disk
@@ -755,6 +1379,632 @@ void FuzzTest1() {
   }
 }
 
+// Allocator that counts calls, to check the builder goes through it.
+struct CountingAllocator : public flatbuffers::pooled_allocator {
+  CountingAllocator() : allocations(0), deallocations(0) {}
+  uint8_t *allocate(size_t size) const {
+    allocations++;
+    return pooled_allocator::allocate(size);
+  }
+  void deallocate(uint8_t *p) const {
+    deallocations++;
+    pooled_allocator::deallocate(p);
+  }
+  mutable int allocations;
+  mutable int deallocations;
+};
+
+void PooledAllocatorTest() {
+  CountingAllocator allocator;
+  std::string rawbuf;
+  {
+    // Grow well past the initial size, this should reallocate through the
+    // allocator, which returns the old blocks to the pool.
+    flatbuffers::FlatBufferBuilder builder(64, &allocator);
+    std::vector<uint32_t> data(1000, 0xDEADBEEF);
+    builder.Finish(builder.CreateVector(data));
+    TEST_EQ(allocator.allocations > 1, true);
+    TEST_EQ(allocator.deallocations, allocator.allocations - 1);
+    // Releasing the buffer must hand it back to our allocator when freed.
+    auto size = builder.GetSize();
+    auto buf = builder.ReleaseBufferPointer();
+    rawbuf.assign(reinterpret_cast<const char *>(buf.get()), size);
+  }
+  TEST_EQ(allocator.deallocations, allocator.allocations);
+  auto pooled_blocks = allocator.pooled_blocks();
+  TEST_EQ(pooled_blocks > 0, true);
+
+  // Building the same buffer again should be satisfied from the pool entirely.
+  auto reused = allocator.allocations;
+  flatbuffers::FlatBufferBuilder builder(64, &allocator);
+  for (int i = 0; i < 3; i++) {
+    builder.Clear();
+    std::vector<uint32_t> data(1000, 0xDEADBEEF);
+    builder.Finish(builder.CreateVector(data));
+    TEST_EQ(builder.GetSize(), rawbuf.size());
+    TEST_EQ(memcmp(builder.GetBufferPointer(), rawbuf.c_str(), rawbuf.size()),
+            0);
+  }
+  TEST_EQ(allocator.pooled_blocks() < pooled_blocks, true);
+  TEST_EQ(allocator.allocations - reused <= static_cast<int>(pooled_blocks),
+          true);
+
+  #ifdef FLATBUFFERS_THREAD_LOCAL
+  auto &tl_allocator = flatbuffers::pooled_allocator::thread_local_instance();
+  for (int i = 0; i < 2; i++) {
+    flatbuffers::FlatBufferBuilder tl_builder(1024, &tl_allocator);
+    tl_builder.Finish(tl_builder.CreateString("MyMonster"));
+    tl_builder.ReleaseBufferPointer();
+    TEST_EQ(tl_allocator.pooled_blocks(), 1);
+  }
+  #endif
+}
+
+void SizeHintTest(uint8_t *flatbuf) {
+  auto monster = UnPackMonster(flatbuf);
+  for (int i = 0; i < 100; i++) {
+    auto str = "string" + flatbuffers::NumToString(i);
+    monster->testarrayofstring.push_back(str);
+    monster->inventory.push_back(static_cast<uint8_t>(i));
+  }
+  monster->testarrayoftables.emplace_back(UnPackMonster(flatbuf));
+
+  // Packing reserves room for the whole buffer up front, so starting from a
+  // tiny buffer there should be only one reallocation.
+  CountingAllocator allocator;
+  flatbuffers::FlatBufferBuilder builder(64, &allocator);
+  FinishMonsterBuffer(builder, Monster::Pack(builder, monster.get()));
+  TEST_EQ(allocator.allocations, 2);
+  TEST_EQ(builder.GetSize() <= monster->SizeHint() + 32, true);
+
+  flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                 builder.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  TEST_EQ(GetMonster(builder.GetBufferPointer())->testarrayofstring()->size(),
+          monster->testarrayofstring.size());
+}
+
+void BatchedTablesTest() {
+  std::vector<StatT> stats(1000);
+  for (size_t i = 0; i < stats.size(); i++) {
+    stats[i].id = "stat" + flatbuffers::NumToString(i);
+    stats[i].val = static_cast<int64_t>(i) * 1000000007;
+    stats[i].count = static_cast<uint16_t>(i % 3);  // Some are default.
+  }
+
+  flatbuffers::FlatBufferBuilder builder;
+  builder.Finish(CreateVectorOfStat(builder, stats));
+
+  flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                 builder.GetSize());
+  auto vec = flatbuffers::GetRoot<flatbuffers::Vector<
+               flatbuffers::Offset<Stat>>>(builder.GetBufferPointer());
+  TEST_EQ(verifier.Verify(vec), true);
+  TEST_EQ(verifier.VerifyVectorOfTables(vec), true);
+  TEST_EQ(vec->size(), stats.size());
+
+  // All tables share the vtable of the first one.
+  auto vtable = [](const Stat *table) {
+    auto p = reinterpret_cast<const uint8_t *>(table);
+    return p - flatbuffers::ReadScalar<flatbuffers::soffset_t>(p);
+  };
+  for (flatbuffers::uoffset_t i = 0; i < vec->size(); i++) {
+    auto stat = vec->Get(i);
+    TEST_EQ(stat->id()->str(), stats[i].id);
+    TEST_EQ(stat->val(), stats[i].val);
+    TEST_EQ(stat->count(), stats[i].count);
+    TEST_EQ(vtable(stat) == vtable(vec->Get(0)), true);
+  }
+
+  // In segmented mode, each segment gets its own copy of the vtable.
+  flatbuffers::FlatBufferBuilder segmented(64);
+  segmented.SegmentedBuffer(true);
+  segmented.Finish(CreateVectorOfStat(segmented, stats));
+  auto segments = segmented.GetBufferSegments();
+  TEST_EQ(segments.size() > 1, true);
+  std::string flat;
+  for (auto it = segments.begin(); it != segments.end(); ++it) {
+    flat.append(reinterpret_cast<const char *>(it->data), it->size);
+  }
+  auto buf = reinterpret_cast<const uint8_t *>(flat.c_str());
+  flatbuffers::Verifier segmented_verifier(buf, flat.size());
+  vec = flatbuffers::GetRoot<flatbuffers::Vector<
+          flatbuffers::Offset<Stat>>>(buf);
+  TEST_EQ(segmented_verifier.VerifyVectorOfTables(vec), true);
+  TEST_EQ(vec->size(), stats.size());
+  // Which segment a position in the flattened buffer came from.
+  auto segment_of = [&](const uint8_t *p) {
+    size_t pos = static_cast<size_t>(p - buf);
+    size_t i = 0;
+    while (pos >= segments[i].size) pos -= segments[i++].size;
+    return i;
+  };
+  for (flatbuffers::uoffset_t i = 0; i < vec->size(); i++) {
+    auto stat = vec->Get(i);
+    TEST_EQ(stat->id()->str(), stats[i].id);
+    TEST_EQ(stat->val(), stats[i].val);
+    TEST_EQ(stat->count(), stats[i].count);
+    TEST_EQ(segment_of(vtable(stat)),
+            segment_of(reinterpret_cast<const uint8_t *>(stat)));
+  }
+}
+
+// Builds a table with the fields in `mask` present, each bitmask of fields
+// makes for a different vtable.
+flatbuffers::uoffset_t BuildMaskedTable(flatbuffers::FlatBufferBuilder &builder,
+                                        uint32_t mask,
+                                        flatbuffers::voffset_t num_fields) {
+  // Aligning first ensures the table size doesn't depend on padding.
+  builder.PreAlign<uint32_t>(0);
+  auto start = builder.StartTable();
+  for (flatbuffers::voffset_t f = 0; f < num_fields; f++) {
+    if (mask & (1 << f)) {
+      builder.AddElement<uint32_t>(flatbuffers::FieldIndexToOffset(f),
+                                   f + 1u, 0);
+    }
+  }
+  return builder.EndTable(start, num_fields);
+}
+
+// Builds an increasing amount of tables that all have a distinct vtable,
+// then the same tables again, which should all share the first set of vtables.
+void VTableDedupTest() {
+  const flatbuffers::voffset_t num_fields = 17;  // Enough for 100k layouts.
+  for (int num_vtables = 10; num_vtables <= 100000; num_vtables *= 10) {
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<flatbuffers::uoffset_t> objects;
+    for (int pass = 0; pass < 2; pass++) {
+      for (int i = 0; i < num_vtables; i++) {
+        objects.push_back(BuildMaskedTable(builder,
+                                           static_cast<uint32_t>(i + 1),
+                                           num_fields));
+      }
+    }
+    auto eob = builder.GetCurrentBufferPointer() + builder.GetSize();
+    for (int i = 0; i < num_vtables; i++) {
+      auto a = reinterpret_cast<flatbuffers::Table *>(eob - objects[i]);
+      auto b = reinterpret_cast<flatbuffers::Table *>(
+                 eob - objects[i + num_vtables]);
+      TEST_EQ(a->GetVTable(), b->GetVTable());
+      auto mask = static_cast<uint32_t>(i + 1);
+      for (flatbuffers::voffset_t f = 0; f < num_fields; f++) {
+        auto expected = (mask & (1 << f)) ? f + 1 : 0;
+        CompareTableFieldValue(b, flatbuffers::FieldIndexToOffset(f),
+                               static_cast<uint32_t>(expected));
+      }
+    }
+  }
+
+  // Vtables stay deduplicated as the buffer grows past the sizes at which the
+  // vtable index needs wider slots (64KB and 16MB). Each round adds a new
+  // layout at the current size, and reuses those of earlier rounds.
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::uoffset_t> first, again;
+  const size_t fillers[] = { 0, 1 << 16, 1 << 24 };
+  for (uint32_t i = 0; i < 3; i++) {
+    uint8_t *filler;
+    builder.CreateUninitializedVector(fillers[i], 1, &filler);
+    first.push_back(BuildMaskedTable(builder, i + 1, 2));
+    for (uint32_t mask = 1; mask <= i + 1; mask++) {
+      again.push_back(BuildMaskedTable(builder, mask, 2));
+    }
+  }
+  auto eob = builder.GetCurrentBufferPointer() + builder.GetSize();
+  for (size_t i = 0, j = 0; i < first.size(); i++) {
+    for (size_t mask = 1; mask <= i + 1; mask++, j++) {
+      auto a = reinterpret_cast<flatbuffers::Table *>(eob - first[mask - 1]);
+      auto b = reinterpret_cast<flatbuffers::Table *>(eob - again[j]);
+      TEST_EQ(a->GetVTable(), b->GetVTable());
+    }
+  }
+}
+
+// Checks the batched offset bounds check used by the verifier against every
+// position of an offending offset, then verifies a vector of strings both
+// batched and one string at a time.
+void VerifyVectorOfStringsTest() {
+  for (size_t count = 0; count < 20; count++) {
+    // A vector of offsets that all point to the last uoffset_t in buf.
+    std::vector<flatbuffers::uoffset_t> buf(count + 1);
+    auto offsets = reinterpret_cast<const uint8_t *>(buf.data());
+    auto end = offsets + buf.size() * sizeof(flatbuffers::uoffset_t);
+    for (size_t i = 0; i < count; i++) {
+      buf[i] = static_cast<flatbuffers::uoffset_t>((count - i) *
+                                                   sizeof(buf[0]));
+    }
+    TEST_EQ(flatbuffers::VerifyOffsetsInRange(offsets, count, end), true);
+    for (size_t i = 0; i < count; i++) {
+      buf[i]++;
+      TEST_EQ(flatbuffers::VerifyOffsetsInRange(offsets, count, end), false);
+      buf[i] = 0xFFFFFFFF;
+      TEST_EQ(flatbuffers::VerifyOffsetsInRange(offsets, count, end), false);
+      buf[i] = static_cast<flatbuffers::uoffset_t>((count - i) *
+                                                   sizeof(buf[0]));
+    }
+  }
+
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<std::string> strings;
+  for (int i = 0; i < 1000; i++) {
+    strings.push_back("string" + flatbuffers::NumToString(i));
+  }
+  auto name = builder.CreateString("MyMonster");
+  auto vec = builder.CreateVectorOfStrings(strings);
+  MonsterBuilder mb(builder);
+  mb.add_name(name);
+  mb.add_testarrayofstring(vec);
+  FinishMonsterBuffer(builder, mb.Finish());
+
+  auto strs = GetMonster(builder.GetBufferPointer())->testarrayofstring();
+  flatbuffers::Verifier batched(builder.GetBufferPointer(), builder.GetSize());
+  TEST_EQ(batched.VerifyVectorOfStrings(strs), true);
+  flatbuffers::Verifier individual(builder.GetBufferPointer(),
+                                   builder.GetSize());
+  for (flatbuffers::uoffset_t j = 0; j < strs->size(); j++) {
+    TEST_EQ(individual.Verify(strs->Get(j)), true);
+  }
+}
+
+// Verifies a buffer with a large vector of tables both serially and with a
+// parallel_for that uses a few threads.
+void ParallelVerifierTest() {
+  #if FLATBUFFERS_HAS_THREADS
+  const int num_monsters = 20000;
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < num_monsters; i++) {
+    auto name = builder.CreateString("monster" + flatbuffers::NumToString(i));
+    auto inventory = builder.CreateVector(std::vector<uint8_t>(8, 1));
+    monsters.push_back(CreateMonster(builder, nullptr, 0, 0, name, inventory));
+  }
+  auto tables = builder.CreateVector(monsters);
+  auto name = builder.CreateString("root");
+  MonsterBuilder mb(builder);
+  mb.add_name(name);
+  mb.add_testarrayoftables(tables);
+  FinishMonsterBuffer(builder, mb.Finish());
+
+  flatbuffers::parallel_for_function_t parallel_for =
+      [](size_t count, const std::function<void (size_t)> &task) {
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+      threads.push_back(std::thread([&]() {
+        for (size_t i; (i = next++) < count; ) task(i);
+      }));
+    }
+    for (auto it = threads.begin(); it != threads.end(); ++it) it->join();
+  };
+
+  // Exactly enough tables allowed: the root and all monsters.
+  const size_t max_tables = num_monsters + 1;
+  flatbuffers::Verifier serial(builder.GetBufferPointer(), builder.GetSize(),
+                               64, max_tables);
+  TEST_EQ(VerifyMonsterBuffer(serial), true);
+  flatbuffers::Verifier parallel(builder.GetBufferPointer(),
+                                 builder.GetSize(), 64, max_tables);
+  TEST_EQ(parallel.VerifyBuffer<Monster>(MonsterIdentifier(), parallel_for,
+                                         1000), true);
+  #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
+    TEST_EQ(parallel.GetComputedSize(), serial.GetComputedSize());
+  #endif
+  #endif
+}
+
+// Looks up every key, and keys in between, in a large sorted vector of tables.
+void LookupByKeyTest() {
+  const int num_monsters = 10000;
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  std::vector<std::string> names;
+  for (int i = 0; i < num_monsters; i++) {
+    // Zero-padded so names sort the same way as the numbers, and every
+    // other number is missing.
+    auto num = flatbuffers::NumToString(i * 2 + 1000000);
+    names.push_back("monster" + num);
+    monsters.push_back(CreateMonster(builder, nullptr, 0, 0,
+                                     builder.CreateString(names.back())));
+  }
+  auto tables = builder.CreateVectorOfSortedTables(&monsters);
+  auto name = builder.CreateString("root");
+  MonsterBuilder mb(builder);
+  mb.add_name(name);
+  mb.add_testarrayoftables(tables);
+  FinishMonsterBuffer(builder, mb.Finish());
+  auto root = GetMonster(builder.GetBufferPointer());
+  auto vec = root->testarrayoftables();
+
+  for (int i = 0; i < num_monsters; i++) {
+    auto m = vec->LookupByKey(names[i].c_str());
+    TEST_NOTNULL(m);
+    TEST_EQ_STR(m->name()->c_str(), names[i].c_str());
+  }
+  for (int i = 0; i <= num_monsters; i++) {
+    auto num = flatbuffers::NumToString(i * 2 + 999999);
+    TEST_EQ(vec->LookupByKey(("monster" + num).c_str()) == nullptr, true);
+  }
+  TEST_EQ(vec->LookupByKey("") == nullptr, true);
+  TEST_EQ(vec->LookupByKey("z") == nullptr, true);
+
+  // Batched lookups in one pass, of keys in between existing ones and of
+  // every other existing key, and past the end.
+  std::vector<std::string> batch_names;
+  std::vector<const char *> batch;
+  for (int i = 0; i < num_monsters; i++) {
+    batch_names.push_back("monster" +
+                          flatbuffers::NumToString(i * 4 + 1000001));
+    batch_names.push_back("monster" +
+                          flatbuffers::NumToString(i * 4 + 1000002));
+  }
+  for (size_t i = 0; i < batch_names.size(); i++) {
+    batch.push_back(batch_names[i].c_str());
+  }
+  auto results = vec->LookupByKeys(batch);
+  TEST_EQ(results.size(), batch.size());
+  for (size_t i = 0; i < batch.size(); i++) {
+    if (i % 2 && i / 2 < static_cast<size_t>(num_monsters / 2)) {
+      TEST_NOTNULL(results[i]);
+      TEST_EQ_STR(results[i]->name()->c_str(), batch[i]);
+    } else {
+      TEST_EQ(results[i] == nullptr, true);
+    }
+  }
+
+  // Range queries, on a vector with duplicate keys.
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<Monster>> few;
+  const char *few_names[] = { "d", "b", "b", "f", "b", "a" };
+  for (size_t i = 0; i < sizeof(few_names) / sizeof(few_names[0]); i++) {
+    few.push_back(CreateMonster(fbb, nullptr, 0, 0,
+                                fbb.CreateString(few_names[i])));
+  }
+  auto few_tables = fbb.CreateVectorOfSortedTables(&few);
+  FinishMonsterBuffer(fbb, CreateMonster(fbb, nullptr, 0, 0,
+      fbb.CreateString("root"), 0, Color_Blue, Any_NONE, 0, 0, 0,
+      few_tables));
+  root = GetMonster(fbb.GetBufferPointer());
+  vec = root->testarrayoftables();
+  auto range = vec->EqualRange("b");
+  TEST_EQ(range.first - vec->begin(), 1);
+  TEST_EQ(range.second - vec->begin(), 4);
+  for (auto it = range.first; it != range.second; ++it) {
+    TEST_EQ_STR(it->name()->c_str(), "b");
+  }
+  TEST_EQ(vec->LowerBound("c") - vec->begin(), 4);
+  TEST_EQ(vec->UpperBound("c") - vec->begin(), 4);
+  TEST_EQ(vec->LowerBound("") == vec->begin(), true);
+  TEST_EQ(vec->UpperBound("f") == vec->end(), true);
+  range = vec->EqualRange("e");
+  TEST_EQ(range.first == range.second, true);
+  const char *few_keys[] = { "", "a", "b", "b", "c", "f", "g" };
+  const Monster *few_results[7];
+  vec->LookupByKeys(few_keys, 7, few_results);
+  TEST_EQ(few_results[0] == nullptr, true);
+  TEST_EQ_STR(few_results[1]->name()->c_str(), "a");
+  TEST_EQ_STR(few_results[2]->name()->c_str(), "b");
+  TEST_EQ(few_results[3], few_results[2]);
+  TEST_EQ(few_results[4] == nullptr, true);
+  TEST_EQ_STR(few_results[5]->name()->c_str(), "f");
+  TEST_EQ(few_results[6] == nullptr, true);
+}
+
+// Looks up every key, and keys in between, through the hash index of a
+// vector of tables (see the hash_index attribute in hash_index_test.fbs).
+void KeyHashIndexTest() {
+  using namespace HashIndexTest;
+  const int num_items = 10000;
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Item>> items;
+  std::vector<std::string> names;
+  for (int i = 0; i < num_items; i++) {
+    auto num = flatbuffers::NumToString(i * 2 + 1000000);
+    names.push_back("item" + num);
+    items.push_back(CreateItem(builder, builder.CreateString(names.back()),
+                               i));
+  }
+  auto vec = builder.CreateVectorOfSortedTables(&items);
+  auto index = builder.CreateKeyHashIndex(items);
+  FinishInventoryBuffer(builder, CreateInventory(builder, vec, index));
+  flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                 builder.GetSize());
+  TEST_EQ(VerifyInventoryBuffer(verifier), true);
+  auto root = GetInventory(builder.GetBufferPointer());
+
+  for (int i = 0; i < num_items; i++) {
+    auto item = root->items_by_key(names[i].c_str());
+    TEST_NOTNULL(item);
+    TEST_EQ_STR(item->name()->c_str(), names[i].c_str());
+  }
+  for (int i = 0; i <= num_items; i++) {
+    auto num = flatbuffers::NumToString(i * 2 + 999999);
+    TEST_EQ(root->items_by_key(("item" + num).c_str()) == nullptr, true);
+  }
+  TEST_EQ(root->items_by_key("") == nullptr, true);
+
+  // Without an index, lookups fall back to binary search.
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<Item>> few;
+  few.push_back(CreateItem(fbb, fbb.CreateString("b")));
+  few.push_back(CreateItem(fbb, fbb.CreateString("a")));
+  FinishInventoryBuffer(fbb, CreateInventory(fbb,
+                        fbb.CreateVectorOfSortedTables(&few)));
+  root = GetInventory(fbb.GetBufferPointer());
+  TEST_EQ_STR(root->items_by_key("a")->name()->c_str(), "a");
+  TEST_EQ(root->items_by_key("c") == nullptr, true);
+
+  // Float keys that compare equal hash the same.
+  using flatbuffers::HashKey;
+  TEST_EQ(HashKey(-0.0), HashKey(0.0));
+  TEST_EQ(HashKey(-0.0f), HashKey(0.0f));
+  TEST_EQ(HashKey(1.0) != HashKey(-1.0), true);
+  double nan1 = std::numeric_limits<double>::quiet_NaN(), nan2 = -nan1;
+  TEST_EQ(HashKey(nan1), HashKey(nan2));
+  TEST_EQ(HashKey(std::numeric_limits<float>::signaling_NaN()),
+          HashKey(std::numeric_limits<float>::quiet_NaN()));
+}
+
+void SymbolTableTest() {
+  flatbuffers::SymbolTable<flatbuffers::Value> table;
+  const int num_symbols = 1000;
+  for (int i = 0; i < num_symbols; i++) {
+    auto val = new flatbuffers::Value();
+    val->constant = flatbuffers::NumToString(i);
+    TEST_EQ(table.Add("symbol" + val->constant, val), false);
+  }
+  // Duplicates are kept for iteration, but don't replace the first one.
+  auto dup = new flatbuffers::Value();
+  TEST_EQ(table.Add("symbol7", dup), true);
+  TEST_EQ(table.vec.size(), static_cast<size_t>(num_symbols + 1));
+  TEST_EQ(table.symbols().size(), static_cast<size_t>(num_symbols));
+  TEST_EQ_STR(table.symbols()[3].first.c_str(), "symbol3");
+
+  for (int i = 0; i < num_symbols; i++) {
+    auto name = "symbol" + flatbuffers::NumToString(i);
+    auto val = table.Lookup(name);
+    TEST_NOTNULL(val);
+    TEST_EQ_STR(val->constant.c_str(), flatbuffers::NumToString(i).c_str());
+  }
+  // Lookup by pointer and length, without a terminator.
+  const char *text = "symbol42,symbol";
+  TEST_EQ_STR(table.Lookup(text, 8)->constant.c_str(), "42");
+  TEST_EQ(table.Lookup(text, 6) == nullptr, true);
+  TEST_EQ_STR(table.Lookup("symbol7")->constant.c_str(), "7");
+  TEST_EQ(table.Lookup("") == nullptr, true);
+
+  table.Move("symbol5", "renamed");
+  TEST_EQ(table.Lookup("symbol5") == nullptr, true);
+  TEST_EQ_STR(table.Lookup("renamed")->constant.c_str(), "5");
+  TEST_EQ_STR(table.symbols()[5].first.c_str(), "renamed");
+}
+
+// Reads a buffer through the accessors generated by --gen-checked-accessors,
+// both intact and truncated or corrupted, without verifying it first.
+void CheckedAccessorsTest(const std::string &rawbuf) {
+  auto flatbuf = reinterpret_cast<const uint8_t *>(rawbuf.c_str());
+  flatbuffers::AccessChecker checker(flatbuf, rawbuf.length());
+  auto monster = GetMonster(checker);
+  TEST_NOTNULL(monster);
+  TEST_EQ(monster->hp(checker), 80);
+  TEST_EQ(monster->mana(checker), 150);  // default
+  TEST_EQ_STR(monster->name(checker)->c_str(), "MyMonster");
+  TEST_EQ(monster->pos(checker)->z(), 3);
+  TEST_EQ(monster->inventory(checker)->Get(9), 9);
+  TEST_EQ(monster->color(checker), Color_Blue);
+  TEST_EQ(monster->test_type(checker), Any_Monster);
+  auto monster2 = reinterpret_cast<const Monster *>(monster->test(checker));
+  TEST_EQ_STR(monster2->name(checker)->c_str(), "Fred");
+  auto vecofstrings = monster->testarrayofstring(checker);
+  TEST_EQ_STR(checker.Checked(vecofstrings->Get(1))->c_str(), "fred");
+  TEST_EQ(monster->enemy(checker) == nullptr, true);  // not set
+  TEST_EQ(checker.ok(), true);
+
+  // Cut the buffer off in the middle of the name: fields before it can still
+  // be read, the name itself and anything after it can not.
+  auto name_end = reinterpret_cast<const uint8_t *>(monster->name()->c_str());
+  flatbuffers::AccessChecker truncated(flatbuf, name_end - flatbuf + 2);
+  monster = GetMonster(truncated);
+  TEST_NOTNULL(monster);
+  TEST_EQ(monster->hp(truncated), 80);
+  TEST_EQ(monster->name(truncated) == nullptr, true);
+  TEST_EQ(truncated.ok(), false);
+  TEST_EQ(monster->hp(truncated), 100);  // Failures are sticky.
+
+  // Point the root offset past the end of the buffer.
+  std::string corrupt = rawbuf;
+  flatbuffers::WriteScalar(&corrupt[0],
+      static_cast<flatbuffers::uoffset_t>(corrupt.length()));
+  flatbuffers::AccessChecker corrupted(
+      reinterpret_cast<const uint8_t *>(corrupt.c_str()), corrupt.length());
+  TEST_EQ(GetMonster(corrupted) == nullptr, true);
+  TEST_EQ(corrupted.ok(), false);
+}
+
+// Verifies the same buffers repeatedly through a VerifiedBufferCache.
+void VerifiedBufferCacheTest(const std::string &rawbuf) {
+  #ifndef FLATBUFFERS_CPP98_STL
+  auto flatbuf = reinterpret_cast<const uint8_t *>(rawbuf.c_str());
+  flatbuffers::VerifiedBufferCache cache(2);
+  TEST_EQ(cache.VerifyBuffer<Monster>(flatbuf, rawbuf.length(),
+                                      MonsterIdentifier()), true);
+  TEST_EQ(cache.VerifyBuffer<Monster>(flatbuf, rawbuf.length(),
+                                      MonsterIdentifier()), true);
+  TEST_EQ(cache.hits(), 1U);
+  TEST_EQ(cache.misses(), 1U);
+
+  // A different identifier, or different contents at the same address, are
+  // not found in the cache.
+  TEST_EQ(cache.VerifyBuffer<Monster>(flatbuf, rawbuf.length()), true);
+  std::string copy = rawbuf;
+  auto copybuf = reinterpret_cast<uint8_t *>(&copy[0]);
+  TEST_EQ(cache.VerifyBuffer<Monster>(copybuf, copy.length()), true);
+  TEST_EQ(cache.size(), 2U);  // The first buffer was evicted.
+  GetMutableMonster(copybuf)->mutate_hp(81);
+  TEST_EQ(cache.VerifyBuffer<Monster>(copybuf, copy.length()), true);
+  TEST_EQ(cache.hits(), 1U);
+  TEST_EQ(cache.misses(), 4U);
+
+  // Failed verifications are never cached (this one fails on the
+  // identifier, before the Verifier gets to check anything else).
+  TEST_EQ(cache.VerifyBuffer<Monster>(copybuf, copy.length(), "XXXX"), false);
+  TEST_EQ(cache.VerifyBuffer<Monster>(copybuf, copy.length(), "XXXX"), false);
+  TEST_EQ(cache.misses(), 6U);
+
+  // Different contents at the same address are verified again, even if they
+  // hash the same. HashBuffer64 isn't keyed, so such buffers are easy to
+  // make: change the file identifier, then pick the next 8 bytes to bring the
+  // hash state back to what it was for the valid buffer.
+  typedef flatbuffers::FnvTraits<uint64_t> Fnv;
+  auto step = [](uint64_t h, uint64_t word) {
+    h = (h ^ word) * Fnv::kFnvPrime;
+    return h ^ (h >> 32);
+  };
+  uint64_t inverse_prime = Fnv::kFnvPrime;  // Newton's method, mod 2^64.
+  for (int i = 0; i < 6; i++) {
+    inverse_prime *= 2 - Fnv::kFnvPrime * inverse_prime;
+  }
+  uint64_t words[2];
+  memcpy(words, copybuf, sizeof(words));
+  auto state = Fnv::kOffsetBasis ^ copy.length();
+  auto target = step(step(state, words[0]), words[1]);
+  // The identifier follows the root offset.
+  reinterpret_cast<uint8_t *>(words)[sizeof(flatbuffers::uoffset_t)] ^= 1;
+  words[1] = ((target ^ (target >> 32)) * inverse_prime) ^
+             step(state, words[0]);
+  TEST_EQ(cache.VerifyBuffer<Monster>(copybuf, copy.length(),
+                                      MonsterIdentifier()), true);
+  auto hash = flatbuffers::HashBuffer64(copybuf, copy.length());
+  memcpy(copybuf, words, sizeof(words));
+  TEST_EQ(flatbuffers::HashBuffer64(copybuf, copy.length()), hash);
+  TEST_EQ(cache.VerifyBuffer<Monster>(copybuf, copy.length(),
+                                      MonsterIdentifier()), false);
+  TEST_EQ(cache.misses(), 8U);
+
+  // The byte budget evicts the least recently used copies too, and buffers
+  // that don't fit in it at all are not cached.
+  auto len = rawbuf.length();
+  flatbuffers::VerifiedBufferCache small(100, 2 * len);
+  std::string copies[3] = { rawbuf, rawbuf, rawbuf };
+  for (int i = 0; i < 3; i++) {
+    TEST_EQ(small.VerifyBuffer<Monster>(
+                reinterpret_cast<const uint8_t *>(copies[i].c_str()), len),
+            true);
+  }
+  TEST_EQ(small.size(), 2U);
+  TEST_EQ(small.bytes(), 2 * len);
+  TEST_EQ(small.VerifyBuffer<Monster>(
+              reinterpret_cast<const uint8_t *>(copies[0].c_str()), len),
+          true);
+  TEST_EQ(small.hits(), 0U);  // It was evicted.
+  flatbuffers::VerifiedBufferCache tiny(100, len - 1);
+  TEST_EQ(tiny.VerifyBuffer<Monster>(flatbuf, len), true);
+  TEST_EQ(tiny.VerifyBuffer<Monster>(flatbuf, len), true);
+  TEST_EQ(tiny.size(), 0U);
+  TEST_EQ(tiny.misses(), 2U);
+  #else
+  (void)rawbuf;
+  #endif
+}
+
 // High level stress/fuzz test: generate a big schema and
 // matching json data in random combinations, then parse both,
 // generate json back from the binary, and compare with the original.
@@ -1023,6 +2273,65 @@ void ValueTest() {
                               12335089644688340133ULL);
 }
 
+// The number conversions in util.h, also from several threads at once.
+void NumberConversionTest() {
+  using flatbuffers::NumToString;
+  TEST_EQ_STR(NumToString(0.1).c_str(), "0.1");
+  TEST_EQ_STR(NumToString(3.14159f).c_str(), "3.14159");
+  TEST_EQ_STR(NumToString(-1.5e-7).c_str(), "-0.00000015");
+  TEST_EQ_STR(NumToString(1e21).c_str(), "1000000000000000000000");
+  TEST_EQ_STR(NumToString(2.0).c_str(), "2");
+  TEST_EQ_STR(NumToString(-0.0).c_str(), "-0");
+  TEST_EQ_STR(NumToString(static_cast<int8_t>(-128)).c_str(), "-128");
+  TEST_EQ_STR(NumToString(0xFFFFFFFFFFFFFFFFULL).c_str(),
+              "18446744073709551615");
+  TEST_EQ_STR(flatbuffers::IntToStringHex(0x23, 8).c_str(), "00000023");
+  TEST_EQ(flatbuffers::StringToDouble("-12.5e+3"), -12500.0);
+  TEST_EQ(flatbuffers::StringToFloat("0.1"), 0.1f);
+  char *end;
+  TEST_EQ(flatbuffers::StringToDouble("1.5x", &end), 1.5);
+  TEST_EQ(*end, 'x');
+
+  // Any double or float must read back as the same value.
+  lcg_reset();
+  for (int i = 0; i < 100000; i++) {
+    auto bits = (static_cast<uint64_t>(lcg_rand()) << 32) | lcg_rand();
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    if (d == d) {
+      TEST_EQ(flatbuffers::StringToDouble(NumToString(d).c_str()), d);
+    }
+    auto fbits = lcg_rand();
+    float f;
+    memcpy(&f, &fbits, sizeof(f));
+    if (f == f) {
+      TEST_EQ(flatbuffers::StringToFloat(NumToString(f).c_str()), f);
+    }
+  }
+
+  #if FLATBUFFERS_HAS_THREADS
+  // Each thread gets the same results as a single thread does.
+  const int iterations = 10000;
+  auto convert = [&]() {
+    char buf[flatbuffers::kMaxNumToCharsLength + 1];
+    double sum = 0;
+    for (int i = 0; i < iterations; i++) {
+      *flatbuffers::NumToChars(i * 0.37, buf) = 0;
+      sum += flatbuffers::StringToDouble(buf);
+    }
+    return sum;
+  };
+  const double expected = convert();
+  std::vector<double> sums(4);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < sums.size(); t++) {
+    threads.push_back(std::thread([&, t]() { sums[t] = convert(); }));
+  }
+  for (auto it = threads.begin(); it != threads.end(); ++it) it->join();
+  for (size_t t = 0; t < sums.size(); t++) TEST_EQ(sums[t], expected);
+  #endif
+}
+
 void EnumStringsTest() {
   flatbuffers::Parser parser1;
   TEST_EQ(parser1.Parse("enum E:byte { A, B, C } table T { F:[E]; }"
@@ -1080,6 +2389,44 @@ void UnicodeTest() {
             "\\u5225\\u30B5\\u30A4\\u30C8\\u20AC\\u0080\\uD83D\\uDE0E\"}"));
 }
 
+// Long strings and whitespace runs are scanned many bytes at a time by the
+// lexer, make sure escapes, errors and line numbers in them are handled.
+void LexerTest() {
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse("table T { F:string; G:[string]; }"
+                       "root_type T;"
+                       "{\n"
+                       "                        F:"
+                       "\"abcdefghijklmnopqrstuvwxyz\\n0123456789"
+                       "abcdefghijklmnopqrstuvwxyz\\\"quoted\\\"\xC2\xA2\",\n"
+                       "\n"
+                       "                        G: [ 'single \"quoted\"'"
+                       ", \"abcdefghijklmnopqrstuvwxyz\" ]\n"
+                       "}\n"),
+          true);
+  auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+                parser.builder_.GetBufferPointer());
+  auto f = root->GetPointer<const flatbuffers::String *>(4);
+  TEST_EQ_STR(f->c_str(), "abcdefghijklmnopqrstuvwxyz\n0123456789"
+                          "abcdefghijklmnopqrstuvwxyz\"quoted\"\xC2\xA2");
+  auto g = root->GetPointer<const flatbuffers::Vector<
+             flatbuffers::Offset<flatbuffers::String>> *>(6);
+  TEST_EQ_STR(g->Get(0)->c_str(), "single \"quoted\"");
+  TEST_EQ_STR(g->Get(1)->c_str(), "abcdefghijklmnopqrstuvwxyz");
+
+  TestError("table T { F:string; } root_type T;\n"
+            "{\n"
+            "                                F:\n"
+            "\n"
+            "                                @ }", "5:0: error: illegal");
+  TestError("table T { F:string; } root_type T;"
+            "{ F: \"abcdefghijklmnopqrstuvwxyz\x01\" }",
+            "illegal character in string");
+  TestError("table T { F:string; } root_type T;"
+            "{ F: \"abcdefghijklmnopqrstuvwxyz\xFF\" }",
+            "illegal UTF-8");
+}
+
 void UnicodeTestAllowNonUTF8() {
   flatbuffers::Parser parser;
   parser.opts.allow_non_utf8 = true;
@@ -1434,9 +2781,17 @@ int main(int /*argc*/, const char * /*argv*/[]) {
   ObjectFlatBuffersTest(flatbuf.get());
 
   SizePrefixedTest();
+  SegmentedBufferTest();
+  SharedStringTest();
 
   #ifndef FLATBUFFERS_NO_FILE_TESTS
   ParseAndGenerateTextTest();
+  MappedFileTest();
+  StreamTest();
+  ParseJsonVectorOfTablesTest();
+  TextGeneratorTest();
+  GeneratedJsonParserTest();
+  ParsedSchemaCacheTest();
   ReflectionTest(flatbuf.get(), rawbuf.length());
   ParseProtoTest();
   UnionVectorTest();
@@ -1444,12 +2799,25 @@ int main(int /*argc*/, const char * /*argv*/[]) {
 
   FuzzTest1();
   FuzzTest2();
+  VTableDedupTest();
+  VerifyVectorOfStringsTest();
+  ParallelVerifierTest();
+  LookupByKeyTest();
+  KeyHashIndexTest();
+  SymbolTableTest();
+  CheckedAccessorsTest(rawbuf);
+  VerifiedBufferCacheTest(rawbuf);
+  PooledAllocatorTest();
+  SizeHintTest(flatbuf.get());
+  BatchedTablesTest();
 
   ErrorTest();
   ValueTest();
+  NumberConversionTest();
   EnumStringsTest();
   IntegerOutOfRangeTest();
   UnicodeTest();
+  LexerTest();
   UnicodeTestAllowNonUTF8();
   UnicodeTestGenerateTextFailsOnNonUTF8();
   UnicodeSurrogatesTest();